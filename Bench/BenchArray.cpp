@@ -0,0 +1,76 @@
+//
+// Array<T> growth against std::vector: push_back from empty, with and without
+// reserve, for a scalar, a trivially copyable struct and std::string, plus
+// Array on a FrameArena.
+//
+
+#include <Shared/Array.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct Particle {
+    float x, y, vx, vy;
+    int id;
+};
+
+template <typename T> static T make(int i);
+template <> int make<int>(int i) { return i; }
+template <> Particle make<Particle>(int i) { return {float(i), 0, 1, 1, i}; }
+template <> std::string make<std::string>(int i) { return std::string(24, char('a' + i % 26)); }
+
+// Best of rounds, in ns per element
+template <typename Fill>
+static double timeFill(int count, int rounds, Fill fill) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fill(count);
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / count);
+    }
+    return best;
+}
+
+template <typename T, typename Container>
+static void fill(Container& container, int count, bool reserve) {
+    if (reserve) container.reserve(count);
+    for (int i = 0; i < count; ++i) container.push_back(make<T>(i));
+}
+
+template <typename T>
+static void compare(const char* name, int count, int rounds) {
+    for (bool reserve : {false, true}) {
+        const double vector = timeFill(count, rounds, [reserve](int n) {
+            std::vector<T> v;
+            fill<T>(v, n, reserve);
+        });
+        const double array = timeFill(count, rounds, [reserve](int n) {
+            Array<T> a;
+            fill<T>(a, n, reserve);
+        });
+        std::printf("%-12s %-8s %12.2f %12.2f\n", name, reserve ? "reserve" : "grow", vector, array);
+    }
+}
+
+int main() {
+    const int count = 1 << 20;
+    const int rounds = 10;
+    std::printf("%d elements, ns/element\n", count);
+    std::printf("%-12s %-8s %12s %12s\n", "type", "mode", "std::vector", "Array");
+    compare<int>("int", count, rounds);
+    compare<Particle>("Particle", count, rounds);
+    compare<std::string>("std::string", count / 4, rounds);
+
+    // Arena-backed: growth leaves old buffers behind until reset
+    RK::FrameArena arena(1 << 20);
+    const double onArena = timeFill(count, rounds, [&arena](int n) {
+        Array<Particle, RK::ArenaAllocator> a(RK::ArenaAllocator{&arena});
+        fill<Particle>(a, n, false);
+        arena.reset();
+    });
+    std::printf("%-12s %-8s %12s %12.2f\n", "Particle", "arena", "-", onArena);
+    return 0;
+}
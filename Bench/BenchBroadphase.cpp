@@ -0,0 +1,121 @@
+//
+// Broadphase scaling benchmark: world step time from 1k to 100k bodies at a
+// constant body density, on uniform, clustered and mostly static layouts.
+// Brute force is only run while it finishes in reasonable time.
+//
+
+#include <Physics/Broadphase.h>
+#include <Physics/Circle.h>
+#include <Physics/Rectangle.h>
+#include <Physics/PhysicsWorld.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+enum class Layout { Uniform, Clustered, MostlyStatic };
+
+static void populate(PhysicsWorld& world, Layout layout, size_t count, unsigned seed) {
+    // About 400 units^2 per body keeps the density constant as count grows
+    const float side = std::sqrt(static_cast<float>(count) * 400.0f);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> uniform(0.0f, side);
+    std::uniform_real_distribution<float> radius(2.0f, 4.0f);
+    std::uniform_real_distribution<float> vel(-20.0f, 20.0f);
+
+    if (layout == Layout::MostlyStatic) {
+        // Level geometry: 80% static boxes, the rest circles moving through it
+        for (size_t i = 0; i < count; ++i) {
+            Vector2D pos(uniform(rng), uniform(rng));
+            if (i % 5 != 0) {
+                auto box = std::make_unique<Rectangle>(pos, 6, 6, 1.0f);
+                box->isStatic = true;
+                world.addBody(std::move(box));
+            } else {
+                auto circle = std::make_unique<Circle>(pos, radius(rng), 1.0f);
+                circle->velocity = Vector2D(vel(rng), vel(rng));
+                world.addBody(std::move(circle));
+            }
+        }
+        return;
+    }
+
+    if (layout == Layout::Uniform) {
+        for (size_t i = 0; i < count; ++i) {
+            auto circle = std::make_unique<Circle>(Vector2D(uniform(rng), uniform(rng)), radius(rng), 1.0f);
+            circle->velocity = Vector2D(vel(rng), vel(rng));
+            world.addBody(std::move(circle));
+        }
+        return;
+    }
+
+    // Clustered: small circles around a few centres, plus long static ground
+    // strips like the 800x50 ground in Run/main.cpp
+    const size_t clusters = 16;
+    const size_t grounds = count / 200 + 1;
+    std::vector<Vector2D> centres;
+    for (size_t c = 0; c < clusters; ++c) centres.emplace_back(uniform(rng), uniform(rng));
+    std::normal_distribution<float> spread(0.0f, side / 24.0f);
+    for (size_t i = 0; i < count - grounds; ++i) {
+        const Vector2D& c = centres[i % clusters];
+        auto circle = std::make_unique<Circle>(Vector2D(c.x + spread(rng), c.y + spread(rng)), radius(rng), 1.0f);
+        circle->velocity = Vector2D(vel(rng), vel(rng));
+        world.addBody(std::move(circle));
+    }
+    for (size_t i = 0; i < grounds; ++i) {
+        auto ground = std::make_unique<Rectangle>(Vector2D(uniform(rng), uniform(rng)), 800, 50, 1.0f);
+        ground->isStatic = true;
+        world.addBody(std::move(ground));
+    }
+}
+
+static double msPerStep(const std::function<std::unique_ptr<Broadphase>()>& make, Layout layout, size_t count) {
+    PhysicsWorld world(Vector2D(0, 0));
+    world.setBroadphase(make());
+    populate(world, layout, count, 42);
+
+    const float dt = 1.0f / 60.0f;
+    world.update(dt); // warm up scratch buffers
+
+    const int steps = 10;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) world.update(dt);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / steps;
+}
+
+int main() {
+    const size_t counts[] = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+    const size_t bruteForceLimit = 10000;
+
+    struct Candidate {
+        const char* name;
+        std::function<std::unique_ptr<Broadphase>()> make;
+        size_t limit;
+    };
+    const Candidate candidates[] = {
+        {"grid", [] { return std::make_unique<UniformGridBroadphase>(16.0f); }, SIZE_MAX},
+        {"sap", [] { return std::make_unique<SweepAndPruneBroadphase>(); }, SIZE_MAX},
+        {"tree", [] { return std::make_unique<DynamicTreeBroadphase>(); }, SIZE_MAX},
+        {"brute", [] { return std::make_unique<BruteForceBroadphase>(); }, bruteForceLimit},
+    };
+
+    const std::pair<Layout, const char*> layouts[] = {
+        {Layout::Uniform, "uniform"},
+        {Layout::Clustered, "clustered"},
+        {Layout::MostlyStatic, "static"},
+    };
+
+    std::printf("%-10s %-10s %-12s %12s %16s\n", "layout", "bodies", "broadphase", "ms/step", "ns/body/step");
+    for (const auto& [layout, layoutName] : layouts) {
+        for (size_t count : counts) {
+            for (const Candidate& candidate : candidates) {
+                if (count > candidate.limit) continue;
+                double ms = msPerStep(candidate.make, layout, count);
+                std::printf("%-10s %-10zu %-12s %12.3f %16.1f\n", layoutName, count, candidate.name, ms, ms * 1e6 / count);
+            }
+        }
+    }
+    return 0;
+}
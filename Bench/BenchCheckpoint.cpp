@@ -0,0 +1,90 @@
+//
+// Checkpoint and restore of 1M bodies: the binary mmap checkpoint against a
+// text dump in the style of draw() and parsing it back.
+//
+
+#include "Scenarios.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static long fileBytes(const char* path) {
+    struct stat info;
+    return stat(path, &info) == 0 ? static_cast<long>(info.st_size) : -1;
+}
+
+// One line per body with every column the checkpoint carries
+static void writeText(const PhysicsWorld& world, const char* path) {
+    const BodyStorage& s = world.getStorage();
+    std::ofstream out(path);
+    for (uint32_t i = 0; i < s.size(); ++i) {
+        out << (s.shape[i] == ShapeType::Circle ? "Circle" : "Rectangle") << ' '
+            << s.posX[i] << ' ' << s.posY[i] << ' ' << s.velX[i] << ' ' << s.velY[i] << ' '
+            << s.extentX[i] << ' ' << s.extentY[i] << ' ' << s.invMass[i] << ' '
+            << s.restitution[i] << ' ' << int(s.flags[i]) << '\n';
+    }
+}
+
+static void readText(PhysicsWorld& world, const char* path) {
+    std::ifstream in(path);
+    std::string shape;
+    float px, py, vx, vy, ex, ey, invMass, restitution;
+    int flags;
+    while (in >> shape >> px >> py >> vx >> vy >> ex >> ey >> invMass >> restitution >> flags) {
+        BodyDef def;
+        def.shape = shape == "Circle" ? ShapeType::Circle : ShapeType::Rectangle;
+        def.position = Vector2D(px, py);
+        def.velocity = Vector2D(vx, vy);
+        def.radius = def.width = ex;
+        def.height = ey;
+        def.mass = invMass > 0 ? 1.0f / invMass : 0.0f;
+        def.isStatic = flags & BodyFlagStatic;
+        def.restitution = restitution;
+        world.createBody(def);
+    }
+}
+
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const char* binaryPath = "/tmp/bench_world.ckpt";
+    const char* textPath = "/tmp/bench_world.txt";
+
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    world.setBroadphase(std::make_unique<UniformGridBroadphase>(8.0f));
+    scenarios::sparse(world, count, 1);
+    world.update(1.0f / 60.0f);
+    std::printf("%zu bodies\n", world.getBodyCount());
+    std::printf("%-8s %12s %12s %12s\n", "format", "save ms", "load ms", "MB");
+
+    auto start = std::chrono::steady_clock::now();
+    world.saveCheckpoint(binaryPath);
+    const double saveBinary = msSince(start);
+    PhysicsWorld restored;
+    start = std::chrono::steady_clock::now();
+    const bool loaded = restored.loadCheckpoint(binaryPath);
+    const double loadBinary = msSince(start);
+    if (!loaded || restored.getBodyCount() != world.getBodyCount()) {
+        std::printf("restore failed\n");
+        return 1;
+    }
+    std::printf("%-8s %12.1f %12.1f %12.1f\n", "binary", saveBinary, loadBinary, fileBytes(binaryPath) / 1e6);
+
+    start = std::chrono::steady_clock::now();
+    writeText(world, textPath);
+    const double saveText = msSince(start);
+    PhysicsWorld parsed;
+    start = std::chrono::steady_clock::now();
+    readText(parsed, textPath);
+    const double loadText = msSince(start);
+    std::printf("%-8s %12.1f %12.1f %12.1f\n", "text", saveText, loadText, fileBytes(textPath) / 1e6);
+
+    std::remove(binaryPath);
+    std::remove(textPath);
+    return 0;
+}
@@ -0,0 +1,105 @@
+//
+// Narrowphase dispatch microbenchmark: cost per pair test of the old virtual +
+// dynamic_cast path against the shape-type dispatch table.
+//
+
+#include <Physics/Circle.h>
+#include <Physics/Rectangle.h>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+// The pre-table shapes: the virtual call dynamic_casts the other body and
+// only handles its own type
+class LegacyCircle : public PhysicsBody {
+public:
+    float radius;
+    LegacyCircle(Vector2D pos, float r) : PhysicsBody(ShapeType::Circle, pos, 1.0f), radius(r) {}
+
+    bool checkCollision(const PhysicsBody& other) const override {
+        const LegacyCircle* otherCircle = dynamic_cast<const LegacyCircle*>(&other);
+        if (otherCircle) {
+            Vector2D diff = position - otherCircle->position;
+            float radSum = radius + otherCircle->radius;
+            return diff.dot(diff) <= radSum * radSum;
+        }
+        return false;
+    }
+    void resolveCollision(PhysicsBody&) override {}
+    AABB getBounds() const override { return AABB(); }
+    void draw() const override {}
+};
+
+class LegacyRectangle : public PhysicsBody {
+public:
+    float width, height;
+    LegacyRectangle(Vector2D pos, float w, float h) : PhysicsBody(ShapeType::Rectangle, pos, 1.0f), width(w), height(h) {}
+
+    bool checkCollision(const PhysicsBody& other) const override {
+        const LegacyRectangle* otherRect = dynamic_cast<const LegacyRectangle*>(&other);
+        if (otherRect) {
+            return (position.x < otherRect->position.x + otherRect->width &&
+                    position.x + width > otherRect->position.x &&
+                    position.y < otherRect->position.y + otherRect->height &&
+                    position.y + height > otherRect->position.y);
+        }
+        return false;
+    }
+    void resolveCollision(PhysicsBody&) override {}
+    AABB getBounds() const override { return AABB(); }
+    void draw() const override {}
+};
+
+template <typename MakeCircle, typename MakeRect>
+static std::vector<std::unique_ptr<PhysicsBody>> makeBodies(size_t count, MakeCircle makeCircle, MakeRect makeRect) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> pos(0.0f, 100.0f);
+    std::vector<std::unique_ptr<PhysicsBody>> bodies;
+    for (size_t i = 0; i < count; ++i) {
+        Vector2D p(pos(rng), pos(rng));
+        if (rng() % 2) bodies.push_back(makeCircle(p));
+        else bodies.push_back(makeRect(p));
+    }
+    return bodies;
+}
+
+template <typename Test>
+static double nsPerPair(const std::vector<std::unique_ptr<PhysicsBody>>& bodies, Test test, size_t& hits) {
+    auto start = std::chrono::steady_clock::now();
+    size_t pairs = 0;
+    hits = 0;
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        for (size_t j = i + 1; j < bodies.size(); ++j) {
+            hits += test(*bodies[i], *bodies[j]);
+            ++pairs;
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / pairs;
+}
+
+int main() {
+    const size_t count = 3000;
+    auto legacy = makeBodies(count,
+        [](Vector2D p) { return std::make_unique<LegacyCircle>(p, 3.0f); },
+        [](Vector2D p) { return std::make_unique<LegacyRectangle>(p, 6.0f, 6.0f); });
+    auto current = makeBodies(count,
+        [](Vector2D p) { return std::make_unique<Circle>(p, 3.0f, 1.0f); },
+        [](Vector2D p) { return std::make_unique<Rectangle>(p, 6.0f, 6.0f, 1.0f); });
+
+    size_t legacyHits = 0, tableHits = 0;
+    double legacyNs = nsPerPair(legacy, [](const PhysicsBody& a, const PhysicsBody& b) {
+        return a.checkCollision(b);
+    }, legacyHits);
+    double tableNs = nsPerPair(current, [](const PhysicsBody& a, const PhysicsBody& b) {
+        Contact contact;
+        return collide(a, b, contact);
+    }, tableHits);
+
+    std::printf("%-28s %10s %12s\n", "path", "ns/pair", "hits");
+    std::printf("%-28s %10.2f %12zu  (mixed pairs never hit)\n", "virtual + dynamic_cast", legacyNs, legacyHits);
+    std::printf("%-28s %10.2f %12zu\n", "dispatch table", tableNs, tableHits);
+    return 0;
+}
@@ -0,0 +1,150 @@
+//
+// Force generators: time of the forces phase for a cloth of springs under
+// drag, a radial field and wind, against the same forces applied through one
+// virtual call per body and generator.
+// Usage: BenchForces [side] [steps]
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+// The per-object design the registry replaces
+struct VirtualForce {
+    virtual ~VirtualForce() = default;
+    virtual void apply(BodyStorage& storage, uint32_t i) const = 0;
+};
+
+struct VirtualSpring : VirtualForce {
+    uint32_t other;
+    float restLength, stiffness, damping;
+    VirtualSpring(uint32_t other, float restLength, float stiffness, float damping)
+        : other(other), restLength(restLength), stiffness(stiffness), damping(damping) {}
+    void apply(BodyStorage& s, uint32_t i) const override {
+        const Vector2D d = s.centre(other) - s.centre(i);
+        const float length = std::sqrt(d.x * d.x + d.y * d.y);
+        if (length == 0.0f) return;
+        const float speed = ((s.velX[other] - s.velX[i]) * d.x + (s.velY[other] - s.velY[i]) * d.y) / length;
+        const float magnitude = (stiffness * (length - restLength) + damping * speed) / length;
+        s.forceX[i] += magnitude * d.x;
+        s.forceY[i] += magnitude * d.y;
+    }
+};
+
+struct VirtualDrag : VirtualForce {
+    DragForce drag;
+    explicit VirtualDrag(DragForce drag) : drag(drag) {}
+    void apply(BodyStorage& s, uint32_t i) const override {
+        const float k = drag.linear + drag.quadratic * std::sqrt(s.velX[i] * s.velX[i] + s.velY[i] * s.velY[i]);
+        s.forceX[i] -= k * s.velX[i];
+        s.forceY[i] -= k * s.velY[i];
+    }
+};
+
+struct VirtualRadial : VirtualForce {
+    RadialForce field;
+    explicit VirtualRadial(RadialForce field) : field(field) {}
+    void apply(BodyStorage& s, uint32_t i) const override {
+        const Vector2D d = field.centre - s.centre(i);
+        const float distance = std::sqrt(d.x * d.x + d.y * d.y);
+        if (distance >= field.radius || distance == 0.0f || s.invMass[i] == 0.0f) return;
+        const float scale = field.strength * (1.0f - distance / field.radius) / distance / s.invMass[i];
+        s.forceX[i] += d.x * scale;
+        s.forceY[i] += d.y * scale;
+    }
+};
+
+struct VirtualWind : VirtualForce {
+    WindForce wind;
+    explicit VirtualWind(WindForce wind) : wind(wind) {}
+    void apply(BodyStorage& s, uint32_t i) const override {
+        const Vector2D c = s.centre(i);
+        if (!wind.region.overlaps(AABB(c, c))) return;
+        s.forceX[i] += wind.coefficient * (wind.velocity.x - s.velX[i]);
+        s.forceY[i] += wind.coefficient * (wind.velocity.y - s.velY[i]);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    const int side = argc > 1 ? std::atoi(argv[1]) : 200;
+    const int steps = argc > 2 ? std::atoi(argv[2]) : 100;
+    const float spacing = 4.0f;
+
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    world.setBroadphase(std::make_unique<UniformGridBroadphase>(8.0f));
+    world.getIslands().settings.enabled = false;
+    std::vector<BodyHandle> cloth;
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            BodyDef def;
+            def.position = Vector2D(x * spacing, y * spacing);
+            def.radius = 1.0f;
+            def.isStatic = y == 0 && x % 10 == 0;
+            cloth.push_back(world.createBody(def));
+        }
+    }
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            const BodyHandle body = cloth[y * side + x];
+            if (x + 1 < side) world.addSpring(SpringDef{body, cloth[y * side + x + 1], spacing, 500.0f, 2.0f});
+            if (y + 1 < side) world.addSpring(SpringDef{body, cloth[(y + 1) * side + x], spacing, 500.0f, 2.0f});
+        }
+    }
+    const float extent = side * spacing;
+    world.addDrag(DragForce{0.1f, 0.01f});
+    world.addRadialForce(RadialForce{Vector2D(extent * 0.5f, extent * 0.5f), -50.0f, extent * 0.25f});
+    WindForce wind;
+    wind.velocity = Vector2D(30, 0);
+    wind.coefficient = 0.05f;
+    wind.region = AABB(Vector2D(0, extent * 0.5f), Vector2D(extent, extent));
+    world.addWind(wind);
+
+    // The same forces as objects, one virtual call per body and force
+    const BodyStorage& storage = world.getStorage();
+    std::vector<std::pair<uint32_t, std::unique_ptr<VirtualForce>>> objects;
+    const SpringColumns& springs = world.getForces().springs;
+    for (size_t k = 0; k < springs.size(); ++k) {
+        const uint32_t a = storage.indexOf(springs.a[k]), b = storage.indexOf(springs.b[k]);
+        objects.emplace_back(a, std::make_unique<VirtualSpring>(b, springs.restLength[k], springs.stiffness[k], springs.damping[k]));
+        objects.emplace_back(b, std::make_unique<VirtualSpring>(a, springs.restLength[k], springs.stiffness[k], springs.damping[k]));
+    }
+    for (uint32_t i = 0; i < storage.size(); ++i) {
+        objects.emplace_back(i, std::make_unique<VirtualDrag>(world.getForces().drags[0].params));
+        objects.emplace_back(i, std::make_unique<VirtualRadial>(world.getForces().radials[0].params));
+        objects.emplace_back(i, std::make_unique<VirtualWind>(world.getForces().winds[0].params));
+    }
+
+    for (int i = 0; i < 10; ++i) world.update(1.0f / 60.0f);
+    double batchedMs = 0;
+#if PHYSICS_PROFILER
+    world.getProfiler().clear();
+    for (int i = 0; i < steps; ++i) world.update(1.0f / 60.0f);
+    for (size_t i = 0; i < world.getProfiler().size(); ++i) {
+        batchedMs += world.getProfiler().record(i).phaseNs[static_cast<size_t>(ProfilePhase::Forces)] / 1e6;
+    }
+#endif
+
+    // Applied to a copy of the storage, so the world is left as it is
+    BodyStorage copy = storage;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) {
+        for (const auto& [body, force] : objects) {
+            if (!copy.isStatic(body)) force->apply(copy, body);
+        }
+    }
+    const double virtualMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%zu bodies, %zu springs, %d steps\n", storage.size(), springs.size(), steps);
+    std::printf("%-10s %12s\n", "", "ms/step");
+#if PHYSICS_PROFILER
+    std::printf("%-10s %12.3f\n", "batched", batchedMs / steps);
+#else
+    std::printf("%-10s %12s\n", "batched", "needs PHYSICS_PROFILER");
+#endif
+    std::printf("%-10s %12.3f\n", "virtual", virtualMs / steps);
+    return 0;
+}
@@ -0,0 +1,47 @@
+//
+// Integration kernel benchmark: scalar, SSE2 and AVX2 over SoA columns.
+//
+
+#include <Physics/BodyStorage.h>
+#include <Physics/Integrator.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+int main() {
+    const size_t counts[] = {10000, 100000, 1000000};
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2};
+    const Vector2D gravity(0, 98.0f);
+    const float dt = 1.0f / 60.0f;
+
+    std::printf("cpu supports: %s\n", simdLevelName(detectSimdLevel()));
+    std::printf("%-10s %-8s %12s %14s\n", "bodies", "kernel", "us/step", "ns/body");
+    for (size_t count : counts) {
+        BodyStorage storage;
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> pos(0.0f, 1000.0f);
+        for (size_t i = 0; i < count; ++i) {
+            BodyDef def;
+            def.position = Vector2D(pos(rng), pos(rng));
+            def.isStatic = i % 10 == 0;
+            storage.add(def);
+        }
+        IntegrationColumns columns{storage.posX.data(), storage.posY.data(), storage.velX.data(), storage.velY.data(),
+                                   storage.forceX.data(), storage.forceY.data(), storage.invMass.data(),
+                                   storage.flags.data(), storage.size()};
+
+        for (SimdLevel level : levels) {
+            if (level > detectSimdLevel()) continue;
+            const int steps = count >= 1000000 ? 50 : 500;
+            integrateBodies(columns, 0, count, gravity, dt, BodyFlagStatic, level);
+            auto start = std::chrono::steady_clock::now();
+            for (int s = 0; s < steps; ++s) {
+                integrateBodies(columns, 0, count, gravity, dt, BodyFlagStatic, level);
+            }
+            auto end = std::chrono::steady_clock::now();
+            double us = std::chrono::duration<double, std::micro>(end - start).count() / steps;
+            std::printf("%-10zu %-8s %12.1f %14.3f\n", count, simdLevelName(level), us, us * 1000.0 / count);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+//
+// Spatial query throughput: queries per second on a settled world, one query
+// at a time and batched over a job system into flat buffers, for each
+// broadphase that indexes. "line of sight" fires 50k rays from 64 observers
+// per tick, each sweeping its surroundings, which the batch traverses in ray
+// packets.
+// Usage: BenchQueries [bodies] [queries] [threads]
+//
+
+#include "Scenarios.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+static double qps(size_t queries, const std::function<void()>& run) {
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return queries / s;
+}
+
+int main(int argc, char* argv[]) {
+    const size_t count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    const size_t queryCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+    const Size threads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : RK::JobSystem::defaultThreadCount();
+
+    struct Candidate {
+        const char* name;
+        std::unique_ptr<Broadphase> (*make)();
+    };
+    const Candidate candidates[] = {
+        {"grid", [] { return std::unique_ptr<Broadphase>(std::make_unique<UniformGridBroadphase>(8.0f)); }},
+        {"sap", [] { return std::unique_ptr<Broadphase>(std::make_unique<SweepAndPruneBroadphase>()); }},
+        {"tree", [] { return std::unique_ptr<Broadphase>(std::make_unique<DynamicTreeBroadphase>()); }},
+    };
+
+    std::printf("%zu bodies, %zu queries, batches on %zu threads\n", count, queryCount, threads);
+    std::printf("%-6s %-14s %14s %14s\n", "", "query", "single q/s", "batched q/s");
+
+    RK::JobSystem jobs(threads);
+    for (const Candidate& c : candidates) {
+        PhysicsWorld world;
+        world.setBroadphase(c.make());
+        world.setJobSystem(&jobs);
+        scenarios::rain(world, count, 1);
+        for (int i = 0; i < 10; ++i) world.update(1.0f / 60.0f);
+
+        // Queries spread over the area the bodies cover
+        const float width = std::sqrt(static_cast<float>(count)) * 40.0f;
+        std::mt19937 rng(2);
+        std::uniform_real_distribution<float> x(0.0f, width), y(0.0f, width * 0.5f), step(-60.0f, 60.0f);
+        std::vector<RayQuery> rays;
+        std::vector<AABB> boxes;
+        std::vector<CircleQuery> circles;
+        std::vector<NearestQuery> nearest;
+        for (size_t q = 0; q < queryCount; ++q) {
+            const Vector2D p(x(rng), y(rng));
+            rays.push_back({p, p + Vector2D(step(rng), step(rng))});
+            boxes.emplace_back(p, p + Vector2D(20, 20));
+            circles.push_back({p, 10.0f});
+            nearest.push_back({p, 8});
+        }
+
+        // Each observer sweeps its view radius, rays ordered by angle
+        std::vector<RayQuery> sight;
+        const int perObserver = 50000 / 64;
+        for (int observer = 0; observer < 64; ++observer) {
+            const Vector2D eye(x(rng), y(rng));
+            for (int i = 0; i < perObserver; ++i) {
+                const float angle = 6.2831853f * i / perObserver;
+                sight.push_back({eye, eye + Vector2D(std::cos(angle), std::sin(angle)) * 240.0f});
+            }
+        }
+
+        std::vector<BodyHandle> out;
+        std::vector<RayHit> hits(std::max(rays.size(), sight.size()));
+        std::vector<BodyHandle> handles(queryCount * 16);
+        std::vector<QueryRange> ranges(queryCount);
+        auto row = [&](const char* query, double single, double batched) {
+            std::printf("%-6s %-14s %14.0f %14.0f\n", c.name, query, single, batched);
+        };
+        row("raycast",
+            qps(queryCount, [&] { RayHit hit; for (const RayQuery& r : rays) world.raycast(r.from, r.to, hit); }),
+            qps(queryCount, [&] { world.raycastBatch(rays, hits); }));
+        row("line of sight",
+            qps(sight.size(), [&] { RayHit hit; for (const RayQuery& r : sight) world.raycast(r.from, r.to, hit); }),
+            qps(sight.size(), [&] { world.raycastBatch(sight, hits); }));
+        row("overlapAABB",
+            qps(queryCount, [&] { for (const AABB& b : boxes) world.overlapAABB(b, out); }),
+            qps(queryCount, [&] { world.overlapAABBBatch(boxes, handles, ranges); }));
+        row("overlapCircle",
+            qps(queryCount, [&] { for (const CircleQuery& q : circles) world.overlapCircle(q.centre, q.radius, out); }),
+            qps(queryCount, [&] { world.overlapCircleBatch(circles, handles, ranges); }));
+        row("kNearest(8)",
+            qps(queryCount, [&] { for (const NearestQuery& q : nearest) world.kNearest(q.point, q.k, out); }),
+            qps(queryCount, [&] { world.kNearestBatch(nearest, handles, ranges); }));
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+//
+// Throughput of the lock-free queues against a mutex around std::deque, plus
+// a padded against an unpadded counter under contention. Millions of items
+// per second, higher is better.
+//
+
+#include <Shared/Atomic.h>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace RK;
+
+struct MutexQueue {
+    std::mutex mutex;
+    std::deque<UInt64> items;
+
+    Bool tryPush(UInt64 v) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.push_back(v);
+        return true;
+    }
+    Bool tryPop(UInt64& v) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.empty()) return false;
+        v = items.front();
+        items.pop_front();
+        return true;
+    }
+};
+
+// producers push perProducer items each, consumers drain them all
+template <typename Queue>
+static double pumpMillionsPerSec(Queue& queue, int producers, int consumers, UInt64 perProducer) {
+    const UInt64 total = perProducer * producers;
+    std::atomic<UInt64> popped{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&] {
+            Backoff backoff;
+            for (UInt64 i = 0; i < perProducer; i++) {
+                while (!queue.tryPush(i)) backoff.pause();
+                backoff.reset();
+            }
+        });
+    }
+    for (int c = 0; c < consumers; c++) {
+        threads.emplace_back([&] {
+            Backoff backoff;
+            UInt64 v;
+            while (popped.load(std::memory_order_relaxed) < total) {
+                if (queue.tryPop(v)) {
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                    backoff.reset();
+                } else {
+                    backoff.pause();
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total / s / 1e6;
+}
+
+static double dequeMillionsPerSec(int thieves, UInt64 count) {
+    WorkStealingDeque<UInt64> deque;
+    std::atomic<UInt64> taken{0};
+    std::atomic<Bool> done{false};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < thieves; i++) {
+        threads.emplace_back([&] {
+            Backoff backoff;
+            UInt64 v;
+            while (!done.load(std::memory_order_relaxed)) {
+                if (deque.steal(v)) {
+                    taken.fetch_add(1, std::memory_order_relaxed);
+                    backoff.reset();
+                } else {
+                    backoff.pause();
+                }
+            }
+        });
+    }
+    UInt64 v;
+    for (UInt64 i = 0; i < count; i++) {
+        deque.push(i);
+        if (i % 2 && deque.pop(v)) taken.fetch_add(1, std::memory_order_relaxed);
+    }
+    while (deque.pop(v)) taken.fetch_add(1, std::memory_order_relaxed);
+    while (taken.load() < count) std::this_thread::yield();
+    done = true;
+    for (std::thread& t : threads) t.join();
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return count / s / 1e6;
+}
+
+struct UnpaddedCounters {
+    std::atomic<UInt64> values[8];
+};
+
+template <typename Add>
+static double countersMillionsPerSec(int threadCount, UInt64 perThread, Add add) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&, t] { for (UInt64 i = 0; i < perThread; i++) add(t); });
+    }
+    for (std::thread& t : threads) t.join();
+    const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threadCount * perThread / s / 1e6;
+}
+
+int main() {
+    const UInt64 items = 2000000;
+    std::printf("%-36s %12s %12s\n", "queue", "lock-free", "mutex");
+    {
+        SpscRing<UInt64> ring(1024);
+        MutexQueue locked;
+        std::printf("%-36s %12.1f %12.1f\n", "spsc, 1 -> 1", pumpMillionsPerSec(ring, 1, 1, items),
+                    pumpMillionsPerSec(locked, 1, 1, items));
+    }
+    for (int n : {1, 2, 4}) {
+        MpmcQueue<UInt64> queue(1024);
+        MutexQueue locked;
+        char name[64];
+        std::snprintf(name, sizeof(name), "mpmc, %d -> %d", n, n);
+        std::printf("%-36s %12.1f %12.1f\n", name, pumpMillionsPerSec(queue, n, n, items / n),
+                    pumpMillionsPerSec(locked, n, n, items / n));
+    }
+    for (int thieves : {0, 1, 3}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "chase-lev, owner + %d thieves", thieves);
+        std::printf("%-36s %12.1f %12s\n", name, dequeMillionsPerSec(thieves, items), "-");
+    }
+
+    std::printf("\n%-36s %12s %12s\n", "counters, 4 threads", "padded", "unpadded");
+    PaddedCounter padded[8];
+    UnpaddedCounters unpadded{};
+    const double p = countersMillionsPerSec(4, 10000000, [&](int t) { padded[t].add(); });
+    const double u = countersMillionsPerSec(4, 10000000, [&](int t) {
+        unpadded.values[t].fetch_add(1, std::memory_order_relaxed);
+    });
+    std::printf("%-36s %12.1f %12.1f\n", "one counter per thread", p, u);
+    return 0;
+}
@@ -0,0 +1,60 @@
+//
+// Replay speed: record a session, replay it with hash checks, and compare
+// against real time at 60 Hz. Also the cost of the state hash per step.
+//
+
+#include "Scenarios.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+static double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? std::stoul(argv[1]) : 10000;
+    const int steps = argc > 2 ? std::stoi(argv[2]) : 600;
+    const float dt = 1.0f / 60.0f;
+
+    auto build = [&](PhysicsWorld& world) {
+        world.setBroadphase(std::make_unique<UniformGridBroadphase>(8.0f));
+        scenarios::rain(world, count, 1);
+    };
+
+    ReplayLog log;
+    PhysicsWorld recorded;
+    recorded.setRecorder(&log);
+    build(recorded);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) recorded.update(dt);
+    const double recordMs = msSince(start);
+
+    PhysicsWorld plain;
+    build(plain);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) plain.update(dt);
+    const double plainMs = msSince(start);
+
+    // Configured like the recording, the bodies come from the log
+    PhysicsWorld replayed;
+    replayed.setBroadphase(std::make_unique<UniformGridBroadphase>(8.0f));
+    start = std::chrono::steady_clock::now();
+    const ReplayResult result = replay(log, replayed);
+    const double replayMs = msSince(start);
+
+    start = std::chrono::steady_clock::now();
+    volatile uint64_t sink = 0;
+    for (int i = 0; i < steps; ++i) sink = sink + hashWorldState(replayed.getStorage());
+    const double hashMs = msSince(start);
+
+    const double realTimeMs = steps * dt * 1000.0;
+    std::printf("%zu bodies, %d steps, log %zu bytes\n", recorded.getBodyCount(), steps, log.getBytes().size());
+    std::printf("%-22s %10.3f ms/step\n", "step", plainMs / steps);
+    std::printf("%-22s %10.3f ms/step\n", "step + record", recordMs / steps);
+    std::printf("%-22s %10.3f ms/step  %.1fx real time, %s\n", "replay", replayMs / steps,
+                realTimeMs / replayMs, result.diverged() ? "DIVERGED" : "matches");
+    std::printf("%-22s %10.3f ms/step  %.2f GB/s\n", "state hash", hashMs / steps,
+                replayed.getBodyCount() * 17.0 * steps / (hashMs * 1e6));
+    return result.diverged() ? 1 : 0;
+}
@@ -0,0 +1,130 @@
+//
+// Body storage benchmark at 100k bodies: the integrate loop over one heap
+// object per body (the old vector<unique_ptr<PhysicsBody>> layout) against the
+// SoA columns, plus a full world step. Cache misses come from perf_event_open
+// when the kernel allows it.
+//
+
+#include <Physics/Circle.h>
+#include <Physics/PhysicsWorld.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <random>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Hardware cache miss counter for the calling thread, -1 if unavailable
+class CacheMissCounter {
+public:
+    CacheMissCounter() {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+    ~CacheMissCounter() {
+        if (fd >= 0) close(fd);
+    }
+    void start() {
+        if (fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    long long stop() {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        long long value = 0;
+        if (read(fd, &value, sizeof(value)) != sizeof(value)) return -1;
+        return value;
+    }
+
+private:
+    int fd;
+};
+
+struct Result {
+    double ms;
+    long long misses;
+};
+
+template <typename Fn>
+static Result measure(Fn&& fn, int steps) {
+    CacheMissCounter counter;
+    fn(); // warm up
+    auto start = std::chrono::steady_clock::now();
+    counter.start();
+    for (int i = 0; i < steps; ++i) fn();
+    long long misses = counter.stop();
+    auto end = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double, std::milli>(end - start).count() / steps, misses < 0 ? -1 : misses / steps};
+}
+
+static void print(const char* name, const Result& r) {
+    if (r.misses >= 0) std::printf("%-34s %10.3f %14lld\n", name, r.ms, r.misses);
+    else std::printf("%-34s %10.3f %14s\n", name, r.ms, "n/a");
+}
+
+int main() {
+    const size_t count = 100000;
+    const float dt = 1.0f / 60.0f;
+    const Vector2D gravity(0, 98.0f);
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> pos(0.0f, 6000.0f);
+
+    // Old layout. Bodies are visited in allocation order shuffled, as they end
+    // up in a long running world with interleaved allocations.
+    std::vector<std::unique_ptr<PhysicsBody>> objects;
+    for (size_t i = 0; i < count; ++i) {
+        objects.push_back(std::make_unique<Circle>(Vector2D(pos(rng), pos(rng)), 3.0f, 1.0f));
+    }
+    std::shuffle(objects.begin(), objects.end(), rng);
+
+    PhysicsWorld world(gravity);
+    world.setBroadphase(std::make_unique<DynamicTreeBroadphase>());
+    for (size_t i = 0; i < count; ++i) {
+        world.addBody(std::make_unique<Circle>(Vector2D(pos(rng), pos(rng)), 3.0f, 1.0f));
+    }
+
+    std::printf("%zu bodies\n", count);
+    std::printf("%-34s %10s %14s\n", "phase", "ms/step", "cache misses");
+
+    print("integrate, unique_ptr<PhysicsBody>", measure([&] {
+        for (auto& body : objects) {
+            if (!body->isStatic) body->applyForce(gravity * body->mass);
+        }
+        for (auto& body : objects) body->update(dt);
+    }, 50));
+
+    // Same integration over the SoA columns
+    BodyStorage storage;
+    BodyDef def;
+    def.radius = 3.0f;
+    for (size_t i = 0; i < count; ++i) {
+        def.position = Vector2D(pos(rng), pos(rng));
+        storage.add(def);
+    }
+    print("integrate, SoA columns", measure([&] {
+        for (size_t i = 0; i < storage.size(); ++i) {
+            if (storage.flags[i] & BodyFlagStatic) continue;
+            storage.velX[i] += (gravity.x + storage.forceX[i] * storage.invMass[i]) * dt;
+            storage.velY[i] += (gravity.y + storage.forceY[i] * storage.invMass[i]) * dt;
+            storage.posX[i] += storage.velX[i] * dt;
+            storage.posY[i] += storage.velY[i] * dt;
+            storage.forceX[i] = 0.0f;
+            storage.forceY[i] = 0.0f;
+        }
+    }, 50));
+
+    print("full step, SoA + tree broadphase", measure([&] { world.update(dt); }, 20));
+    return 0;
+}
@@ -0,0 +1,134 @@
+//
+// Name lookup before and after interning. "Before" is the old helpers (byte
+// loops, one heap block per string) kept here as a reference; "after" is the
+// SSE2 helpers, the small-string RK::String and StringInterner ids.
+//
+
+#include <Shared/String.h>
+#include <Shared/StringInterner.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace old {
+
+Size str_length(const char* str) {
+    const char* ptr = str;
+    while (*ptr != '\0') ptr++;
+    return ptr - str;
+}
+
+Size str_compare(const char* s1, const char* s2) {
+    while (*s1 == *s2) {
+        if (*s1 == '\0') return 0;
+        s1++;
+        s2++;
+    }
+    return 1;
+}
+
+// Heap-allocated for every length, like the old StringImpl
+struct String {
+    explicit String(const char* str) : size(old::str_length(str)), data(new char[size + 1]) {
+        std::memcpy(data, str, size + 1);
+    }
+    ~String() { delete[] data; }
+    String(const String&) = delete;
+    Size size;
+    char* data;
+};
+
+} // namespace old
+
+template <typename Fn>
+static double bestNs(int rounds, int ops, Fn fn) {
+    double best = 1e30;
+    for (int r = 0; r < rounds; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / ops);
+    }
+    return best;
+}
+
+static volatile Size sink;
+
+static void report(const char* name, double before, double after) {
+    std::printf("%-34s %10.2f %10.2f %8.2fx\n", name, before, after, before / after);
+}
+
+int main() {
+    const int bodies = 1000;
+    const int lookups = 200000;
+    const int rounds = 5;
+
+    // Names shaped like the ones bodies get: a category and an index
+    const char* categories[] = {"crate", "ground", "wall", "debris/small", "ragdoll/left_forearm"};
+    std::vector<std::string> names;
+    for (int i = 0; i < bodies; ++i) names.push_back(std::string(categories[i % 5]) + "_" + std::to_string(i));
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> pick(0, bodies - 1);
+    std::vector<std::string> queries;
+    for (int i = 0; i < lookups; ++i) queries.push_back(names[pick(rng)]);
+
+    std::printf("%d names, %d lookups, ns/op\n", bodies, lookups);
+    std::printf("%-34s %10s %10s %9s\n", "operation", "before", "after", "speedup");
+
+    report("str_length",
+           bestNs(rounds, lookups, [&] { for (auto& q : queries) sink = sink + old::str_length(q.c_str()); }),
+           bestNs(rounds, lookups, [&] { for (auto& q : queries) sink = sink + RK::str_length(q.c_str()); }));
+
+    const std::string longA(200, 'a'), longB = longA;
+    report("str_compare, 200 equal chars",
+           bestNs(rounds, lookups, [&] { for (int i = 0; i < lookups; ++i) sink = sink + old::str_compare(longA.c_str(), longB.c_str()); }),
+           bestNs(rounds, lookups, [&] { for (int i = 0; i < lookups; ++i) sink = sink + RK::str_compare(longA.c_str(), longB.c_str()); }));
+
+    report("construct + destroy a name",
+           bestNs(rounds, lookups, [&] { for (auto& q : queries) { old::String s(q.c_str()); sink = sink + s.size; } }),
+           bestNs(rounds, lookups, [&] { for (auto& q : queries) { RK::String s(q.c_str()); sink = sink + s.size(); } }));
+
+    // Find a body by name: scan the name table against an interner probe
+    std::vector<old::String*> oldTable;
+    for (auto& n : names) oldTable.push_back(new old::String(n.c_str()));
+    RK::StringInterner interner;
+    std::vector<int> bodyOfName;   // indexed by StringId
+    for (int i = 0; i < bodies; ++i) {
+        const RK::StringId id = interner.intern(names[i].c_str());
+        bodyOfName.resize(id + 1, -1);
+        bodyOfName[id] = i;
+    }
+    std::unordered_map<std::string, int> hashed;
+    for (int i = 0; i < bodies; ++i) hashed[names[i]] = i;
+
+    const double scan = bestNs(1, lookups, [&] {
+        for (auto& q : queries) {
+            for (int i = 0; i < bodies; ++i) {
+                if (old::str_compare(oldTable[i]->data, q.c_str()) == 0) { sink = sink + i; break; }
+            }
+        }
+    });
+    const double probe = bestNs(rounds, lookups, [&] {
+        for (auto& q : queries) sink = sink + bodyOfName[interner.find(q.c_str(), q.size())];
+    });
+    report("find body by name (scan / intern)", scan, probe);
+    report("find body by name (unordered_map)",
+           bestNs(rounds, lookups, [&] { for (auto& q : queries) sink = sink + hashed.find(q)->second; }), probe);
+
+    // Once names are ids, equality is an integer compare
+    std::vector<RK::StringId> queryIds;
+    for (auto& q : queries) queryIds.push_back(interner.find(q.c_str()));
+    const RK::StringId wanted = interner.find(names[7].c_str());
+    report("name equality (compare / id)",
+           bestNs(rounds, lookups, [&] { for (auto& q : queries) sink = sink + (old::str_compare(q.c_str(), names[7].c_str()) == 0); }),
+           bestNs(rounds, lookups, [&] { for (RK::StringId id : queryIds) sink = sink + (id == wanted); }));
+
+    for (old::String* s : oldTable) delete s;
+    return 0;
+}
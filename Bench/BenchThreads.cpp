@@ -0,0 +1,51 @@
+//
+// Thread scaling benchmark: world step time from 1 to N threads.
+// Usage: BenchThreads [maxThreads] [bodies]
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+int main(int argc, char* argv[]) {
+    const Size maxThreads = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : RK::JobSystem::defaultThreadCount();
+    const size_t count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+    const float dt = 1.0f / 60.0f;
+
+    std::printf("%zu bodies, %zu hardware threads\n", count, RK::JobSystem::defaultThreadCount());
+    std::printf("%-8s %12s %10s\n", "threads", "ms/step", "speedup");
+
+    double single = 0;
+    for (Size threads = 1; threads <= maxThreads; threads *= 2) {
+        RK::JobSystem jobs(threads);
+        PhysicsWorld world(Vector2D(0, 0));
+        world.setBroadphase(std::make_unique<UniformGridBroadphase>(16.0f));
+        world.setJobSystem(&jobs);
+
+        std::mt19937 rng(3);
+        const float side = std::sqrt(static_cast<float>(count) * 400.0f);
+        std::uniform_real_distribution<float> pos(0.0f, side);
+        std::uniform_real_distribution<float> vel(-20.0f, 20.0f);
+        for (size_t i = 0; i < count; ++i) {
+            BodyDef def;
+            def.position = Vector2D(pos(rng), pos(rng));
+            def.velocity = Vector2D(vel(rng), vel(rng));
+            def.radius = 3.0f;
+            world.createBody(def);
+        }
+        world.update(dt);
+
+        const int steps = 10;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) world.update(dt);
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count() / steps;
+        if (threads == 1) single = ms;
+        std::printf("%-8zu %12.3f %10.2f\n", threads, ms, single / ms);
+
+        if (threads < maxThreads && threads * 2 > maxThreads) threads = maxThreads / 2;
+    }
+    return 0;
+}
@@ -0,0 +1,173 @@
+//
+// Physics benchmark suite: steps seeded scenarios and reports ns per body per
+// step, steps per second and peak RSS, then writes them to a baseline file.
+// Usage: PhysicsBench [--scenario name|all] [--bodies n] [--steps n]
+//                     [--warmup n] [--seed n] [--threads n]
+//                     [--broadphase brute|grid|sap|tree] [--baseline file]
+//
+
+#include "Scenarios.h"
+#include <Physics/PhysicsWorld.h>
+#include <sys/resource.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct Options {
+    std::string scenario = "all";
+    size_t bodies = 10000;
+    int steps = 300;
+    int warmup = 30;
+    unsigned seed = 1;
+    size_t threads = 1;
+    std::string broadphase = "tree";
+    std::string baseline = "physics_baseline.json";
+};
+
+struct Result {
+    const char* scenario;
+    double nsPerBodyStep;
+    double stepsPerSecond;
+    double p50Ms;
+    double p99Ms;
+    size_t peakRssKb;
+};
+
+static std::unique_ptr<Broadphase> makeBroadphase(const std::string& name) {
+    if (name == "brute") return std::make_unique<BruteForceBroadphase>();
+    if (name == "grid") return std::make_unique<UniformGridBroadphase>(16.0f);
+    if (name == "sap") return std::make_unique<SweepAndPruneBroadphase>();
+    if (name == "tree") return std::make_unique<DynamicTreeBroadphase>();
+    return nullptr;
+}
+
+// Peak resident set of the process so far; it never goes down, so later
+// scenarios report at least the peak of earlier ones
+static size_t peakRssKb() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss); // kilobytes on Linux
+}
+
+static Result run(const Scenario& scenario, const Options& options, RK::JobSystem* jobs) {
+    const float dt = 1.0f / 60.0f;
+    PhysicsWorld world;
+    world.setBroadphase(makeBroadphase(options.broadphase));
+    world.setJobSystem(jobs);
+    scenario.build(world, options.bodies, options.seed);
+
+    for (int i = 0; i < options.warmup; ++i) world.update(dt);
+#if PHYSICS_PROFILER
+    world.getProfiler().clear();
+#endif
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.steps; ++i) world.update(dt);
+    const auto end = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(end - start).count();
+
+    Result result;
+    result.scenario = scenario.name;
+    result.nsPerBodyStep = seconds * 1e9 / (static_cast<double>(options.steps) * world.getBodyCount());
+    result.stepsPerSecond = options.steps / seconds;
+#if PHYSICS_PROFILER
+    const ProfileSummary summary = world.getProfiler().summarizeTotal();
+    result.p50Ms = summary.p50 * 1e-6;
+    result.p99Ms = summary.p99 * 1e-6;
+#else
+    result.p50Ms = result.p99Ms = 0;
+#endif
+    result.peakRssKb = peakRssKb();
+    return result;
+}
+
+static bool writeBaseline(const std::string& path, const Options& options, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "{\n";
+    out << "  \"bodies\": " << options.bodies << ",\n";
+    out << "  \"steps\": " << options.steps << ",\n";
+    out << "  \"seed\": " << options.seed << ",\n";
+    out << "  \"threads\": " << options.threads << ",\n";
+    out << "  \"broadphase\": \"" << options.broadphase << "\",\n";
+    out << "  \"profiler\": " << (PHYSICS_PROFILER ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"scenario\": \"" << r.scenario << "\""
+            << ", \"ns_per_body_step\": " << r.nsPerBodyStep
+            << ", \"steps_per_second\": " << r.stepsPerSecond
+            << ", \"p50_ms\": " << r.p50Ms
+            << ", \"p99_ms\": " << r.p99Ms
+            << ", \"peak_rss_kb\": " << r.peakRssKb << "}";
+    }
+    out << "\n  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+static bool parse(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) return false;
+        if (std::strcmp(arg, "--scenario") == 0) options.scenario = value;
+        else if (std::strcmp(arg, "--bodies") == 0) options.bodies = std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--steps") == 0) options.steps = std::atoi(value);
+        else if (std::strcmp(arg, "--warmup") == 0) options.warmup = std::atoi(value);
+        else if (std::strcmp(arg, "--seed") == 0) options.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (std::strcmp(arg, "--threads") == 0) options.threads = std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--broadphase") == 0) options.broadphase = value;
+        else if (std::strcmp(arg, "--baseline") == 0) options.baseline = value;
+        else return false;
+        ++i;
+    }
+    return options.bodies > 0 && options.steps > 0 && options.threads > 0 && makeBroadphase(options.broadphase);
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--scenario name|all] [--bodies n] [--steps n] [--warmup n] [--seed n]"
+                             " [--threads n] [--broadphase brute|grid|sap|tree] [--baseline file]\n", argv[0]);
+        for (const Scenario& s : allScenarios) std::fprintf(stderr, "  %-8s %s\n", s.name, s.description);
+        return 1;
+    }
+
+    std::vector<const Scenario*> selected;
+    if (options.scenario == "all") {
+        for (const Scenario& s : allScenarios) selected.push_back(&s);
+    } else if (const Scenario* s = findScenario(options.scenario.c_str())) {
+        selected.push_back(s);
+    } else {
+        std::fprintf(stderr, "unknown scenario '%s'\n", options.scenario.c_str());
+        return 1;
+    }
+
+    // A single thread runs the step on the caller, without a pool
+    std::unique_ptr<RK::JobSystem> jobs;
+    if (options.threads > 1) jobs = std::make_unique<RK::JobSystem>(options.threads);
+
+    std::printf("%zu bodies, %d steps, seed %u, %zu threads, %s broadphase\n",
+                options.bodies, options.steps, options.seed, options.threads, options.broadphase.c_str());
+    std::printf("%-8s %14s %12s %10s %10s %12s\n", "scenario", "ns/body/step", "steps/s", "p50 ms", "p99 ms", "peak RSS MB");
+
+    std::vector<Result> results;
+    for (const Scenario* scenario : selected) {
+        const Result r = run(*scenario, options, jobs.get());
+        std::printf("%-8s %14.2f %12.1f %10.3f %10.3f %12.1f\n", r.scenario, r.nsPerBodyStep, r.stepsPerSecond,
+                    r.p50Ms, r.p99Ms, r.peakRssKb / 1024.0);
+        results.push_back(r);
+    }
+
+    if (!writeBaseline(options.baseline, options, results)) {
+        std::fprintf(stderr, "cannot write %s\n", options.baseline.c_str());
+        return 1;
+    }
+    std::printf("baseline written to %s\n", options.baseline.c_str());
+    return 0;
+}
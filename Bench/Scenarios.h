@@ -0,0 +1,124 @@
+#pragma once
+
+// Seeded scenario generators shared by the benchmarks. The same name, body
+// count and seed always build the same world.
+
+#include <Physics/PhysicsWorld.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+struct Scenario {
+    const char* name;
+    const char* description;
+    void (*build)(PhysicsWorld& world, size_t count, unsigned seed);
+};
+
+namespace scenarios {
+
+// Static floor spanning [0, width] with its top at y
+inline void addGround(PhysicsWorld& world, float width, float y) {
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, y);
+    ground.width = width;
+    ground.height = 50;
+    ground.isStatic = true;
+    world.createBody(ground);
+}
+
+// Circles falling from a wide band onto the ground
+inline void rain(PhysicsWorld& world, size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    const float width = std::sqrt(static_cast<float>(count)) * 40.0f;
+    const float height = width * 0.5f;
+    std::uniform_real_distribution<float> x(0.0f, width);
+    std::uniform_real_distribution<float> y(0.0f, height);
+    std::uniform_real_distribution<float> radius(2.0f, 4.0f);
+
+    world.setGravity(Vector2D(0, 98.0f));
+    addGround(world, width, height + 10.0f);
+    for (size_t i = 0; i < count; ++i) {
+        BodyDef def;
+        def.position = Vector2D(x(rng), y(rng));
+        def.radius = radius(rng);
+        def.restitution = 0.3f;
+        world.createBody(def);
+    }
+}
+
+// Columns of boxes stacked edge to edge on the ground
+inline void pile(PhysicsWorld& world, size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    const size_t columns = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<float>(count))));
+    const float size = 8.0f;
+    const float floor = (count / columns + 1) * size;
+
+    world.setGravity(Vector2D(0, 98.0f));
+    addGround(world, columns * size * 1.25f, floor);
+    for (size_t i = 0; i < count; ++i) {
+        BodyDef def;
+        def.shape = ShapeType::Rectangle;
+        def.position = Vector2D((i % columns) * size * 1.25f + jitter(rng), floor - (i / columns + 1) * size);
+        def.width = def.height = size;
+        def.restitution = 0.0f;
+        world.createBody(def);
+    }
+}
+
+// Few collisions: circles drifting through a world ~100 times their density
+inline void sparse(PhysicsWorld& world, size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    const float side = std::sqrt(static_cast<float>(count) * 40000.0f);
+    std::uniform_real_distribution<float> pos(0.0f, side);
+    std::uniform_real_distribution<float> vel(-30.0f, 30.0f);
+
+    world.setGravity(Vector2D(0, 0));
+    for (size_t i = 0; i < count; ++i) {
+        BodyDef def;
+        def.position = Vector2D(pos(rng), pos(rng));
+        def.velocity = Vector2D(vel(rng), vel(rng));
+        def.radius = 3.0f;
+        world.createBody(def);
+    }
+}
+
+// Level geometry: 90% static boxes with circles falling through them
+inline void mostlyStatic(PhysicsWorld& world, size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    const float side = std::sqrt(static_cast<float>(count) * 400.0f);
+    std::uniform_real_distribution<float> pos(0.0f, side);
+    std::uniform_real_distribution<float> radius(2.0f, 4.0f);
+
+    world.setGravity(Vector2D(0, 98.0f));
+    for (size_t i = 0; i < count; ++i) {
+        BodyDef def;
+        def.position = Vector2D(pos(rng), pos(rng));
+        if (i % 10 != 0) {
+            def.shape = ShapeType::Rectangle;
+            def.width = def.height = 6.0f;
+            def.isStatic = true;
+        } else {
+            def.radius = radius(rng);
+        }
+        world.createBody(def);
+    }
+}
+
+} // namespace scenarios
+
+inline const Scenario allScenarios[] = {
+    {"rain", "circles falling onto the ground", scenarios::rain},
+    {"pile", "dense columns of boxes at rest", scenarios::pile},
+    {"sparse", "drifting circles, few contacts", scenarios::sparse},
+    {"static", "90% static boxes, falling circles", scenarios::mostlyStatic},
+};
+
+inline const Scenario* findScenario(const char* name) {
+    for (const Scenario& s : allScenarios) {
+        if (std::strcmp(s.name, name) == 0) return &s;
+    }
+    return nullptr;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <Physics/Vector2D.h>
+
+// Axis-aligned bounding box
+struct AABB {
+    Vector2D min;
+    Vector2D max;
+
+    AABB() = default;
+    AABB(Vector2D lo, Vector2D hi) : min(lo), max(hi) {}
+
+    // Touching boxes count as overlapping, like the narrowphase tests
+    bool overlaps(const AABB& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x &&
+               min.y <= other.max.y && max.y >= other.min.y;
+    }
+
+    bool contains(const AABB& other) const {
+        return min.x <= other.min.x && min.y <= other.min.y &&
+               max.x >= other.max.x && max.y >= other.max.y;
+    }
+
+    AABB merged(const AABB& other) const {
+        return AABB(Vector2D(std::min(min.x, other.min.x), std::min(min.y, other.min.y)),
+                    Vector2D(std::max(max.x, other.max.x), std::max(max.y, other.max.y)));
+    }
+
+    AABB fattened(float margin) const {
+        return AABB(Vector2D(min.x - margin, min.y - margin),
+                    Vector2D(max.x + margin, max.y + margin));
+    }
+
+    // Whether from + t * delta enters the box for some t in [0, maxFraction]
+    bool intersectsSegment(Vector2D from, Vector2D delta, float maxFraction) const {
+        float tmin = 0.0f, tmax = maxFraction;
+        const float lo[2] = {min.x, min.y}, hi[2] = {max.x, max.y};
+        const float origin[2] = {from.x, from.y}, dir[2] = {delta.x, delta.y};
+        for (int axis = 0; axis < 2; ++axis) {
+            if (dir[axis] == 0) {
+                if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+                continue;
+            }
+            const float inv = 1.0f / dir[axis];
+            float t1 = (lo[axis] - origin[axis]) * inv;
+            float t2 = (hi[axis] - origin[axis]) * inv;
+            if (t1 > t2) std::swap(t1, t2);
+            tmin = std::max(tmin, t1);
+            tmax = std::min(tmax, t2);
+            if (tmin > tmax) return false;
+        }
+        return true;
+    }
+
+    float perimeter() const {
+        return 2.0f * ((max.x - min.x) + (max.y - min.y));
+    }
+};
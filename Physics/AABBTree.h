@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <Physics/AABB.h>
+
+// Dynamic bounding volume tree. Leaves hold (usually fattened) boxes of user
+// objects, internal nodes the union of their children. Leaves are placed with
+// a perimeter cost heuristic and the tree is kept balanced with rotations, so
+// inserting, removing and querying are O(log n).
+class AABBTree {
+public:
+    static constexpr int32_t Null = -1;
+
+    int32_t insert(const AABB& box, uint32_t userData) {
+        const int32_t leaf = allocateNode();
+        nodes[leaf].box = box;
+        nodes[leaf].userData = userData;
+        nodes[leaf].height = 0;
+        insertLeaf(leaf);
+        return leaf;
+    }
+
+    void remove(int32_t proxy) {
+        removeLeaf(proxy);
+        freeNode(proxy);
+    }
+
+    // Give a leaf a new box; the leaf is re-inserted at the best spot for it
+    void update(int32_t proxy, const AABB& box) {
+        removeLeaf(proxy);
+        nodes[proxy].box = box;
+        insertLeaf(proxy);
+    }
+
+    const AABB& getBox(int32_t proxy) const { return nodes[proxy].box; }
+    uint32_t getUserData(int32_t proxy) const { return nodes[proxy].userData; }
+    int32_t getHeight() const { return root == Null ? 0 : nodes[root].height; }
+
+    void clear() {
+        nodes.clear();
+        root = Null;
+        freeList = Null;
+    }
+
+    // Calls callback(userData) for every leaf overlapping box. The callback
+    // returns false to stop the query early.
+    template <typename Callback>
+    void query(const AABB& box, Callback&& callback) const {
+        if (root == Null) return;
+        // A balanced tree of 2^32 leaves is far below this depth
+        int32_t stack[MaxDepth];
+        int32_t top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (!node.box.overlaps(box)) continue;
+            if (node.isLeaf()) {
+                if (!callback(node.userData)) return;
+            } else {
+                assert(top + 2 <= MaxDepth);
+                stack[top++] = node.child1;
+                stack[top++] = node.child2;
+            }
+        }
+    }
+
+    // Calls callback(userData) for every leaf whose box the segment
+    // from + t * (to - from), t in [0, maxFraction], enters. The callback
+    // returns the new maxFraction, so a closest-hit search clips the rest of
+    // the traversal; a negative value stops it.
+    template <typename Callback>
+    void raycast(Vector2D from, Vector2D to, float maxFraction, Callback&& callback) const {
+        if (root == Null) return;
+        const Vector2D delta = to - from;
+        int32_t stack[MaxDepth];
+        int32_t top = 0;
+        stack[top++] = root;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (!node.box.intersectsSegment(from, delta, maxFraction)) continue;
+            if (node.isLeaf()) {
+                const float clipped = callback(node.userData);
+                if (clipped < 0.0f) return;
+                maxFraction = std::min(maxFraction, clipped);
+            } else {
+                assert(top + 2 <= MaxDepth);
+                stack[top++] = node.child1;
+                stack[top++] = node.child2;
+            }
+        }
+    }
+
+    // raycast for a packet of up to 32 rays walked together: a node is loaded
+    // once for all rays of the packet and entered if any of them reaches it,
+    // so coherent rays share most of the traversal. Nodes away from the box
+    // around all segments are culled with one test for the whole packet.
+    // callback(ray, userData) returns the new maxFraction of that ray; a
+    // negative value ends that ray.
+    template <typename Callback>
+    void raycastPacket(const Vector2D* from, const Vector2D* to, uint32_t count, Callback&& callback) const {
+        assert(count <= 32);
+        if (root == Null || count == 0) return;
+        Vector2D delta[32];
+        float maxFraction[32];
+        AABB packetBox(from[0], from[0]);
+        for (uint32_t r = 0; r < count; ++r) {
+            delta[r] = to[r] - from[r];
+            maxFraction[r] = 1.0f;
+            packetBox = packetBox.merged(AABB(from[r], from[r])).merged(AABB(to[r], to[r]));
+        }
+
+        // Each stack entry carries the rays that reached its parent
+        struct Entry {
+            int32_t node;
+            uint32_t rays;
+        };
+        Entry stack[MaxDepth];
+        int32_t top = 0;
+        stack[top++] = {root, count == 32 ? ~0u : (1u << count) - 1};
+        while (top > 0) {
+            const Entry entry = stack[--top];
+            const Node& node = nodes[entry.node];
+            if (!node.box.overlaps(packetBox)) continue;
+            uint32_t rays = 0;
+            for (uint32_t mask = entry.rays; mask; mask &= mask - 1) {
+                const uint32_t r = static_cast<uint32_t>(__builtin_ctz(mask));
+                if (maxFraction[r] >= 0.0f && node.box.intersectsSegment(from[r], delta[r], maxFraction[r])) rays |= 1u << r;
+            }
+            if (!rays) continue;
+            if (node.isLeaf()) {
+                for (; rays; rays &= rays - 1) {
+                    const uint32_t r = static_cast<uint32_t>(__builtin_ctz(rays));
+                    const float clipped = callback(r, node.userData);
+                    maxFraction[r] = clipped < 0.0f ? -1.0f : std::min(maxFraction[r], clipped);
+                }
+            } else {
+                assert(top + 2 <= MaxDepth);
+                stack[top++] = {node.child1, rays};
+                stack[top++] = {node.child2, rays};
+            }
+        }
+    }
+
+private:
+    static constexpr int32_t MaxDepth = 256;
+
+    struct Node {
+        AABB box;
+        int32_t parent = Null; // next free node while on the free list
+        int32_t child1 = Null;
+        int32_t child2 = Null;
+        int32_t height = 0;    // leaf = 0, free = -1
+        uint32_t userData = 0;
+
+        bool isLeaf() const { return child1 == Null; }
+    };
+
+    int32_t allocateNode() {
+        if (freeList == Null) {
+            nodes.emplace_back();
+            return static_cast<int32_t>(nodes.size() - 1);
+        }
+        const int32_t id = freeList;
+        freeList = nodes[id].parent;
+        nodes[id] = Node();
+        return id;
+    }
+
+    void freeNode(int32_t id) {
+        nodes[id].parent = freeList;
+        nodes[id].height = -1;
+        freeList = id;
+    }
+
+    void insertLeaf(int32_t leaf) {
+        if (root == Null) {
+            root = leaf;
+            nodes[root].parent = Null;
+            return;
+        }
+
+        // Walk down to the sibling that makes the total perimeter grow least
+        const AABB leafBox = nodes[leaf].box;
+        int32_t index = root;
+        while (!nodes[index].isLeaf()) {
+            const Node& node = nodes[index];
+            const float area = node.box.perimeter();
+            const float combinedArea = node.box.merged(leafBox).perimeter();
+
+            // Cost of making a new parent for this node and the leaf
+            const float cost = 2.0f * combinedArea;
+            // Minimum cost of pushing the leaf further down
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+
+            const float cost1 = descendCost(node.child1, leafBox) + inheritanceCost;
+            const float cost2 = descendCost(node.child2, leafBox) + inheritanceCost;
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+        const int32_t sibling = index;
+
+        // New parent for the sibling and the leaf
+        const int32_t oldParent = nodes[sibling].parent;
+        const int32_t newParent = allocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = nodes[sibling].box.merged(leafBox);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        if (oldParent == Null) {
+            root = newParent;
+        } else if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        } else {
+            nodes[oldParent].child2 = newParent;
+        }
+
+        refit(nodes[leaf].parent);
+    }
+
+    float descendCost(int32_t child, const AABB& leafBox) const {
+        const AABB merged = leafBox.merged(nodes[child].box);
+        if (nodes[child].isLeaf()) return merged.perimeter();
+        return merged.perimeter() - nodes[child].box.perimeter();
+    }
+
+    void removeLeaf(int32_t leaf) {
+        if (leaf == root) {
+            root = Null;
+            return;
+        }
+
+        const int32_t parent = nodes[leaf].parent;
+        const int32_t grandParent = nodes[parent].parent;
+        const int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+        if (grandParent == Null) {
+            root = sibling;
+            nodes[sibling].parent = Null;
+            freeNode(parent);
+            return;
+        }
+
+        // Replace the parent with the sibling
+        if (nodes[grandParent].child1 == parent) {
+            nodes[grandParent].child1 = sibling;
+        } else {
+            nodes[grandParent].child2 = sibling;
+        }
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refit(grandParent);
+    }
+
+    // Rebalance and recompute boxes and heights from index up to the root
+    void refit(int32_t index) {
+        while (index != Null) {
+            index = balance(index);
+
+            Node& node = nodes[index];
+            const Node& c1 = nodes[node.child1];
+            const Node& c2 = nodes[node.child2];
+            node.height = 1 + std::max(c1.height, c2.height);
+            node.box = c1.box.merged(c2.box);
+
+            index = node.parent;
+        }
+    }
+
+    // Rotate the taller grandchild up when the children of a differ in height
+    // by more than one. Returns the index of the subtree root.
+    int32_t balance(int32_t a) {
+        Node& A = nodes[a];
+        if (A.isLeaf() || A.height < 2) return a;
+
+        const int32_t b = A.child1;
+        const int32_t c = A.child2;
+        const int32_t diff = nodes[c].height - nodes[b].height;
+
+        if (diff > 1) return rotate(a, c, b);
+        if (diff < -1) return rotate(a, b, c);
+        return a;
+    }
+
+    // Promote `up` (a child of a) above a; `other` is a's remaining child
+    int32_t rotate(int32_t a, int32_t up, int32_t other) {
+        Node& A = nodes[a];
+        Node& U = nodes[up];
+        const int32_t f = U.child1;
+        const int32_t g = U.child2;
+
+        // a's old position now belongs to up
+        U.child1 = a;
+        U.parent = A.parent;
+        A.parent = up;
+
+        if (U.parent == Null) {
+            root = up;
+        } else if (nodes[U.parent].child1 == a) {
+            nodes[U.parent].child1 = up;
+        } else {
+            nodes[U.parent].child2 = up;
+        }
+
+        // The taller grandchild stays under up, the shorter one moves under a
+        const bool fTaller = nodes[f].height > nodes[g].height;
+        const int32_t keep = fTaller ? f : g;
+        const int32_t move = fTaller ? g : f;
+
+        U.child2 = keep;
+        if (A.child1 == up) {
+            A.child1 = move;
+        } else {
+            A.child2 = move;
+        }
+        nodes[move].parent = a;
+
+        A.box = nodes[other].box.merged(nodes[move].box);
+        A.height = 1 + std::max(nodes[other].height, nodes[move].height);
+        U.box = A.box.merged(nodes[keep].box);
+        U.height = 1 + std::max(A.height, nodes[keep].height);
+        return up;
+    }
+
+    std::vector<Node> nodes;
+    int32_t root = Null;
+    int32_t freeList = Null;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <Physics/AABB.h>
+#include <Physics/Collision.h>
+#include <Physics/PhysicsBody.h>
+#include <Physics/Vector2D.h>
+
+// Stable reference to a body in a PhysicsWorld. Handles stay valid when the
+// storage reorders its columns; only the id -> index table changes.
+struct BodyHandle {
+    static constexpr uint32_t Invalid = 0xFFFFFFFFu;
+
+    uint32_t id = Invalid;
+
+    bool isValid() const { return id != Invalid; }
+    bool operator==(const BodyHandle& other) const { return id == other.id; }
+    bool operator!=(const BodyHandle& other) const { return id != other.id; }
+};
+
+// Bits of BodyStorage::flags
+enum BodyFlags : uint8_t {
+    BodyFlagStatic = 1 << 0,
+    BodyFlagSleeping = 1 << 1,   // at rest: not integrated, no pairs with other sleepers
+    BodyFlagBullet = 1 << 2,     // fast circle: swept against other bodies each step
+};
+
+// Which bodies collide. Two bodies in the same non-zero group always collide
+// (positive group) or never do (negative group); otherwise each one's mask
+// must accept the other's category bits.
+struct CollisionFilter {
+    uint16_t category = 1;
+    uint16_t mask = 0xFFFF;
+    int16_t group = 0;
+
+    bool operator==(const CollisionFilter& other) const {
+        return category == other.category && mask == other.mask && group == other.group;
+    }
+    bool operator!=(const CollisionFilter& other) const { return !(*this == other); }
+};
+
+inline bool shouldCollide(const CollisionFilter& a, const CollisionFilter& b) {
+    if (a.group == b.group && a.group != 0) return a.group > 0;
+    return (a.mask & b.category) && (b.mask & a.category);
+}
+
+// Everything needed to create a body
+struct BodyDef {
+    ShapeType shape = ShapeType::Circle;
+    Vector2D position;           // circle centre, rectangle top-left corner
+    Vector2D velocity;
+    float radius = 1.0f;         // circle
+    float width = 1.0f;          // rectangle
+    float height = 1.0f;         // rectangle
+    float mass = 1.0f;
+    float restitution = 0.8f;
+    bool isStatic = false;
+    bool bullet = false;         // continuous collision, circles only
+    CollisionFilter filter;
+};
+
+// Structure-of-arrays body storage: one contiguous column per attribute,
+// indexed by a dense body index, so per-body loops stream through memory
+// instead of chasing one heap allocation per body.
+class BodyStorage {
+public:
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<float> forceX, forceY;   // accumulated until the next step
+    std::vector<float> invMass;          // 0 for static bodies
+    std::vector<float> restitution;
+    std::vector<uint8_t> flags;          // BodyFlags
+    std::vector<ShapeType> shape;
+    std::vector<float> extentX, extentY; // circle: radius, 0; rectangle: width, height
+    std::vector<uint32_t> ids;           // handle id of each index
+    std::vector<float> sleepTime;        // seconds spent below the sleep tolerance
+    std::vector<uint32_t> sleepNext;     // handle id of the next body in the same sleeping island
+    std::vector<CollisionFilter> filter; // read as a whole for every candidate pair
+
+    size_t size() const { return ids.size(); }
+
+    BodyHandle add(const BodyDef& def) {
+        const uint32_t index = static_cast<uint32_t>(ids.size());
+        const uint32_t id = static_cast<uint32_t>(idToIndex.size());
+        idToIndex.push_back(index);
+
+        posX.push_back(def.position.x);
+        posY.push_back(def.position.y);
+        velX.push_back(def.velocity.x);
+        velY.push_back(def.velocity.y);
+        forceX.push_back(0.0f);
+        forceY.push_back(0.0f);
+        invMass.push_back(def.isStatic || def.mass <= 0 ? 0.0f : 1.0f / def.mass);
+        restitution.push_back(def.restitution);
+        flags.push_back((def.isStatic ? BodyFlagStatic : 0) |
+                        (def.bullet && !def.isStatic && def.shape == ShapeType::Circle ? BodyFlagBullet : 0));
+        shape.push_back(def.shape);
+        if (def.shape == ShapeType::Circle) {
+            extentX.push_back(def.radius);
+            extentY.push_back(0.0f);
+        } else {
+            extentX.push_back(def.width);
+            extentY.push_back(def.height);
+        }
+        ids.push_back(id);
+        sleepTime.push_back(0.0f);
+        sleepNext.push_back(id);
+        filter.push_back(def.filter);
+        return BodyHandle{id};
+    }
+
+    uint32_t indexOf(BodyHandle handle) const { return idToIndex[handle.id]; }
+    BodyHandle handleAt(uint32_t index) const { return BodyHandle{ids[index]}; }
+
+    bool isStatic(uint32_t index) const { return flags[index] & BodyFlagStatic; }
+    bool isSleeping(uint32_t index) const { return flags[index] & BodyFlagSleeping; }
+    bool isBullet(uint32_t index) const { return flags[index] & BodyFlagBullet; }
+
+    AABB bounds(uint32_t index) const {
+        if (shape[index] == ShapeType::Circle) {
+            const float r = extentX[index];
+            return AABB(Vector2D(posX[index] - r, posY[index] - r), Vector2D(posX[index] + r, posY[index] + r));
+        }
+        return AABB(Vector2D(posX[index], posY[index]),
+                    Vector2D(posX[index] + extentX[index], posY[index] + extentY[index]));
+    }
+
+    Vector2D centre(uint32_t index) const {
+        if (shape[index] == ShapeType::Circle) return Vector2D(posX[index], posY[index]);
+        return Vector2D(posX[index] + extentX[index] * 0.5f, posY[index] + extentY[index] * 0.5f);
+    }
+
+    Collider collider(uint32_t index) const {
+        return Collider{shape[index], Vector2D(posX[index], posY[index]), Vector2D(extentX[index], extentY[index])};
+    }
+
+    // Handle ids issued so far
+    size_t idCount() const { return idToIndex.size(); }
+
+    // Rebuild the id -> index table from ids after the columns were replaced
+    // wholesale, e.g. by a checkpoint restore
+    void rebuildIndex(size_t idCount) {
+        idToIndex.assign(idCount, BodyHandle::Invalid);
+        for (uint32_t i = 0; i < ids.size(); ++i) idToIndex[ids[i]] = i;
+    }
+
+    void reserve(size_t count) {
+        for (auto* column : {&posX, &posY, &velX, &velY, &forceX, &forceY, &invMass, &restitution, &extentX, &extentY, &sleepTime}) {
+            column->reserve(count);
+        }
+        flags.reserve(count);
+        shape.reserve(count);
+        ids.reserve(count);
+        sleepNext.reserve(count);
+        filter.reserve(count);
+        idToIndex.reserve(count);
+    }
+
+private:
+    std::vector<uint32_t> idToIndex; // handle id -> dense index
+};
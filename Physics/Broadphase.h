@@ -0,0 +1,577 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+#include <Physics/AABB.h>
+#include <Physics/AABBTree.h>
+#include <Shared/FunctionRef.h>
+#include <Shared/JobSystem.h>
+
+// Candidate pair produced by a broadphase, a < b are body indices
+struct BodyPair {
+    uint32_t a;
+    uint32_t b;
+
+    BodyPair(uint32_t i = 0, uint32_t j = 0) : a(i), b(j) {}
+
+    bool operator<(const BodyPair& other) const {
+        return a != other.a ? a < other.a : b < other.b;
+    }
+    bool operator==(const BodyPair& other) const {
+        return a == other.a && b == other.b;
+    }
+};
+
+// Spatial query callbacks, called with body indices. A QueryVisitor returns
+// false to stop the query. A RayVisitor returns the fraction of the ray still
+// worth searching, e.g. that of the closest hit so far; a negative value
+// stops the query.
+using QueryVisitor = RK::FunctionRef<bool(uint32_t)>;
+using RayVisitor = RK::FunctionRef<float(uint32_t)>;
+// Ray packets: visit(ray, body), ray indexing the packet
+using RayPacketVisitor = RK::FunctionRef<float(uint32_t, uint32_t)>;
+
+// Broadphase stage: turns body bounds into candidate pairs for the narrowphase.
+// statics[i] is non-zero for static (and sleeping) bodies; two of them never
+// collide so their pairs are not reported. Pairs are reported sorted and without
+// duplicates, so every implementation feeds the narrowphase in the same order
+// as the brute force loop.
+class Broadphase {
+public:
+    virtual ~Broadphase() = default;
+
+    virtual void findPairs(const std::vector<AABB>& bounds, const std::vector<uint8_t>& statics,
+                           std::vector<BodyPair>& pairs) = 0;
+
+    // Pool used for pair generation, nullptr runs on the calling thread
+    void setJobSystem(RK::JobSystem* jobSystem) { jobs = jobSystem; }
+
+    // Spatial queries over the bounds passed to the last findPairs call, which
+    // must still be alive. Only the indices [0, getIndexedCount()) are known.
+    // Queries do not modify the broadphase, so any number of threads may run
+    // them while no findPairs is running.
+    size_t getIndexedCount() const { return queryBounds ? queryBounds->size() : 0; }
+
+    // visit(i) once for every body whose bounds overlap box. The default scans
+    // all bounds.
+    virtual void query(const AABB& box, QueryVisitor visit) const {
+        if (!queryBounds) return;
+        for (uint32_t i = 0; i < queryBounds->size(); ++i) {
+            if ((*queryBounds)[i].overlaps(box) && !visit(i)) return;
+        }
+    }
+
+    // visit(i) for bodies whose bounds the segment from + t * (to - from),
+    // t in [0, clip], enters, where clip starts at 1 and is lowered by the
+    // visitor. A body may be visited more than once. The default scans all
+    // bounds.
+    virtual void queryRay(Vector2D from, Vector2D to, RayVisitor visit) const {
+        if (!queryBounds) return;
+        const Vector2D delta = to - from;
+        float clip = 1.0f;
+        for (uint32_t i = 0; i < queryBounds->size(); ++i) {
+            if (!(*queryBounds)[i].intersectsSegment(from, delta, clip)) continue;
+            clip = std::min(clip, visit(i));
+            if (clip < 0.0f) return;
+        }
+    }
+
+    // Up to RayPacketSize rays from[r] -> to[r] at once, each with the
+    // contract of queryRay. The default runs them one by one; structures that
+    // can share traversal between nearby rays override it.
+    static constexpr uint32_t RayPacketSize = 16;
+
+    virtual void queryRayPacket(const Vector2D* from, const Vector2D* to, uint32_t count,
+                                RayPacketVisitor visit) const {
+        for (uint32_t r = 0; r < count; ++r) {
+            queryRay(from[r], to[r], [&](uint32_t i) { return visit(r, i); });
+        }
+    }
+
+protected:
+    // Calls fn(begin, end, out) on fixed chunks of [0, count), in parallel when
+    // a job system is set, and appends the chunk outputs to pairs in chunk
+    // order. The result does not depend on the thread count.
+    template <typename Fn>
+    void collectPairs(size_t count, size_t grain, std::vector<BodyPair>& pairs, Fn&& fn) {
+        const size_t chunks = (count + grain - 1) / grain;
+        if (chunkPairs.size() < chunks) chunkPairs.resize(chunks);
+        auto run = [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                chunkPairs[c].clear();
+                fn(c * grain, std::min(count, (c + 1) * grain), chunkPairs[c]);
+            }
+        };
+        if (jobs) jobs->parallel_for(0, chunks, 1, run);
+        else run(0, chunks);
+
+        for (size_t c = 0; c < chunks; ++c) {
+            pairs.insert(pairs.end(), chunkPairs[c].begin(), chunkPairs[c].end());
+        }
+    }
+
+    RK::JobSystem* jobs = nullptr;
+    const std::vector<AABB>* queryBounds = nullptr; // set by findPairs
+
+private:
+    std::vector<std::vector<BodyPair>> chunkPairs;
+};
+
+// Tests every pair of bounds, O(n^2)
+class BruteForceBroadphase : public Broadphase {
+public:
+    void findPairs(const std::vector<AABB>& bounds, const std::vector<uint8_t>& statics,
+                   std::vector<BodyPair>& pairs) override {
+        queryBounds = &bounds;
+        pairs.clear();
+        const uint32_t count = static_cast<uint32_t>(bounds.size());
+        collectPairs(count, 64, pairs, [&](size_t begin, size_t end, std::vector<BodyPair>& out) {
+            for (uint32_t i = static_cast<uint32_t>(begin); i < end; ++i) {
+                for (uint32_t j = i + 1; j < count; ++j) {
+                    if (statics[i] && statics[j]) continue;
+                    if (bounds[i].overlaps(bounds[j])) {
+                        out.emplace_back(i, j);
+                    }
+                }
+            }
+        });
+    }
+};
+
+// Spatial hash over a uniform grid. Each body is inserted into every cell its
+// bounds touch, cells are bucketed with a counting sort and only bodies sharing
+// a cell are tested. Works best when cellSize is close to the typical body size.
+// Bodies covering more than MaxProxyCells cells, e.g. huge static bodies or
+// bounds broken by a NaN or infinite position, go to an oversize list instead
+// and are tested against every other body.
+class UniformGridBroadphase : public Broadphase {
+public:
+    static constexpr int64_t MaxProxyCells = 256;
+
+    explicit UniformGridBroadphase(float cellSize = 64.0f)
+        : cellSize(cellSize), invCellSize(1.0f / cellSize) {}
+
+    float getCellSize() const { return cellSize; }
+
+    void findPairs(const std::vector<AABB>& bounds, const std::vector<uint8_t>& statics,
+                   std::vector<BodyPair>& pairs) override {
+        queryBounds = &bounds;
+        pairs.clear();
+        entries.clear();
+        oversize.clear();
+        firstCell.resize(bounds.size());
+
+        // Insert bodies into the cells they cover
+        for (uint32_t i = 0; i < bounds.size(); ++i) {
+            const int32_t x0 = cellCoord(bounds[i].min.x), x1 = cellCoord(bounds[i].max.x);
+            const int32_t y0 = cellCoord(bounds[i].min.y), y1 = cellCoord(bounds[i].max.y);
+            firstCell[i] = Cell{x0, y0};
+            if (!std::isfinite(bounds[i].min.x) || !std::isfinite(bounds[i].min.y) ||
+                !std::isfinite(bounds[i].max.x) || !std::isfinite(bounds[i].max.y) ||
+                (int64_t(x1) - x0 + 1) * (int64_t(y1) - y0 + 1) > MaxProxyCells) {
+                oversize.push_back(i);
+                continue;
+            }
+            for (int32_t cy = y0; cy <= y1; ++cy) {
+                for (int32_t cx = x0; cx <= x1; ++cx) {
+                    entries.push_back(Entry{i, cx, cy});
+                }
+            }
+        }
+
+        // Counting sort of the entries into hash buckets
+        size_t tableSize = 16;
+        while (tableSize < entries.size() * 2) tableSize <<= 1;
+        const uint32_t mask = static_cast<uint32_t>(tableSize - 1);
+        tableMask = mask;
+
+        bucketStart.assign(tableSize + 1, 0);
+        for (const Entry& e : entries) {
+            ++bucketStart[(hashCell(e.cx, e.cy) & mask) + 1];
+        }
+        for (size_t b = 0; b < tableSize; ++b) {
+            bucketStart[b + 1] += bucketStart[b];
+        }
+        sorted.resize(entries.size());
+        cursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+        for (const Entry& e : entries) {
+            sorted[cursor[hashCell(e.cx, e.cy) & mask]++] = e;
+        }
+
+        // Test pairs inside each bucket
+        collectPairs(tableSize, 1024, pairs, [&](size_t first, size_t last, std::vector<BodyPair>& out) {
+            for (size_t b = first; b < last; ++b) {
+                const uint32_t begin = bucketStart[b], end = bucketStart[b + 1];
+                for (uint32_t i = begin; i < end; ++i) {
+                    const Entry& ea = sorted[i];
+                    for (uint32_t j = i + 1; j < end; ++j) {
+                        const Entry& eb = sorted[j];
+                        // Different cells hashed into the same bucket
+                        if (ea.cx != eb.cx || ea.cy != eb.cy || ea.body == eb.body) continue;
+                        if (statics[ea.body] && statics[eb.body]) continue;
+
+                        // Report the pair only from the first cell both bodies share
+                        const Cell& ca = firstCell[ea.body];
+                        const Cell& cb = firstCell[eb.body];
+                        if (ea.cx != std::max(ca.x, cb.x) || ea.cy != std::max(ca.y, cb.y)) continue;
+
+                        if (bounds[ea.body].overlaps(bounds[eb.body])) {
+                            out.emplace_back(std::min(ea.body, eb.body), std::max(ea.body, eb.body));
+                        }
+                    }
+                }
+            }
+        });
+
+        // Oversize bodies against everything, each oversize pair once
+        isOversize.assign(bounds.size(), 0);
+        for (uint32_t o : oversize) isOversize[o] = 1;
+        collectPairs(oversize.size(), 1, pairs, [&](size_t first, size_t last, std::vector<BodyPair>& out) {
+            for (size_t k = first; k < last; ++k) {
+                const uint32_t o = oversize[k];
+                for (uint32_t j = 0; j < bounds.size(); ++j) {
+                    if (j == o || (isOversize[j] && j < o)) continue;
+                    if (statics[o] && statics[j]) continue;
+                    if (bounds[o].overlaps(bounds[j])) out.emplace_back(std::min(o, j), std::max(o, j));
+                }
+            }
+        });
+
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    void query(const AABB& box, QueryVisitor visit) const override {
+        if (!queryBounds) return;
+        const int32_t x0 = cellCoord(box.min.x), x1 = cellCoord(box.max.x);
+        const int32_t y0 = cellCoord(box.min.y), y1 = cellCoord(box.max.y);
+        // A box over more cells than there are entries is cheaper to scan
+        if ((int64_t(x1) - x0 + 1) * (int64_t(y1) - y0 + 1) > int64_t(sorted.size())) {
+            Broadphase::query(box, visit);
+            return;
+        }
+        for (uint32_t o : oversize) {
+            if ((*queryBounds)[o].overlaps(box) && !visit(o)) return;
+        }
+        for (int32_t cy = y0; cy <= y1; ++cy) {
+            for (int32_t cx = x0; cx <= x1; ++cx) {
+                const uint32_t bucket = hashCell(cx, cy) & tableMask;
+                for (uint32_t i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i) {
+                    const Entry& e = sorted[i];
+                    if (e.cx != cx || e.cy != cy) continue;
+                    // Report each body from the first cell it shares with the box
+                    const Cell& first = firstCell[e.body];
+                    if (cx != std::max(first.x, x0) || cy != std::max(first.y, y0)) continue;
+                    if ((*queryBounds)[e.body].overlaps(box) && !visit(e.body)) return;
+                }
+            }
+        }
+    }
+
+    // Walks the cells along the ray in order (Amanatides-Woo) and stops at
+    // the first cell beyond the clip
+    void queryRay(Vector2D from, Vector2D to, RayVisitor visit) const override {
+        if (!queryBounds) return;
+        int32_t cx = cellCoord(from.x), cy = cellCoord(from.y);
+        const int64_t cells = std::abs(int64_t(cellCoord(to.x)) - cx) + std::abs(int64_t(cellCoord(to.y)) - cy) + 1;
+        if (cells > int64_t(sorted.size())) {
+            Broadphase::queryRay(from, to, visit);
+            return;
+        }
+
+        const Vector2D delta = to - from;
+        float clip = 1.0f;
+        for (uint32_t o : oversize) {
+            if (!(*queryBounds)[o].intersectsSegment(from, delta, clip)) continue;
+            clip = std::min(clip, visit(o));
+            if (clip < 0.0f) return;
+        }
+
+        const float inf = std::numeric_limits<float>::infinity();
+        const int32_t stepX = delta.x > 0 ? 1 : -1, stepY = delta.y > 0 ? 1 : -1;
+        float nextX = delta.x != 0 ? ((cx + (stepX > 0)) * cellSize - from.x) / delta.x : inf;
+        float nextY = delta.y != 0 ? ((cy + (stepY > 0)) * cellSize - from.y) / delta.y : inf;
+        const float stepTX = delta.x != 0 ? cellSize / std::abs(delta.x) : inf;
+        const float stepTY = delta.y != 0 ? cellSize / std::abs(delta.y) : inf;
+
+        float enter = 0.0f; // where the ray enters the current cell
+        for (int64_t n = 0; n < cells && enter <= clip; ++n) {
+            const uint32_t bucket = hashCell(cx, cy) & tableMask;
+            for (uint32_t i = bucketStart[bucket]; i < bucketStart[bucket + 1]; ++i) {
+                const Entry& e = sorted[i];
+                if (e.cx != cx || e.cy != cy) continue;
+                if (!(*queryBounds)[e.body].intersectsSegment(from, delta, clip)) continue;
+                clip = std::min(clip, visit(e.body));
+                if (clip < 0.0f) return;
+            }
+            if (nextX < nextY) {
+                enter = nextX;
+                nextX += stepTX;
+                cx += stepX;
+            } else {
+                enter = nextY;
+                nextY += stepTY;
+                cy += stepY;
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        uint32_t body;
+        int32_t cx, cy;
+    };
+    struct Cell {
+        int32_t x, y;
+    };
+
+    int32_t cellCoord(float v) const {
+        // Clamp so far away (or broken) coordinates cannot overflow the
+        // cast; NaN fails the first compare and lands on the upper bound
+        const float c = std::floor(v * invCellSize);
+        return c < 1.0e9f ? (c > -1.0e9f ? static_cast<int32_t>(c) : -1000000000) : 1000000000;
+    }
+
+    static uint32_t hashCell(int32_t cx, int32_t cy) {
+        return static_cast<uint32_t>(cx) * 73856093u ^ static_cast<uint32_t>(cy) * 19349663u;
+    }
+
+    float cellSize;
+    float invCellSize;
+    std::vector<Entry> entries;
+    std::vector<Entry> sorted;
+    std::vector<Cell> firstCell;
+    std::vector<uint32_t> oversize;  // bodies tested against everything
+    std::vector<uint8_t> isOversize;
+    std::vector<uint32_t> bucketStart;
+    std::vector<uint32_t> cursor;
+    uint32_t tableMask = 0;
+};
+
+// Sort and sweep along one axis. The sorted list of interval starts is kept
+// between steps: bodies move little per step, so an insertion sort over the
+// nearly sorted list costs close to O(n). Unlike the grid it does not care how
+// much body sizes vary.
+class SweepAndPruneBroadphase : public Broadphase {
+public:
+    enum class Axis { X, Y };
+
+    explicit SweepAndPruneBroadphase(Axis axis = Axis::X) : axis(axis) {}
+
+    void findPairs(const std::vector<AABB>& bounds, const std::vector<uint8_t>& statics,
+                   std::vector<BodyPair>& pairs) override {
+        queryBounds = &bounds;
+        pairs.clear();
+        const uint32_t count = static_cast<uint32_t>(bounds.size());
+
+        if (count < endpoints.size()) {
+            endpoints.clear();
+        }
+
+        // Refresh the intervals in their current (last step's) order
+        for (Endpoint& e : endpoints) {
+            e = makeEndpoint(bounds[e.body], e.body);
+        }
+
+        // New bodies go to the back. When many arrive at once a full sort is
+        // cheaper than inserting them one by one.
+        const size_t previous = endpoints.size();
+        for (uint32_t i = static_cast<uint32_t>(previous); i < count; ++i) {
+            endpoints.push_back(makeEndpoint(bounds[i], i));
+        }
+        if (count - previous > previous / 4) {
+            std::sort(endpoints.begin(), endpoints.end(),
+                      [](const Endpoint& l, const Endpoint& r) { return l.min < r.min; });
+        } else {
+            insertionSort();
+        }
+
+        // Sweep: only intervals starting before the current one ends can overlap
+        collectPairs(endpoints.size(), 256, pairs, [&](size_t begin, size_t end, std::vector<BodyPair>& out) {
+            for (size_t i = begin; i < end; ++i) {
+                const Endpoint& ei = endpoints[i];
+                for (size_t j = i + 1; j < endpoints.size() && endpoints[j].min <= ei.max; ++j) {
+                    const Endpoint& ej = endpoints[j];
+                    if (statics[ei.body] && statics[ej.body]) continue;
+                    if (ei.crossMin <= ej.crossMax && ei.crossMax >= ej.crossMin) {
+                        out.emplace_back(std::min(ei.body, ej.body), std::max(ei.body, ej.body));
+                    }
+                }
+            }
+        });
+
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    void query(const AABB& box, QueryVisitor visit) const override {
+        const Endpoint q = makeEndpoint(box, 0);
+        // Intervals starting beyond the box cannot overlap it
+        const auto last = std::upper_bound(endpoints.begin(), endpoints.end(), q.max,
+                                           [](float v, const Endpoint& e) { return v < e.min; });
+        for (auto it = endpoints.begin(); it != last; ++it) {
+            if (it->max >= q.min && it->crossMin <= q.crossMax && it->crossMax >= q.crossMin && !visit(it->body)) return;
+        }
+    }
+
+    // Candidates from the box around the segment
+    void queryRay(Vector2D from, Vector2D to, RayVisitor visit) const override {
+        if (!queryBounds) return;
+        const Vector2D delta = to - from;
+        const AABB box(Vector2D(std::min(from.x, to.x), std::min(from.y, to.y)),
+                       Vector2D(std::max(from.x, to.x), std::max(from.y, to.y)));
+        float clip = 1.0f;
+        query(box, [&](uint32_t i) {
+            if ((*queryBounds)[i].intersectsSegment(from, delta, clip)) clip = std::min(clip, visit(i));
+            return clip >= 0.0f;
+        });
+    }
+
+private:
+    // Interval on the sweep axis plus the cross axis, so the sweep never has
+    // to leave the sorted array
+    struct Endpoint {
+        float min;
+        float max;
+        float crossMin;
+        float crossMax;
+        uint32_t body;
+    };
+
+    Endpoint makeEndpoint(const AABB& box, uint32_t body) const {
+        if (axis == Axis::X) return Endpoint{box.min.x, box.max.x, box.min.y, box.max.y, body};
+        return Endpoint{box.min.y, box.max.y, box.min.x, box.max.x, body};
+    }
+
+    void insertionSort() {
+        for (size_t i = 1; i < endpoints.size(); ++i) {
+            Endpoint key = endpoints[i];
+            size_t j = i;
+            while (j > 0 && endpoints[j - 1].min > key.min) {
+                endpoints[j] = endpoints[j - 1];
+                --j;
+            }
+            endpoints[j] = key;
+        }
+    }
+
+    Axis axis;
+    std::vector<Endpoint> endpoints; // sorted by min along the axis
+};
+
+// Broadphase over a dynamic AABB tree. Every body has a fattened box in the
+// tree and is only re-inserted when its bounds leave that box. Candidate pairs
+// persist between steps: only bodies that were re-inserted query the tree, so
+// bodies at rest (and static bodies, which are never fattened) cost almost
+// nothing. The tree doubles as an index for spatial queries.
+class DynamicTreeBroadphase : public Broadphase {
+public:
+    explicit DynamicTreeBroadphase(float margin = 4.0f) : margin(margin) {}
+
+    const AABBTree& getTree() const { return tree; }
+
+    // The tree holds fat boxes; candidates are checked against the bounds
+    void query(const AABB& box, QueryVisitor visit) const override {
+        if (!queryBounds) return;
+        tree.query(box, [&](uint32_t i) { return !(*queryBounds)[i].overlaps(box) || visit(i); });
+    }
+
+    void queryRay(Vector2D from, Vector2D to, RayVisitor visit) const override {
+        if (!queryBounds) return;
+        const Vector2D delta = to - from;
+        float clip = 1.0f;
+        tree.raycast(from, to, clip, [&](uint32_t i) {
+            if ((*queryBounds)[i].intersectsSegment(from, delta, clip)) clip = std::min(clip, visit(i));
+            return clip;
+        });
+    }
+
+    void queryRayPacket(const Vector2D* from, const Vector2D* to, uint32_t count,
+                        RayPacketVisitor visit) const override {
+        if (!queryBounds) return;
+        float clip[RayPacketSize];
+        std::fill(clip, clip + count, 1.0f);
+        tree.raycastPacket(from, to, count, [&](uint32_t r, uint32_t i) {
+            if ((*queryBounds)[i].intersectsSegment(from[r], to[r] - from[r], clip[r])) clip[r] = std::min(clip[r], visit(r, i));
+            return clip[r];
+        });
+    }
+
+    void findPairs(const std::vector<AABB>& bounds, const std::vector<uint8_t>& statics,
+                   std::vector<BodyPair>& pairs) override {
+        queryBounds = &bounds;
+        const uint32_t count = static_cast<uint32_t>(bounds.size());
+        if (count < proxies.size()) {
+            tree.clear();
+            proxies.clear();
+            lastStatics.clear();
+            fatPairs.clear();
+        }
+
+        // Re-insert bodies that left their fat box or whose static flag changed
+        // (a body falling asleep or waking up), insert new ones
+        moved.assign(count, 0);
+        movedList.clear();
+        for (uint32_t i = 0; i < count; ++i) {
+            if (i < proxies.size()) {
+                if (statics[i] == lastStatics[i] && tree.getBox(proxies[i]).contains(bounds[i])) continue;
+                tree.update(proxies[i], fatten(bounds[i], statics[i]));
+                lastStatics[i] = statics[i];
+            } else {
+                proxies.push_back(tree.insert(fatten(bounds[i], statics[i]), i));
+                lastStatics.push_back(statics[i]);
+            }
+            moved[i] = 1;
+            movedList.push_back(i);
+        }
+
+        // Pairs between bodies that kept their fat boxes still overlap. The
+        // others are found again by the queries below.
+        fatPairs.erase(std::remove_if(fatPairs.begin(), fatPairs.end(),
+                                      [this](const BodyPair& p) { return moved[p.a] || moved[p.b]; }),
+                       fatPairs.end());
+
+        newPairs.clear();
+        collectPairs(movedList.size(), 128, newPairs, [&](size_t begin, size_t end, std::vector<BodyPair>& out) {
+            for (size_t m = begin; m < end; ++m) {
+                const uint32_t i = movedList[m];
+                tree.query(tree.getBox(proxies[i]), [&](uint32_t j) {
+                    // Two moved bodies: report from the lower index only
+                    if (j == i || (moved[j] && j < i)) return true;
+                    if (statics[i] && statics[j]) return true;
+                    out.emplace_back(std::min(i, j), std::max(i, j));
+                    return true;
+                });
+            }
+        });
+        std::sort(newPairs.begin(), newPairs.end());
+
+        merged.clear();
+        std::merge(fatPairs.begin(), fatPairs.end(), newPairs.begin(), newPairs.end(),
+                   std::back_inserter(merged));
+        fatPairs.swap(merged);
+
+        // Candidates are the persistent pairs whose tight bounds overlap
+        pairs.clear();
+        for (const BodyPair& p : fatPairs) {
+            if (bounds[p.a].overlaps(bounds[p.b])) pairs.push_back(p);
+        }
+    }
+
+private:
+    AABB fatten(const AABB& box, uint8_t isStatic) const {
+        return isStatic ? box : box.fattened(margin);
+    }
+
+    float margin;
+    AABBTree tree;
+    std::vector<int32_t> proxies;    // tree leaf per body index
+    std::vector<uint8_t> lastStatics; // statics flag each leaf was inserted with
+    std::vector<BodyPair> fatPairs;  // pairs whose fat boxes overlap, sorted
+    std::vector<BodyPair> newPairs;
+    std::vector<BodyPair> merged;
+    std::vector<uint8_t> moved;
+    std::vector<uint32_t> movedList;
+};
@@ -0,0 +1,267 @@
+#include <Physics/Checkpoint.h>
+#include <Physics/PhysicsWorld.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(sizeof(ShapeType) == 1, "shape column is stored as bytes");
+static_assert(sizeof(CollisionFilter) == 6, "filter column is stored as 6 byte records");
+
+namespace {
+
+constexpr uint32_t SectionCount = static_cast<uint32_t>(CheckpointSection::Count);
+
+// Entries and entry size of each section
+struct SectionSize {
+    uint64_t count;
+    uint64_t elementBytes;
+};
+
+SectionSize sectionSize(const CheckpointHeader& h, uint32_t section) {
+    switch (static_cast<CheckpointSection>(section)) {
+    case CheckpointSection::Flags:
+    case CheckpointSection::Shape:
+        return {h.bodyCount, 1};
+    case CheckpointSection::Filter:
+        return {h.bodyCount, sizeof(CollisionFilter)};
+    case CheckpointSection::PreviousX:
+    case CheckpointSection::PreviousY:
+        return {h.previousCount, 4};
+    case CheckpointSection::CacheKeys:
+        return {h.cachedImpulses, 8};
+    case CheckpointSection::CacheImpulses:
+    case CheckpointSection::CacheApproach:
+        return {h.cachedImpulses, 4};
+    default:
+        return {h.bodyCount, 4};
+    }
+}
+
+uint64_t alignUp(uint64_t value) {
+    return (value + CheckpointAlignment - 1) & ~(CheckpointAlignment - 1);
+}
+
+// Fills in the section offsets and the file size
+void layOut(CheckpointHeader& h) {
+    uint64_t offset = alignUp(sizeof(CheckpointHeader));
+    for (uint32_t s = 0; s < SectionCount; ++s) {
+        const SectionSize size = sectionSize(h, s);
+        h.sections[s] = offset;
+        offset = alignUp(offset + size.count * size.elementBytes);
+    }
+    h.fileBytes = offset;
+}
+
+bool validate(const CheckpointHeader& h, uint64_t fileBytes) {
+    if (std::memcmp(h.magic, CheckpointMagic, sizeof(h.magic)) != 0) return false;
+    if (h.version != CheckpointVersion || h.headerBytes != sizeof(CheckpointHeader)) return false;
+    if (h.fileBytes != fileBytes || h.idCount < h.bodyCount) return false;
+    if (h.previousCount > h.bodyCount) return false;
+    for (uint32_t s = 0; s < SectionCount; ++s) {
+        const SectionSize size = sectionSize(h, s);
+        if (h.sections[s] % CheckpointAlignment != 0) return false;
+        // Counts come from the file: compare without sums that could wrap
+        if (h.sections[s] > fileBytes || size.count * size.elementBytes > fileBytes - h.sections[s]) return false;
+    }
+    return true;
+}
+
+template <typename T>
+const T* sectionData(const std::byte* file, const CheckpointHeader& h, CheckpointSection section) {
+    return reinterpret_cast<const T*>(file + h.sections[static_cast<uint32_t>(section)]);
+}
+
+template <typename T>
+void readColumn(const std::byte* file, const CheckpointHeader& h, CheckpointSection section, std::vector<T>& column) {
+    const T* first = sectionData<T>(file, h, section);
+    column.assign(first, first + sectionSize(h, static_cast<uint32_t>(section)).count);
+}
+
+} // namespace
+
+bool PhysicsWorld::saveCheckpoint(const char* path) const {
+    CheckpointHeader h{};
+    std::memcpy(h.magic, CheckpointMagic, sizeof(h.magic));
+    h.version = CheckpointVersion;
+    h.headerBytes = sizeof(CheckpointHeader);
+    h.bodyCount = static_cast<uint32_t>(storage.size());
+    h.idCount = static_cast<uint32_t>(storage.idCount());
+    h.previousCount = static_cast<uint32_t>(std::min(previousX.size(), storage.size()));
+    h.cachedImpulses = static_cast<uint32_t>(solver.getCache().size());
+    h.gravityX = gravity.x;
+    h.gravityY = gravity.y;
+    h.accumulator = accumulator;
+    h.fixedDt = timeStep.fixedDt;
+    h.substeps = timeStep.substeps;
+    h.maxStepsPerCall = timeStep.maxStepsPerCall;
+    layOut(h);
+
+    std::vector<uint64_t> cacheKeys;
+    std::vector<float> cacheImpulses;
+    std::vector<float> cacheApproach;
+    for (const ContactSolver::CachedImpulse& c : solver.getCache()) {
+        cacheKeys.push_back(c.key);
+        cacheImpulses.push_back(c.normalImpulse);
+        cacheApproach.push_back(c.approach);
+    }
+
+    // In CheckpointSection order
+    const void* columns[SectionCount] = {
+        storage.posX.data(), storage.posY.data(),
+        storage.velX.data(), storage.velY.data(),
+        storage.forceX.data(), storage.forceY.data(),
+        storage.invMass.data(),
+        storage.restitution.data(),
+        storage.flags.data(),
+        storage.shape.data(),
+        storage.extentX.data(), storage.extentY.data(),
+        storage.ids.data(),
+        storage.sleepTime.data(),
+        storage.sleepNext.data(),
+        storage.filter.data(),
+        previousX.data(), previousY.data(),
+        cacheKeys.data(),
+        cacheImpulses.data(),
+        cacheApproach.data(),
+    };
+
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    static const char padding[CheckpointAlignment] = {};
+    bool ok = std::fwrite(&h, sizeof(h), 1, file) == 1;
+    uint64_t written = sizeof(h);
+    for (uint32_t s = 0; s < SectionCount && ok; ++s) {
+        const SectionSize size = sectionSize(h, s);
+        ok = std::fwrite(padding, 1, h.sections[s] - written, file) == h.sections[s] - written;
+        const uint64_t bytes = size.count * size.elementBytes;
+        if (ok && bytes > 0) ok = std::fwrite(columns[s], 1, bytes, file) == bytes;
+        written = h.sections[s] + bytes;
+    }
+    if (ok) ok = std::fwrite(padding, 1, h.fileBytes - written, file) == h.fileBytes - written;
+    return std::fclose(file) == 0 && ok;
+}
+
+bool PhysicsWorld::loadCheckpoint(const char* path) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < sizeof(CheckpointHeader)) {
+        close(fd);
+        return false;
+    }
+    const uint64_t fileBytes = static_cast<uint64_t>(info.st_size);
+    void* mapped = mmap(nullptr, fileBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, fileBytes, MADV_SEQUENTIAL);
+
+    const std::byte* file = static_cast<const std::byte*>(mapped);
+    CheckpointHeader h;
+    std::memcpy(&h, file, sizeof(h));
+    bool ok = validate(h, fileBytes);
+    if (ok) {
+        // Everything indexing by id or shape must be in range before any of
+        // the world is replaced
+        const uint32_t* ids = sectionData<uint32_t>(file, h, CheckpointSection::Ids);
+        const uint32_t* sleepNext = sectionData<uint32_t>(file, h, CheckpointSection::SleepNext);
+        const uint8_t* shapes = sectionData<uint8_t>(file, h, CheckpointSection::Shape);
+        for (uint32_t i = 0; i < h.bodyCount && ok; ++i) {
+            ok = ids[i] < h.idCount && shapes[i] < static_cast<uint8_t>(ShapeType::Count);
+        }
+        // Every id names one body, and every sleeping ring link a live one
+        std::vector<uint32_t> indexOf(ok ? h.idCount : 0, BodyHandle::Invalid);
+        for (uint32_t i = 0; i < h.bodyCount && ok; ++i) {
+            ok = indexOf[ids[i]] == BodyHandle::Invalid;
+            indexOf[ids[i]] = i;
+        }
+        for (uint32_t i = 0; i < h.bodyCount && ok; ++i) {
+            ok = sleepNext[i] < h.idCount && indexOf[sleepNext[i]] != BodyHandle::Invalid;
+        }
+        // Awake bodies link to themselves, and each sleeping ring closes
+        // through sleeping dynamic bodies only, or waking it would not end
+        const uint8_t* flags = sectionData<uint8_t>(file, h, CheckpointSection::Flags);
+        const auto sleeping = [flags](uint32_t i) {
+            return (flags[i] & (BodyFlagStatic | BodyFlagSleeping)) == BodyFlagSleeping;
+        };
+        std::vector<bool> inRing(ok ? h.bodyCount : 0);
+        for (uint32_t i = 0; i < h.bodyCount && ok; ++i) {
+            if (!(flags[i] & BodyFlagSleeping)) {
+                ok = sleepNext[i] == ids[i];
+                continue;
+            }
+            if (inRing[i]) continue;
+            uint32_t j = i;
+            do {
+                ok = sleeping(j) && !inRing[j];
+                inRing[j] = true;
+                j = indexOf[sleepNext[j]];
+            } while (ok && j != i);
+        }
+    }
+    if (!ok) {
+        munmap(mapped, fileBytes);
+        return false;
+    }
+
+    readColumn(file, h, CheckpointSection::PosX, storage.posX);
+    readColumn(file, h, CheckpointSection::PosY, storage.posY);
+    readColumn(file, h, CheckpointSection::VelX, storage.velX);
+    readColumn(file, h, CheckpointSection::VelY, storage.velY);
+    readColumn(file, h, CheckpointSection::ForceX, storage.forceX);
+    readColumn(file, h, CheckpointSection::ForceY, storage.forceY);
+    readColumn(file, h, CheckpointSection::InvMass, storage.invMass);
+    readColumn(file, h, CheckpointSection::Restitution, storage.restitution);
+    readColumn(file, h, CheckpointSection::Flags, storage.flags);
+    readColumn(file, h, CheckpointSection::Shape, storage.shape);
+    readColumn(file, h, CheckpointSection::ExtentX, storage.extentX);
+    readColumn(file, h, CheckpointSection::ExtentY, storage.extentY);
+    readColumn(file, h, CheckpointSection::Ids, storage.ids);
+    readColumn(file, h, CheckpointSection::SleepTime, storage.sleepTime);
+    readColumn(file, h, CheckpointSection::SleepNext, storage.sleepNext);
+    readColumn(file, h, CheckpointSection::Filter, storage.filter);
+    readColumn(file, h, CheckpointSection::PreviousX, previousX);
+    readColumn(file, h, CheckpointSection::PreviousY, previousY);
+    storage.rebuildIndex(h.idCount);
+    islands.rebuildCounts(storage);
+    // The broadphase knows none of the restored bodies until the next update
+    bounds.clear();
+    clearMoved();
+    moved.clear();
+    indexedBodies = 0;
+    staticTree.clear();
+    staticBounds.clear();
+    staticBodies.clear();
+    staticsDirty = true;
+    dynamicBodies.clear();
+    dynamicSlot.clear();
+    for (uint32_t i = 0; i < storage.size(); ++i) {
+        dynamicSlot.push_back(storage.isStatic(i) ? NotDynamic : static_cast<uint32_t>(dynamicBodies.size()));
+        if (!storage.isStatic(i)) dynamicBodies.push_back(i);
+    }
+
+    const uint64_t* keys = sectionData<uint64_t>(file, h, CheckpointSection::CacheKeys);
+    const float* impulses = sectionData<float>(file, h, CheckpointSection::CacheImpulses);
+    const float* approach = sectionData<float>(file, h, CheckpointSection::CacheApproach);
+    std::vector<ContactSolver::CachedImpulse> cache(h.cachedImpulses);
+    for (uint32_t i = 0; i < h.cachedImpulses; ++i) cache[i] = {keys[i], impulses[i], approach[i]};
+    solver.setCache(cache.data(), cache.size());
+    munmap(mapped, fileBytes);
+
+    gravity = Vector2D(h.gravityX, h.gravityY);
+    accumulator = h.accumulator;
+    timeStep.fixedDt = h.fixedDt;
+    timeStep.substeps = h.substeps;
+    timeStep.maxStepsPerCall = h.maxStepsPerCall;
+    bulletCount = 0;
+    filteredCount = 0;
+    for (uint32_t i = 0; i < storage.size(); ++i) {
+        if (storage.isBullet(i)) ++bulletCount;
+        if (storage.filter[i] != CollisionFilter()) ++filteredCount;
+    }
+    contactTracker.clear();
+    return true;
+}
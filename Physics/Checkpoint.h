@@ -0,0 +1,55 @@
+#pragma once
+
+// Binary checkpoint format of a PhysicsWorld.
+//
+// A fixed header followed by one section per column. Sections are raw little
+// endian arrays in storage order, each starting on a 64 byte boundary, so a
+// restore maps the file and copies every column in one go instead of parsing
+// it. Sizes follow from the counts in the header. Readers reject any other
+// version; a new field means a new version.
+
+#include <cstdint>
+
+constexpr char CheckpointMagic[8] = {'R', 'K', 'P', 'H', 'Y', 'S', 'C', 'K'};
+constexpr uint32_t CheckpointVersion = 3;
+constexpr uint64_t CheckpointAlignment = 64;
+
+enum class CheckpointSection : uint32_t {
+    PosX, PosY,
+    VelX, VelY,
+    ForceX, ForceY,
+    InvMass,
+    Restitution,
+    Flags,
+    Shape,
+    ExtentX, ExtentY,
+    Ids,
+    SleepTime,
+    SleepNext,
+    Filter,                 // CollisionFilter, 6 bytes each
+    PreviousX, PreviousY,   // previousCount entries, interpolation source
+    CacheKeys,              // cachedImpulses entries, solver warm start
+    CacheImpulses,
+    CacheApproach,          // closing speeds of contacts not yet bounced
+    Count
+};
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;           // sizeof(CheckpointHeader)
+    uint64_t fileBytes;             // whole file, to catch truncation
+
+    uint32_t bodyCount;
+    uint32_t idCount;               // handle ids issued, at least bodyCount
+    uint32_t previousCount;         // bodies with a position before the last advance() step
+    uint32_t cachedImpulses;
+
+    float gravityX, gravityY;
+    float accumulator;              // unsimulated time of advance()
+    float fixedDt;
+    int32_t substeps;
+    int32_t maxStepsPerCall;
+
+    uint64_t sections[static_cast<uint32_t>(CheckpointSection::Count)]; // byte offsets
+};
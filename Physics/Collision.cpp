@@ -0,0 +1,236 @@
+#include <Physics/Collision.h>
+#include <Physics/Circle.h>
+#include <Physics/Rectangle.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+bool circleCircle(const Collider& a, const Collider& b, Contact& contact) {
+    Vector2D diff = a.position - b.position;
+    float distSq = diff.dot(diff);
+    float radSum = a.extent.x + b.extent.x;
+    if (distSq > radSum * radSum) return false;
+
+    float dist = std::sqrt(distSq);
+    // Concentric circles: any direction separates them
+    contact.normal = dist > 0 ? diff * (1.0f / dist) : Vector2D(0, -1);
+    contact.depth = radSum - dist;
+    return true;
+}
+
+bool circleRectangle(const Collider& circle, const Collider& rect, Contact& contact) {
+    const Vector2D& c = circle.position;
+    const float radius = circle.extent.x;
+    const float left = rect.position.x, right = rect.position.x + rect.extent.x;
+    const float top = rect.position.y, bottom = rect.position.y + rect.extent.y;
+
+    // Closest point of the rectangle to the circle centre
+    Vector2D closest(std::clamp(c.x, left, right), std::clamp(c.y, top, bottom));
+    Vector2D diff = c - closest;
+    float distSq = diff.dot(diff);
+    if (distSq > radius * radius) return false;
+
+    if (distSq > 0) {
+        float dist = std::sqrt(distSq);
+        contact.normal = diff * (1.0f / dist);
+        contact.depth = radius - dist;
+        return true;
+    }
+
+    // Centre inside the rectangle: leave through the nearest edge
+    const float dl = c.x - left, dr = right - c.x;
+    const float dt = c.y - top, db = bottom - c.y;
+    const float nearest = std::min(std::min(dl, dr), std::min(dt, db));
+    if (nearest == dl) contact.normal = Vector2D(-1, 0);
+    else if (nearest == dr) contact.normal = Vector2D(1, 0);
+    else if (nearest == dt) contact.normal = Vector2D(0, -1);
+    else contact.normal = Vector2D(0, 1);
+    contact.depth = radius + nearest;
+    return true;
+}
+
+bool rectangleCircle(const Collider& a, const Collider& b, Contact& contact) {
+    if (!circleRectangle(b, a, contact)) return false;
+    contact.normal = contact.normal * -1.0f;
+    return true;
+}
+
+bool rectangleRectangle(const Collider& a, const Collider& b, Contact& contact) {
+    Vector2D center1 = a.position + a.extent * 0.5f;
+    Vector2D center2 = b.position + b.extent * 0.5f;
+
+    Vector2D diff = center1 - center2;
+    float overlapX = (a.extent.x + b.extent.x) * 0.5f - std::abs(diff.x);
+    float overlapY = (a.extent.y + b.extent.y) * 0.5f - std::abs(diff.y);
+    if (overlapX <= 0 || overlapY <= 0) return false;
+
+    // Separate along the axis of least overlap
+    if (overlapX < overlapY) {
+        contact.normal = Vector2D(diff.x > 0 ? 1 : -1, 0);
+        contact.depth = overlapX;
+    } else {
+        contact.normal = Vector2D(0, diff.y > 0 ? 1 : -1);
+        contact.depth = overlapY;
+    }
+    return true;
+}
+
+// Smallest t in [0, 1] at which origin + t * motion reaches the circle, for an
+// origin outside it
+bool rayCircle(Vector2D origin, Vector2D motion, Vector2D centre, float radius, float& t) {
+    const Vector2D m = origin - centre;
+    const float c = m.dot(m) - radius * radius;
+    const float b = m.dot(motion);
+    if (c <= 0 || b >= 0) return false; // inside, or moving away
+    const float a = motion.dot(motion);
+    const float disc = b * b - a * c;
+    if (disc < 0) return false;
+    t = (-b - std::sqrt(disc)) / a;
+    return t <= 1;
+}
+
+bool sweepCircleCircle(const Collider& circle, Vector2D motion, const Collider& target, float& toi) {
+    return rayCircle(circle.position, motion, target.position, circle.extent.x + target.extent.x, toi);
+}
+
+// The circle centre against the rectangle grown by the radius: a box with
+// rounded corners
+bool sweepCircleRectangle(const Collider& circle, Vector2D motion, const Collider& target, float& toi) {
+    const Vector2D& o = circle.position;
+    const float r = circle.extent.x;
+    const float left = target.position.x, right = target.position.x + target.extent.x;
+    const float top = target.position.y, bottom = target.position.y + target.extent.y;
+
+    const Vector2D closest(std::clamp(o.x, left, right), std::clamp(o.y, top, bottom));
+    if ((o - closest).dot(o - closest) <= r * r) return false;
+
+    // Slabs of the box grown by r on every side
+    float tmin = 0.0f, tmax = 1.0f;
+    const float lo[2] = {left - r, top - r};
+    const float hi[2] = {right + r, bottom + r};
+    const float origin[2] = {o.x, o.y};
+    const float dir[2] = {motion.x, motion.y};
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dir[axis] == 0) {
+            if (origin[axis] < lo[axis] || origin[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t1 = (lo[axis] - origin[axis]) / dir[axis];
+        float t2 = (hi[axis] - origin[axis]) / dir[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        tmin = std::max(tmin, t1);
+        tmax = std::min(tmax, t2);
+        if (tmin > tmax) return false;
+    }
+
+    // Entering through a face of the grown box hits the rectangle there
+    const Vector2D p = o + motion * tmin;
+    if ((p.x >= left && p.x <= right) || (p.y >= top && p.y <= bottom)) {
+        toi = tmin;
+        return true;
+    }
+
+    // Entering through a corner square: only the rounded corner can be hit,
+    // reaching a face from there means passing through the corner first
+    const Vector2D corner(p.x < left ? left : right, p.y < top ? top : bottom);
+    return rayCircle(o, motion, corner, r, toi);
+}
+
+} // namespace
+
+bool timeOfImpact(const Collider& circle, Vector2D motion, const Collider& target, float& toi) {
+    if (target.type == ShapeType::Circle) return sweepCircleCircle(circle, motion, target, toi);
+    return sweepCircleRectangle(circle, motion, target, toi);
+}
+
+bool raycast(const Collider& shape, Vector2D origin, Vector2D delta, float& fraction, Vector2D& normal) {
+    if (shape.type == ShapeType::Circle) {
+        const float r = shape.extent.x;
+        const Vector2D m = origin - shape.position;
+        if (m.dot(m) <= r * r) {
+            fraction = 0.0f;
+            normal = Vector2D();
+            return true;
+        }
+        if (!rayCircle(origin, delta, shape.position, r, fraction)) return false;
+        normal = (origin + delta * fraction - shape.position) * (1.0f / r);
+        return true;
+    }
+
+    // Slabs; the axis entered last is the face that is hit
+    const float lo[2] = {shape.position.x, shape.position.y};
+    const float hi[2] = {shape.position.x + shape.extent.x, shape.position.y + shape.extent.y};
+    const float o[2] = {origin.x, origin.y};
+    const float dir[2] = {delta.x, delta.y};
+    float tmin = 0.0f, tmax = 1.0f;
+    int hitAxis = -1;
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dir[axis] == 0) {
+            if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false;
+            continue;
+        }
+        float t1 = (lo[axis] - o[axis]) / dir[axis];
+        float t2 = (hi[axis] - o[axis]) / dir[axis];
+        if (t1 > t2) std::swap(t1, t2);
+        if (t1 > tmin) {
+            tmin = t1;
+            hitAxis = axis;
+        }
+        tmax = std::min(tmax, t2);
+        if (tmin > tmax) return false;
+    }
+    fraction = tmin;
+    normal = Vector2D();
+    if (hitAxis == 0) normal.x = dir[0] > 0 ? -1.0f : 1.0f;
+    if (hitAxis == 1) normal.y = dir[1] > 0 ? -1.0f : 1.0f;
+    return true;
+}
+
+float distanceTo(const Collider& shape, Vector2D point) {
+    if (shape.type == ShapeType::Circle) {
+        return std::max((point - shape.position).magnitude() - shape.extent.x, 0.0f);
+    }
+    const Vector2D closest(std::clamp(point.x, shape.position.x, shape.position.x + shape.extent.x),
+                           std::clamp(point.y, shape.position.y, shape.position.y + shape.extent.y));
+    return (point - closest).magnitude();
+}
+
+const CollideFn collisionTable[static_cast<int>(ShapeType::Count)][static_cast<int>(ShapeType::Count)] = {
+    // b: Circle      Rectangle
+    {circleCircle,    circleRectangle},    // a: Circle
+    {rectangleCircle, rectangleRectangle}, // a: Rectangle
+};
+
+Collider colliderOf(const PhysicsBody& body) {
+    if (body.shapeType == ShapeType::Circle) {
+        const Circle& circle = static_cast<const Circle&>(body);
+        return Collider{ShapeType::Circle, circle.position, Vector2D(circle.radius, 0)};
+    }
+    const Rectangle& rect = static_cast<const Rectangle&>(body);
+    return Collider{ShapeType::Rectangle, rect.position, Vector2D(rect.width, rect.height)};
+}
+
+void resolveContact(PhysicsBody& a, PhysicsBody& b, const Contact& contact) {
+    const float invMassA = a.inverseMass();
+    const float invMassB = b.inverseMass();
+    const float invMassSum = invMassA + invMassB;
+    if (invMassSum == 0) return;
+
+    // Separate objects, the lighter body moves further
+    Vector2D correction = contact.normal * (contact.depth / invMassSum);
+    a.position += correction * invMassA;
+    b.position -= correction * invMassB;
+
+    // Don't resolve if velocities are separating
+    Vector2D relVel = a.velocity - b.velocity;
+    float velAlongNormal = relVel.dot(contact.normal);
+    if (velAlongNormal > 0) return;
+
+    float e = std::min(a.restitution, b.restitution);
+    float j = -(1 + e) * velAlongNormal / invMassSum;
+
+    Vector2D impulse = contact.normal * j;
+    a.velocity += impulse * invMassA;
+    b.velocity -= impulse * invMassB;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+// Narrowphase: shape vs shape tests dispatched through a table indexed by the
+// shape types of both colliders, so the pair loop needs no RTTI.
+
+#include <Physics/PhysicsBody.h>
+#include <Physics/Vector2D.h>
+
+// Collision geometry of one body. position is the circle centre or the
+// rectangle top-left corner; extent is (radius, 0) or (width, height).
+struct Collider {
+    ShapeType type;
+    Vector2D position;
+    Vector2D extent;
+};
+
+// Contact between two bodies. The normal points from b towards a; moving a by
+// normal * depth separates the bodies.
+struct Contact {
+    Vector2D normal;
+    float depth = 0.0f;
+};
+
+// Grow a collider by margin in every direction
+inline Collider inflated(const Collider& c, float margin) {
+    if (c.type == ShapeType::Circle) {
+        return Collider{c.type, c.position, Vector2D(c.extent.x + margin, 0)};
+    }
+    return Collider{c.type, Vector2D(c.position.x - margin, c.position.y - margin),
+                    Vector2D(c.extent.x + 2 * margin, c.extent.y + 2 * margin)};
+}
+
+using CollideFn = bool (*)(const Collider& a, const Collider& b, Contact& contact);
+
+// collisionTable[typeA][typeB] tests a collider of typeA against one of typeB
+extern const CollideFn collisionTable[static_cast<int>(ShapeType::Count)][static_cast<int>(ShapeType::Count)];
+
+inline bool collide(const Collider& a, const Collider& b, Contact& contact) {
+    return collisionTable[static_cast<int>(a.type)][static_cast<int>(b.type)](a, b, contact);
+}
+
+// Continuous collision: the fraction toi in [0, 1] of motion at which a circle
+// moving by motion first touches a stationary target. False when they do not
+// touch during the motion or already overlap at its start.
+bool timeOfImpact(const Collider& circle, Vector2D motion, const Collider& target, float& toi);
+
+// Ray against one shape: the fraction in [0, 1] of delta at which
+// origin + t * delta first touches the shape, and the surface normal there.
+// An origin inside the shape hits at fraction 0 with a zero normal.
+bool raycast(const Collider& shape, Vector2D origin, Vector2D delta, float& fraction, Vector2D& normal);
+
+// Distance from point to the shape's surface, 0 for points inside it
+float distanceTo(const Collider& shape, Vector2D point);
+
+// Standalone PhysicsBody objects (outside a world) go through the same table
+Collider colliderOf(const PhysicsBody& body);
+
+inline bool collide(const PhysicsBody& a, const PhysicsBody& b, Contact& contact) {
+    return collide(colliderOf(a), colliderOf(b), contact);
+}
+
+// Push the bodies apart and apply the restitution impulse along the normal
+void resolveContact(PhysicsBody& a, PhysicsBody& b, const Contact& contact);
@@ -0,0 +1,46 @@
+#include <Physics/ContactEvents.h>
+#include <algorithm>
+
+namespace {
+
+ContactEvent eventOf(uint64_t key) {
+    return ContactEvent{BodyHandle{static_cast<uint32_t>(key >> 32)}, BodyHandle{static_cast<uint32_t>(key)}};
+}
+
+} // namespace
+
+void ContactTracker::update(const BodyStorage& storage, const std::vector<ContactManifold>& manifolds) {
+    previous.swap(touching);
+    touching.clear();
+    for (const ContactManifold& m : manifolds) touching.push_back(m.key);
+    std::sort(touching.begin(), touching.end());
+
+    // Walk both sorted key lists together
+    begin.clear();
+    end.clear();
+    carried.clear();
+    auto resting = [&](BodyHandle body) {
+        const uint32_t i = storage.indexOf(body);
+        return storage.isStatic(i) || storage.isSleeping(i);
+    };
+    size_t p = 0, t = 0;
+    while (p < previous.size() || t < touching.size()) {
+        if (t == touching.size() || (p < previous.size() && previous[p] < touching[t])) {
+            const uint64_t key = previous[p++];
+            const ContactEvent e = eventOf(key);
+            if (resting(e.a) && resting(e.b)) carried.push_back(key);
+            else end.push_back(e);
+        } else if (p == previous.size() || touching[t] < previous[p]) {
+            begin.push_back(eventOf(touching[t++]));
+        } else {
+            ++p;
+            ++t;
+        }
+    }
+
+    if (!carried.empty()) {
+        previous.resize(touching.size() + carried.size());
+        std::merge(touching.begin(), touching.end(), carried.begin(), carried.end(), previous.begin());
+        touching.swap(previous);
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+// Contact begin and end events, gathered once per step from the manifolds.
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <Physics/BodyStorage.h>
+#include <Physics/ContactSolver.h>
+
+// A pair of bodies that started or stopped touching, a.id < b.id
+struct ContactEvent {
+    BodyHandle a;
+    BodyHandle b;
+};
+
+// Receives the events of a PhysicsWorld, see PhysicsWorld::setContactListener
+class ContactListener {
+public:
+    virtual ~ContactListener() = default;
+
+    // Called at the end of every update with all pairs that started (begin) or
+    // stopped (end) touching during it, both sorted by handle ids. Bodies
+    // touch while they have a contact manifold, i.e. are within the solver's
+    // contact margin. The spans are valid during the call only.
+    virtual void onContacts(std::span<const ContactEvent> begin, std::span<const ContactEvent> end) = 0;
+};
+
+// Diffs the touching pairs of consecutive steps. Pairs of bodies that are
+// both asleep or static get no manifold but keep touching, so they are
+// carried over instead of ending.
+class ContactTracker {
+public:
+    void update(const BodyStorage& storage, const std::vector<ContactManifold>& manifolds);
+
+    // Forget the touching pairs: the next update reports every contact as begun
+    void clear() {
+        touching.clear();
+        begin.clear();
+        end.clear();
+    }
+
+    const std::vector<ContactEvent>& getBegin() const { return begin; }
+    const std::vector<ContactEvent>& getEnd() const { return end; }
+
+private:
+    std::vector<uint64_t> touching; // pair keys of the last update, sorted
+    std::vector<uint64_t> previous;
+    std::vector<uint64_t> carried;
+    std::vector<ContactEvent> begin;
+    std::vector<ContactEvent> end;
+};
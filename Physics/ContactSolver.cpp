@@ -0,0 +1,108 @@
+#include <Physics/ContactSolver.h>
+#include <algorithm>
+
+void ContactSolver::solve(BodyStorage& storage, std::vector<ContactManifold>& manifolds, float dt) {
+    prepare(storage, manifolds, dt);
+    for (int i = 0; i < settings.velocityIterations; ++i) {
+        solveVelocities(storage, manifolds);
+    }
+    storeImpulses(manifolds);
+    solvePositions(storage, manifolds);
+}
+
+void ContactSolver::prepare(BodyStorage& storage, std::vector<ContactManifold>& manifolds, float dt) {
+    for (ContactManifold& m : manifolds) {
+        const float invMassA = storage.invMass[m.a];
+        const float invMassB = storage.invMass[m.b];
+        const float invMassSum = invMassA + invMassB;
+        m.normalMass = invMassSum > 0 ? 1.0f / invMassSum : 0.0f;
+
+        // Contacts that were touching last step are resting: they start from
+        // the cached impulse and never bounce. Restitution biases along a
+        // resting chain add up and would pump energy into stacks. A pair first
+        // caught across a gap has its approach stopped by the speculative bias,
+        // so the speed it closed at is carried until the bodies touch, and the
+        // bounce is taken from that.
+        auto it = std::lower_bound(cache.begin(), cache.end(), CachedImpulse{m.key, 0.0f});
+        const bool persistent = it != cache.end() && it->key == m.key;
+        m.normalImpulse = persistent && settings.warmStarting ? it->normalImpulse : 0.0f;
+
+        const float vn = (storage.velX[m.a] - storage.velX[m.b]) * m.normal.x +
+                         (storage.velY[m.a] - storage.velY[m.b]) * m.normal.y;
+        const float approach = persistent ? it->approach : std::min(vn, 0.0f);
+        if (m.depth < 0) {
+            // Speculative contact: the bodies may still close the gap this step
+            m.velocityBias = m.depth / dt;
+            m.approach = std::min(approach, vn);
+        } else if (approach < -settings.restitutionThreshold) {
+            m.velocityBias = -std::min(storage.restitution[m.a], storage.restitution[m.b]) * approach;
+            m.approach = 0.0f;
+        } else {
+            m.velocityBias = 0.0f;
+            m.approach = 0.0f;
+        }
+
+        // Start from last step's impulse
+        if (m.normalImpulse != 0.0f) {
+            const float px = m.normal.x * m.normalImpulse;
+            const float py = m.normal.y * m.normalImpulse;
+            storage.velX[m.a] += px * invMassA;
+            storage.velY[m.a] += py * invMassA;
+            storage.velX[m.b] -= px * invMassB;
+            storage.velY[m.b] -= py * invMassB;
+        }
+    }
+}
+
+void ContactSolver::solveVelocities(BodyStorage& storage, std::vector<ContactManifold>& manifolds) {
+    for (ContactManifold& m : manifolds) {
+        const float invMassA = storage.invMass[m.a];
+        const float invMassB = storage.invMass[m.b];
+
+        const float vn = (storage.velX[m.a] - storage.velX[m.b]) * m.normal.x +
+                         (storage.velY[m.a] - storage.velY[m.b]) * m.normal.y;
+
+        // Clamp the accumulated impulse, not the increment: contacts push only
+        float lambda = m.normalMass * (m.velocityBias - vn);
+        const float accumulated = std::max(m.normalImpulse + lambda, 0.0f);
+        lambda = accumulated - m.normalImpulse;
+        m.normalImpulse = accumulated;
+
+        const float px = m.normal.x * lambda;
+        const float py = m.normal.y * lambda;
+        storage.velX[m.a] += px * invMassA;
+        storage.velY[m.a] += py * invMassA;
+        storage.velX[m.b] -= px * invMassB;
+        storage.velY[m.b] -= py * invMassB;
+    }
+}
+
+void ContactSolver::solvePositions(BodyStorage& storage, const std::vector<ContactManifold>& manifolds) {
+    for (int i = 0; i < settings.positionIterations; ++i) {
+        for (const ContactManifold& m : manifolds) {
+            const float invMassA = storage.invMass[m.a];
+            const float invMassB = storage.invMass[m.b];
+
+            // Bodies only translate: current penetration follows from how far
+            // both moved along the normal since the manifold was built
+            const float moved = (storage.posX[m.a] - m.startA.x - storage.posX[m.b] + m.startB.x) * m.normal.x +
+                                (storage.posY[m.a] - m.startA.y - storage.posY[m.b] + m.startB.y) * m.normal.y;
+            const float separation = m.depth - moved - settings.linearSlop;
+            if (separation <= 0) continue;
+
+            const float correction = std::min(settings.baumgarte * separation, settings.maxCorrection) * m.normalMass;
+            storage.posX[m.a] += m.normal.x * correction * invMassA;
+            storage.posY[m.a] += m.normal.y * correction * invMassA;
+            storage.posX[m.b] -= m.normal.x * correction * invMassB;
+            storage.posY[m.b] -= m.normal.y * correction * invMassB;
+        }
+    }
+}
+
+void ContactSolver::storeImpulses(const std::vector<ContactManifold>& manifolds) {
+    cache.clear();
+    for (const ContactManifold& m : manifolds) {
+        cache.push_back(CachedImpulse{m.key, m.normalImpulse, m.approach});
+    }
+    std::sort(cache.begin(), cache.end());
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// Sequential impulse contact solver with warm starting.
+
+#include <cstdint>
+#include <vector>
+#include <Physics/BodyStorage.h>
+#include <Physics/Collision.h>
+
+// Contact manifold of one touching pair. Bodies do not rotate, so a single
+// point along the normal carries the whole response.
+struct ContactManifold {
+    uint32_t a;             // body indices
+    uint32_t b;
+    uint64_t key;           // handle ids of both bodies, stable across steps
+    Vector2D normal;        // from b towards a
+    float depth;            // penetration when the manifold was built, < 0 for a gap
+    Vector2D startA;        // positions when the manifold was built
+    Vector2D startB;
+
+    // Solver state
+    float normalImpulse = 0.0f; // accumulated, carried to the next step
+    float normalMass = 0.0f;
+    float velocityBias = 0.0f;
+    float approach = 0.0f;      // closing speed seen across a gap and not yet bounced, <= 0
+};
+
+inline uint64_t pairKey(BodyHandle a, BodyHandle b) {
+    const uint32_t lo = a.id < b.id ? a.id : b.id;
+    const uint32_t hi = a.id < b.id ? b.id : a.id;
+    return (static_cast<uint64_t>(lo) << 32) | hi;
+}
+
+struct SolverSettings {
+    int velocityIterations = 8;
+    int positionIterations = 3;
+    bool warmStarting = true;
+    float restitutionThreshold = 4.0f; // slower approach does not bounce
+    float contactMargin = 0.5f;        // bodies closer than this already touch
+    float linearSlop = 0.05f;          // penetration left to keep contacts alive
+    float baumgarte = 0.6f;            // fraction of penetration fixed per iteration
+    float maxCorrection = 8.0f;        // per iteration
+};
+
+class ContactSolver {
+public:
+    SolverSettings settings;
+
+    // Resolve all manifolds: velocities with accumulated impulses, then
+    // positions. Impulses are cached by pair key for the next call.
+    void solve(BodyStorage& storage, std::vector<ContactManifold>& manifolds, float dt);
+
+    // Forget cached impulses, e.g. after teleporting bodies
+    void clearCache() { cache.clear(); }
+
+    struct CachedImpulse {
+        uint64_t key;
+        float normalImpulse;
+        float approach = 0.0f;  // ContactManifold::approach
+
+        bool operator<(const CachedImpulse& other) const { return key < other.key; }
+    };
+
+    // Impulses kept for warm starting the next step, sorted by key
+    const std::vector<CachedImpulse>& getCache() const { return cache; }
+
+    // Replace the cache, e.g. from a checkpoint. Entries must be sorted by key.
+    void setCache(const CachedImpulse* entries, size_t count) { cache.assign(entries, entries + count); }
+
+private:
+    void prepare(BodyStorage& storage, std::vector<ContactManifold>& manifolds, float dt);
+    void solveVelocities(BodyStorage& storage, std::vector<ContactManifold>& manifolds);
+    void solvePositions(BodyStorage& storage, const std::vector<ContactManifold>& manifolds);
+    void storeImpulses(const std::vector<ContactManifold>& manifolds);
+
+    std::vector<CachedImpulse> cache; // last step, sorted by key
+};
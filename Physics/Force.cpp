@@ -0,0 +1,148 @@
+#include <Physics/PhysicsWorld.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr uint8_t Inactive = BodyFlagStatic | BodyFlagSleeping;
+
+// Springs are gathered into blocks of this many, then evaluated together
+constexpr size_t SpringBlock = 256;
+
+// Spring forces on body a (body b gets the opposite) from the offset and
+// relative velocity of b. Straight-line code over flat arrays, which the
+// compiler turns into packed SIMD.
+void springKernel(size_t n, const float* __restrict dx, const float* __restrict dy,
+                  const float* __restrict dvx, const float* __restrict dvy,
+                  const float* __restrict restLength, const float* __restrict stiffness,
+                  const float* __restrict damping, float* __restrict fx, float* __restrict fy) {
+    for (size_t j = 0; j < n; ++j) {
+        const float length = std::sqrt(dx[j] * dx[j] + dy[j] * dy[j]);
+        // Coincident ends have no direction to push along. Divide first and
+        // select after, so the loop has no branch.
+        const float reciprocal = 1.0f / length;
+        const float inverse = length > 0.0f ? reciprocal : 0.0f;
+        const float speed = (dvx[j] * dx[j] + dvy[j] * dy[j]) * inverse;
+        const float magnitude = (stiffness[j] * (length - restLength[j]) + damping[j] * speed) * inverse;
+        fx[j] = magnitude * dx[j];
+        fy[j] = magnitude * dy[j];
+    }
+}
+
+// Forces of springs [begin, end) into fx, fy, indexed by spring
+void springForces(const BodyStorage& storage, const SpringColumns& springs, size_t begin, size_t end,
+                  float* fx, float* fy) {
+    float dx[SpringBlock], dy[SpringBlock], dvx[SpringBlock], dvy[SpringBlock];
+    for (size_t first = begin; first < end; first += SpringBlock) {
+        const size_t n = std::min(SpringBlock, end - first);
+        for (size_t j = 0; j < n; ++j) {
+            const uint32_t a = storage.indexOf(springs.a[first + j]);
+            const uint32_t b = storage.indexOf(springs.b[first + j]);
+            const Vector2D offset = storage.centre(b) - storage.centre(a);
+            dx[j] = offset.x;
+            dy[j] = offset.y;
+            dvx[j] = storage.velX[b] - storage.velX[a];
+            dvy[j] = storage.velY[b] - storage.velY[a];
+        }
+        springKernel(n, dx, dy, dvx, dvy, springs.restLength.data() + first, springs.stiffness.data() + first,
+                     springs.damping.data() + first, fx + first, fy + first);
+    }
+}
+
+// fn(i) for every awake dynamic body of bodies[begin, end), or of the
+// storage indices [begin, end) when the list is empty
+template <typename Fn>
+void forEachBody(const BodyStorage& storage, const std::vector<BodyHandle>& bodies, size_t begin, size_t end,
+                 Fn&& fn) {
+    if (bodies.empty()) {
+        for (uint32_t i = static_cast<uint32_t>(begin); i < end; ++i) {
+            if (!(storage.flags[i] & Inactive)) fn(i);
+        }
+        return;
+    }
+    for (size_t k = begin; k < end; ++k) {
+        const uint32_t i = storage.indexOf(bodies[k]);
+        if (!(storage.flags[i] & Inactive)) fn(i);
+    }
+}
+
+void applyDrag(BodyStorage& s, const ForceGenerator<DragForce>& g, size_t begin, size_t end) {
+    const DragForce drag = g.params;
+    forEachBody(s, g.bodies, begin, end, [&s, drag](uint32_t i) {
+        const float vx = s.velX[i], vy = s.velY[i];
+        const float k = drag.linear + drag.quadratic * std::sqrt(vx * vx + vy * vy);
+        s.forceX[i] -= k * vx;
+        s.forceY[i] -= k * vy;
+    });
+}
+
+void applyRadial(BodyStorage& s, const ForceGenerator<RadialForce>& g, size_t begin, size_t end) {
+    const RadialForce field = g.params;
+    forEachBody(s, g.bodies, begin, end, [&s, field](uint32_t i) {
+        const Vector2D offset = field.centre - s.centre(i);
+        const float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+        // Bodies without mass are not moved by forces at all
+        if (distance >= field.radius || distance == 0.0f || s.invMass[i] == 0.0f) return;
+        // Mass times the acceleration along the unit offset
+        const float acceleration = field.strength * (1.0f - distance / field.radius) / distance;
+        const float scale = acceleration / s.invMass[i];
+        s.forceX[i] += offset.x * scale;
+        s.forceY[i] += offset.y * scale;
+    });
+}
+
+void applyWind(BodyStorage& s, const ForceGenerator<WindForce>& g, size_t begin, size_t end) {
+    const WindForce wind = g.params;
+    forEachBody(s, g.bodies, begin, end, [&s, wind](uint32_t i) {
+        const Vector2D c = s.centre(i);
+        if (c.x < wind.region.min.x || c.x > wind.region.max.x || c.y < wind.region.min.y || c.y > wind.region.max.y) return;
+        s.forceX[i] += wind.coefficient * (wind.velocity.x - s.velX[i]);
+        s.forceY[i] += wind.coefficient * (wind.velocity.y - s.velY[i]);
+    });
+}
+
+} // namespace
+
+// Generators run one after another, each spread over the job system. Within
+// a generator every body is written once, and the order in which forces are
+// summed is fixed, so results do not depend on the thread count.
+void PhysicsWorld::applyForces() {
+    // Springs touch two bodies each: their forces are computed in parallel,
+    // then added to the bodies in spring order. A spring wakes the sleeping
+    // island at one end when the other end is awake, and joins the islands
+    // of its ends, so connected bodies fall asleep together.
+    const size_t springCount = forces.springs.size();
+    if (springCount > 0) {
+        springForceX.resize(springCount);
+        springForceY.resize(springCount);
+        forRange(springCount, 4 * SpringBlock, [this](size_t begin, size_t end) {
+            springForces(storage, forces.springs, begin, end, springForceX.data(), springForceY.data());
+        });
+        for (size_t k = 0; k < springCount; ++k) {
+            const uint32_t a = storage.indexOf(forces.springs.a[k]);
+            const uint32_t b = storage.indexOf(forces.springs.b[k]);
+            if (!storage.isStatic(a) && !storage.isStatic(b)) {
+                if (storage.isSleeping(a) != storage.isSleeping(b)) islands.wake(storage, storage.isSleeping(a) ? a : b);
+                springLinks.emplace_back(a, b);
+            }
+            if (!(storage.flags[a] & Inactive)) {
+                storage.forceX[a] += springForceX[k];
+                storage.forceY[a] += springForceY[k];
+            }
+            if (!(storage.flags[b] & Inactive)) {
+                storage.forceX[b] -= springForceX[k];
+                storage.forceY[b] -= springForceY[k];
+            }
+        }
+    }
+
+    const auto run = [this](const auto& generators, auto apply) {
+        for (const auto& g : generators) {
+            const size_t count = g.bodies.empty() ? storage.size() : g.bodies.size();
+            forRange(count, 4096, [&](size_t begin, size_t end) { apply(storage, g, begin, end); });
+        }
+    };
+    run(forces.drags, applyDrag);
+    run(forces.radials, applyRadial);
+    run(forces.winds, applyWind);
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+// Force generators: springs, drag, radial fields and wind, evaluated once per
+// update before integration. Each generator type is evaluated by one batched
+// kernel over the bodies it affects, not by a call per body and force.
+// Forces act on awake dynamic bodies only, like gravity; static and sleeping
+// bodies are left alone.
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <Physics/AABB.h>
+#include <Physics/BodyStorage.h>
+#include <Physics/Vector2D.h>
+
+// Damped spring between the centres of two bodies
+struct SpringDef {
+    BodyHandle a;
+    BodyHandle b;
+    float restLength = 0.0f;
+    float stiffness = 0.0f;     // force per unit of stretch
+    float damping = 0.0f;       // force per unit of stretching speed
+};
+
+// All springs, one column per field, so the force pass runs over flat arrays.
+// Removing a spring moves the last one into its index.
+struct SpringColumns {
+    std::vector<BodyHandle> a, b;
+    std::vector<float> restLength, stiffness, damping;
+
+    size_t size() const { return a.size(); }
+
+    uint32_t add(const SpringDef& def) {
+        a.push_back(def.a);
+        b.push_back(def.b);
+        restLength.push_back(def.restLength);
+        stiffness.push_back(def.stiffness);
+        damping.push_back(def.damping);
+        return static_cast<uint32_t>(a.size() - 1);
+    }
+
+    void remove(uint32_t spring) {
+        const size_t last = a.size() - 1;
+        a[spring] = a[last];
+        b[spring] = b[last];
+        restLength[spring] = restLength[last];
+        stiffness[spring] = stiffness[last];
+        damping[spring] = damping[last];
+        a.pop_back();
+        b.pop_back();
+        restLength.pop_back();
+        stiffness.pop_back();
+        damping.pop_back();
+    }
+
+    void clear() {
+        a.clear();
+        b.clear();
+        restLength.clear();
+        stiffness.clear();
+        damping.clear();
+    }
+};
+
+// Air resistance against the body's velocity: -(linear + quadratic * |v|) * v
+struct DragForce {
+    float linear = 0.0f;
+    float quadratic = 0.0f;
+};
+
+// Accelerates bodies whose centre is within radius towards centre (away
+// from it for a negative strength), fading linearly to zero at the radius.
+// The acceleration does not depend on mass, like gravity. Bodies without
+// mass are left alone.
+struct RadialForce {
+    Vector2D centre;
+    float strength = 0.0f;
+    float radius = 0.0f;
+};
+
+// Air moving at velocity inside region drags the bodies whose centre is in
+// it along: coefficient * (velocity - body velocity)
+struct WindForce {
+    Vector2D velocity;
+    float coefficient = 0.0f;
+    AABB region = AABB(Vector2D(-1e30f, -1e30f), Vector2D(1e30f, 1e30f));
+};
+
+// A generator of one of the per-body types and the bodies it acts on. An
+// empty body list means every body, including ones created later. A body
+// must appear at most once per list.
+template <typename Params>
+struct ForceGenerator {
+    Params params;
+    std::vector<BodyHandle> bodies;
+};
+
+struct ForceRegistry {
+    SpringColumns springs;
+    std::vector<ForceGenerator<DragForce>> drags;
+    std::vector<ForceGenerator<RadialForce>> radials;
+    std::vector<ForceGenerator<WindForce>> winds;
+
+    template <typename Params>
+    static uint32_t add(std::vector<ForceGenerator<Params>>& generators, const Params& params,
+                        std::span<const BodyHandle> bodies) {
+        generators.push_back(ForceGenerator<Params>{params, std::vector<BodyHandle>(bodies.begin(), bodies.end())});
+        return static_cast<uint32_t>(generators.size() - 1);
+    }
+
+    bool empty() const {
+        return springs.size() == 0 && drags.empty() && radials.empty() && winds.empty();
+    }
+
+    void clear() {
+        springs.clear();
+        drags.clear();
+        radials.clear();
+        winds.clear();
+    }
+};
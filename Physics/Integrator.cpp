@@ -0,0 +1,141 @@
+#include <Physics/Integrator.h>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define PHYSICS_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+void integrateScalar(const IntegrationColumns& c, size_t begin, size_t end,
+                     Vector2D gravity, float dt, uint8_t skipFlags) {
+    for (size_t i = begin; i < end; ++i) {
+        if (c.flags[i] & skipFlags) continue;
+        c.velX[i] = c.velX[i] + (gravity.x + c.forceX[i] * c.invMass[i]) * dt;
+        c.velY[i] = c.velY[i] + (gravity.y + c.forceY[i] * c.invMass[i]) * dt;
+        c.posX[i] = c.posX[i] + c.velX[i] * dt;
+        c.posY[i] = c.posY[i] + c.velY[i] * dt;
+        c.forceX[i] = 0.0f;
+        c.forceY[i] = 0.0f;
+    }
+}
+
+#ifdef PHYSICS_X86_SIMD
+
+// SSE2 is part of x86-64, no target attribute needed
+inline __m128 selectSSE(__m128 mask, __m128 yes, __m128 no) {
+    return _mm_or_ps(_mm_and_ps(mask, yes), _mm_andnot_ps(mask, no));
+}
+
+void integrateSSE2(const IntegrationColumns& c, size_t begin, size_t end,
+                   Vector2D gravity, float dt, uint8_t skipFlags) {
+    const __m128 gx = _mm_set1_ps(gravity.x);
+    const __m128 gy = _mm_set1_ps(gravity.y);
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128i skip = _mm_set1_epi32(skipFlags);
+    const __m128i zeroi = _mm_setzero_si128();
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        // Lanes where (flags & skipFlags) == 0 are integrated
+        int32_t packed;
+        std::memcpy(&packed, c.flags + i, sizeof(packed));
+        __m128i f = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zeroi), zeroi);
+        __m128 active = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(f, skip), zeroi));
+
+        __m128 im = _mm_loadu_ps(c.invMass + i);
+        __m128 fx = _mm_loadu_ps(c.forceX + i);
+        __m128 fy = _mm_loadu_ps(c.forceY + i);
+        __m128 vx = _mm_loadu_ps(c.velX + i);
+        __m128 vy = _mm_loadu_ps(c.velY + i);
+        __m128 px = _mm_loadu_ps(c.posX + i);
+        __m128 py = _mm_loadu_ps(c.posY + i);
+
+        __m128 nvx = _mm_add_ps(vx, _mm_mul_ps(_mm_add_ps(gx, _mm_mul_ps(fx, im)), vdt));
+        __m128 nvy = _mm_add_ps(vy, _mm_mul_ps(_mm_add_ps(gy, _mm_mul_ps(fy, im)), vdt));
+        __m128 npx = _mm_add_ps(px, _mm_mul_ps(nvx, vdt));
+        __m128 npy = _mm_add_ps(py, _mm_mul_ps(nvy, vdt));
+
+        _mm_storeu_ps(c.velX + i, selectSSE(active, nvx, vx));
+        _mm_storeu_ps(c.velY + i, selectSSE(active, nvy, vy));
+        _mm_storeu_ps(c.posX + i, selectSSE(active, npx, px));
+        _mm_storeu_ps(c.posY + i, selectSSE(active, npy, py));
+        _mm_storeu_ps(c.forceX + i, selectSSE(active, zero, fx));
+        _mm_storeu_ps(c.forceY + i, selectSSE(active, zero, fy));
+    }
+    integrateScalar(c, i, end, gravity, dt, skipFlags);
+}
+
+__attribute__((target("avx2")))
+void integrateAVX2(const IntegrationColumns& c, size_t begin, size_t end,
+                   Vector2D gravity, float dt, uint8_t skipFlags) {
+    const __m256 gx = _mm256_set1_ps(gravity.x);
+    const __m256 gy = _mm256_set1_ps(gravity.y);
+    const __m256 vdt = _mm256_set1_ps(dt);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256i skip = _mm256_set1_epi32(skipFlags);
+    const __m256i zeroi = _mm256_setzero_si256();
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        // Lanes where (flags & skipFlags) == 0 are integrated
+        __m256i f = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(c.flags + i)));
+        __m256 active = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(f, skip), zeroi));
+
+        __m256 im = _mm256_loadu_ps(c.invMass + i);
+        __m256 fx = _mm256_loadu_ps(c.forceX + i);
+        __m256 fy = _mm256_loadu_ps(c.forceY + i);
+        __m256 vx = _mm256_loadu_ps(c.velX + i);
+        __m256 vy = _mm256_loadu_ps(c.velY + i);
+        __m256 px = _mm256_loadu_ps(c.posX + i);
+        __m256 py = _mm256_loadu_ps(c.posY + i);
+
+        __m256 nvx = _mm256_add_ps(vx, _mm256_mul_ps(_mm256_add_ps(gx, _mm256_mul_ps(fx, im)), vdt));
+        __m256 nvy = _mm256_add_ps(vy, _mm256_mul_ps(_mm256_add_ps(gy, _mm256_mul_ps(fy, im)), vdt));
+        __m256 npx = _mm256_add_ps(px, _mm256_mul_ps(nvx, vdt));
+        __m256 npy = _mm256_add_ps(py, _mm256_mul_ps(nvy, vdt));
+
+        _mm256_storeu_ps(c.velX + i, _mm256_blendv_ps(vx, nvx, active));
+        _mm256_storeu_ps(c.velY + i, _mm256_blendv_ps(vy, nvy, active));
+        _mm256_storeu_ps(c.posX + i, _mm256_blendv_ps(px, npx, active));
+        _mm256_storeu_ps(c.posY + i, _mm256_blendv_ps(py, npy, active));
+        _mm256_storeu_ps(c.forceX + i, _mm256_blendv_ps(fx, zero, active));
+        _mm256_storeu_ps(c.forceY + i, _mm256_blendv_ps(fy, zero, active));
+    }
+    integrateScalar(c, i, end, gravity, dt, skipFlags);
+}
+
+#endif // PHYSICS_X86_SIMD
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef PHYSICS_X86_SIMD
+    static const SimdLevel level = __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::SSE2;
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+void integrateBodies(const IntegrationColumns& columns, size_t begin, size_t end,
+                     Vector2D gravity, float dt, uint8_t skipFlags, SimdLevel level) {
+    if (level > detectSimdLevel()) level = detectSimdLevel();
+    switch (level) {
+#ifdef PHYSICS_X86_SIMD
+        case SimdLevel::AVX2: integrateAVX2(columns, begin, end, gravity, dt, skipFlags); return;
+        case SimdLevel::SSE2: integrateSSE2(columns, begin, end, gravity, dt, skipFlags); return;
+#endif
+        default: integrateScalar(columns, begin, end, gravity, dt, skipFlags); return;
+    }
+}
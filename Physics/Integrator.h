@@ -0,0 +1,41 @@
+#pragma once
+
+// Explicit Euler integration over SoA columns, with packed SSE2 / AVX2
+// kernels picked at runtime. Every kernel evaluates
+//     vel += (gravity + force * invMass) * dt
+//     pos += vel * dt
+// with the same operations in the same order and no fused multiply-add, so
+// all of them produce bit-identical results to the scalar loop.
+
+#include <cstddef>
+#include <cstdint>
+#include <Physics/Vector2D.h>
+
+enum class SimdLevel : uint8_t {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Columns the integrator reads and writes, all of length count
+struct IntegrationColumns {
+    float* posX;
+    float* posY;
+    float* velX;
+    float* velY;
+    float* forceX;   // cleared for every integrated body
+    float* forceY;
+    const float* invMass;
+    const uint8_t* flags;
+    size_t count;
+};
+
+// Best level the running CPU supports
+SimdLevel detectSimdLevel();
+
+const char* simdLevelName(SimdLevel level);
+
+// Integrate bodies [begin, end). Bodies with any of skipFlags set are left
+// untouched. Levels the CPU (or build) cannot run fall back to the next lower.
+void integrateBodies(const IntegrationColumns& columns, size_t begin, size_t end,
+                     Vector2D gravity, float dt, uint8_t skipFlags, SimdLevel level);
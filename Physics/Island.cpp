@@ -0,0 +1,108 @@
+#include <Physics/Island.h>
+#include <algorithm>
+#include <limits>
+
+void IslandManager::update(BodyStorage& storage, const std::vector<ContactManifold>& manifolds, float dt,
+                           std::span<const BodyPair> links) {
+    const uint32_t count = static_cast<uint32_t>(storage.size());
+    if (!settings.enabled) {
+        if (sleepingCount > 0) wakeAll(storage);
+        islandCount = 0;
+        awakeCount = 0;
+        for (uint32_t i = 0; i < count; ++i) awakeCount += !storage.isStatic(i);
+        return;
+    }
+
+    const auto isAwakeDynamic = [&storage](uint32_t i) {
+        return (storage.flags[i] & (BodyFlagStatic | BodyFlagSleeping)) == 0;
+    };
+
+    // Sleep timers
+    const float tolerance2 = settings.linearTolerance * settings.linearTolerance;
+    parent.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        parent[i] = i;
+        if (!isAwakeDynamic(i)) continue;
+        const float speed2 = storage.velX[i] * storage.velX[i] + storage.velY[i] * storage.velY[i];
+        storage.sleepTime[i] = speed2 > tolerance2 ? 0.0f : storage.sleepTime[i] + dt;
+    }
+
+    // Islands: contacts between two dynamic bodies join them. Every manifold
+    // has at least one awake body, and a sleeping body touched by an awake one
+    // was woken before the solver ran.
+    for (const ContactManifold& m : manifolds) {
+        if (storage.isStatic(m.a) || storage.isStatic(m.b)) continue;
+        unite(m.a, m.b);
+    }
+    for (const BodyPair& link : links) {
+        if (storage.isStatic(link.a) || storage.isStatic(link.b)) continue;
+        unite(link.a, link.b);
+    }
+
+    islandRest.assign(count, std::numeric_limits<float>::max());
+    islandCount = 0;
+    awakeCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!isAwakeDynamic(i)) continue;
+        const uint32_t root = find(i);
+        islandCount += root == i;
+        islandRest[root] = std::min(islandRest[root], storage.sleepTime[i]);
+    }
+
+    // Put resting islands to sleep, threading each into a ring
+    ringStart.assign(count, BodyHandle::Invalid);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (!isAwakeDynamic(i)) continue;
+        const uint32_t root = find(i);
+        if (islandRest[root] < settings.timeToSleep) {
+            ++awakeCount;
+            continue;
+        }
+
+        const uint32_t start = ringStart[root];
+        if (start == BodyHandle::Invalid) {
+            ringStart[root] = i;
+            storage.sleepNext[i] = storage.ids[i];
+        } else {
+            storage.sleepNext[i] = storage.sleepNext[start];
+            storage.sleepNext[start] = storage.ids[i];
+        }
+        storage.flags[i] |= BodyFlagSleeping;
+        storage.velX[i] = storage.velY[i] = 0.0f;
+        storage.forceX[i] = storage.forceY[i] = 0.0f;
+        ++sleepingCount;
+    }
+}
+
+void IslandManager::wake(BodyStorage& storage, uint32_t index) {
+    if (!storage.isSleeping(index)) return;
+    uint32_t i = index;
+    do {
+        const uint32_t next = storage.indexOf(BodyHandle{storage.sleepNext[i]});
+        storage.flags[i] &= ~BodyFlagSleeping;
+        storage.sleepTime[i] = 0.0f;
+        storage.sleepNext[i] = storage.ids[i];
+        --sleepingCount;
+        ++awakeCount;
+        i = next;
+    } while (i != index);
+}
+
+void IslandManager::wakeAll(BodyStorage& storage) {
+    for (uint32_t i = 0; i < storage.size(); ++i) {
+        storage.flags[i] &= ~BodyFlagSleeping;
+        storage.sleepTime[i] = 0.0f;
+        storage.sleepNext[i] = storage.ids[i];
+    }
+    sleepingCount = 0;
+}
+
+void IslandManager::rebuildCounts(const BodyStorage& storage) {
+    awakeCount = 0;
+    sleepingCount = 0;
+    for (uint32_t i = 0; i < storage.size(); ++i) {
+        if (storage.isStatic(i)) continue;
+        if (storage.isSleeping(i)) ++sleepingCount;
+        else ++awakeCount;
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+// Islands of touching bodies and sleeping.
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <Physics/BodyStorage.h>
+#include <Physics/Broadphase.h>
+#include <Physics/ContactSolver.h>
+
+struct SleepSettings {
+    bool enabled = true;
+    float linearTolerance = 2.0f; // bodies slower than this are at rest
+    float timeToSleep = 0.5f;     // seconds a whole island must rest
+};
+
+// Groups awake dynamic bodies into islands over the contact graph, and over
+// links such as springs, with a union-find. Static bodies do not join
+// islands, so everything resting on the same ground is not one island. An
+// island whose bodies have all rested for timeToSleep falls asleep: its
+// bodies are linked into a ring through BodyStorage::sleepNext so waking one
+// wakes the whole island. Awake bodies link to themselves.
+class IslandManager {
+public:
+    SleepSettings settings;
+
+    // After the solver: advance the sleep timers, build the islands from the
+    // manifolds and links (pairs of body indices) and put resting islands to
+    // sleep
+    void update(BodyStorage& storage, const std::vector<ContactManifold>& manifolds, float dt,
+                std::span<const BodyPair> links = {});
+
+    // Wake the sleeping island body index belongs to
+    void wake(BodyStorage& storage, uint32_t index);
+
+    // Recount awake and sleeping bodies from the flags after the columns were
+    // replaced wholesale, e.g. by a checkpoint restore
+    void rebuildCounts(const BodyStorage& storage);
+
+    // Islands of awake bodies found by the last update
+    size_t getIslandCount() const { return islandCount; }
+    // Dynamic bodies that were awake after the last update
+    size_t getAwakeCount() const { return awakeCount; }
+    size_t getSleepingCount() const { return sleepingCount; }
+
+private:
+    uint32_t find(uint32_t i) {
+        while (parent[i] != i) {
+            parent[i] = parent[parent[i]]; // path halving
+            i = parent[i];
+        }
+        return i;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        // The lower index stays root, so islands do not depend on pair order
+        if (a < b) parent[b] = a;
+        else parent[a] = b;
+    }
+
+    void wakeAll(BodyStorage& storage);
+
+    std::vector<uint32_t> parent;
+    std::vector<float> islandRest;  // per root: least sleepTime of its bodies
+    std::vector<uint32_t> ringStart; // per root: first body put to sleep
+    size_t islandCount = 0;
+    size_t awakeCount = 0;
+    size_t sleepingCount = 0;
+};
@@ -0,0 +1,36 @@
+#include <Physics/PhysicsBody.h>
+#include <Physics/Circle.h>
+#include <Physics/Rectangle.h>
+#include <Shared/Allocator.h>
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+constexpr size_t BodyBlockSize = std::max(sizeof(Circle), sizeof(Rectangle));
+
+std::mutex bodyPoolMutex;
+
+// Never destroyed, so bodies outliving static destruction can still be freed
+RK::PoolAllocator& bodyPool() {
+    static RK::PoolAllocator* pool = new RK::PoolAllocator(BodyBlockSize, 64);
+    return *pool;
+}
+
+} // namespace
+
+void* PhysicsBody::operator new(size_t size) {
+    // Subclasses larger than the built-in shapes use the general heap
+    if (size > BodyBlockSize) return ::operator new(size);
+    std::lock_guard<std::mutex> lock(bodyPoolMutex);
+    return bodyPool().allocate();
+}
+
+void PhysicsBody::operator delete(void* block, size_t size) noexcept {
+    if (size > BodyBlockSize) {
+        ::operator delete(block);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(bodyPoolMutex);
+    bodyPool().deallocate(block);
+}
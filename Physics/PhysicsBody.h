@@ -1,10 +1,21 @@
 #pragma once
 
 #include <Physics/Vector2D.h>
+#include <Physics/AABB.h>
+#include <cstddef>
+#include <cstdint>
+
+// Concrete shape of a body, used to index the collision dispatch table
+enum class ShapeType : uint8_t {
+    Circle,
+    Rectangle,
+    Count
+};
 
 // Base class for physics bodies
 class PhysicsBody {
 public:
+    const ShapeType shapeType;
     Vector2D position;
     Vector2D velocity;
     Vector2D acceleration;
@@ -12,10 +23,15 @@ public:
     float restitution; // bounciness (0-1)
     bool isStatic;
     
-    PhysicsBody(Vector2D pos, float m, float rest = 0.8f) 
-        : position(pos), mass(m), restitution(rest), isStatic(false) {}
+    PhysicsBody(ShapeType type, Vector2D pos, float m, float rest = 0.8f)
+        : shapeType(type), position(pos), mass(m), restitution(rest), isStatic(false) {}
     
     virtual ~PhysicsBody() = default;
+
+    // Body objects come from a shared block pool: they only live until
+    // PhysicsWorld::addBody copies them, so the same few blocks are recycled
+    static void* operator new(size_t size);
+    static void operator delete(void* block, size_t size) noexcept;
     
     void update(float dt) {
         if (isStatic) return;
@@ -32,9 +48,15 @@ public:
             acceleration += force * (1.0f / mass);
         }
     }
+
+    // Static bodies act as if they had infinite mass
+    float inverseMass() const {
+        return isStatic || mass <= 0 ? 0.0f : 1.0f / mass;
+    }
     
     virtual bool checkCollision(const PhysicsBody& other) const = 0;
     virtual void resolveCollision(PhysicsBody& other) = 0;
+    virtual AABB getBounds() const = 0;
     virtual void draw() const = 0;
 };
 
@@ -3,57 +3,500 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <span>
 #include <Physics/PhysicsBody.h>
+#include <Physics/BodyStorage.h>
+#include <Physics/Broadphase.h>
+#include <Physics/Collision.h>
+#include <Physics/ContactEvents.h>
+#include <Physics/ContactSolver.h>
+#include <Physics/Force.h>
+#include <Physics/Integrator.h>
+#include <Physics/Island.h>
+#include <Physics/Profiler.h>
+#include <Physics/Query.h>
+#include <Physics/Replay.h>
+#include <Physics/Snapshot.h>
+#include <Physics/StaticTree.h>
+#include <Shared/Allocator.h>
+#include <Shared/JobSystem.h>
+
+// Fixed-step front end of PhysicsWorld::advance
+struct TimeStepSettings {
+    float fixedDt = 1.0f / 60.0f;  // simulated time per step
+    int substeps = 1;              // updates per step, each of fixedDt / substeps
+    int maxStepsPerCall = 8;       // time beyond this is dropped, not owed
+};
 
 // Physics World class
 class PhysicsWorld {
 private:
-    std::vector<std::unique_ptr<PhysicsBody>> bodies;
+    BodyStorage storage;
     Vector2D gravity;
+    std::unique_ptr<Broadphase> broadphase;
+    SimdLevel simdLevel = detectSimdLevel();
+    RK::JobSystem* jobs = nullptr;
+    ContactSolver solver;
+    IslandManager islands;
+#if PHYSICS_PROFILER
+    StepProfiler profiler;
+#endif
+    SnapshotPublisher snapshots;
+    ReplayLog* recorder = nullptr;
+    ContactTracker contactTracker;
+    ContactListener* contactListener = nullptr;
+    ForceRegistry forces;
+
+    // Bodies with a non-default CollisionFilter; pairs are filtered only when
+    // there are any
+    size_t filteredCount = 0;
+
+    // Scratch that lives for one update (narrowphase results, bullet sweeps),
+    // reset at its end. Its memory is reused, so steady stepping does not
+    // allocate.
+    RK::FrameArena frameArena;
+
+    // Static bodies stay out of the broadphase: their bounds go into a tree
+    // built in one go, rebuilt only after a static body is added or moved, and
+    // only dynamic bodies are paired against it. The broadphase indexes the
+    // dynamic bodies in storage order without gaps.
+    static constexpr uint32_t NotDynamic = 0xFFFFFFFF;
+    StaticTree staticTree;               // reports indices into staticBodies
+    bool staticsDirty = false;
+    std::vector<AABB> staticBounds;      // per static body, as in the tree
+    std::vector<uint32_t> staticBodies;  // static index -> body
+    std::vector<uint32_t> dynamicBodies; // broadphase index -> body
+    std::vector<uint32_t> dynamicSlot;   // body -> broadphase index, NotDynamic for static bodies
+    size_t indexedBodies = 0;            // bodies the broadphase and static tree knew at the last update
+
+    // Dynamic bodies query the static tree with their bounds grown by
+    // staticReachMargin and keep the result while they stay inside that box,
+    // so resting and slow bodies skip the query. staticReach is per broadphase
+    // index, staticFatPairs holds (broadphase index, static index), sorted.
+    static constexpr float staticReachMargin = 4.0f;
+    std::vector<AABB> staticReach;
+    std::vector<BodyPair> staticFatPairs, staticNewPairs, staticMerged;
+    std::vector<std::vector<BodyPair>> staticChunkPairs;
+    std::vector<uint8_t> reachMoved;
+    std::vector<uint32_t> reachMovedList;
+
+    // Per-step scratch, kept to reuse capacity between steps. bounds and
+    // statics are in broadphase order.
+    std::vector<AABB> bounds;
+    std::vector<uint8_t> statics;
+    std::vector<BodyPair> dynamicPairs, staticPairs;
+    std::vector<BodyPair> pairs;
+    std::vector<ContactManifold> manifolds;
+
+    // Spring forces of this step, by spring, and the bodies they link
+    std::vector<float> springForceX, springForceY;
+    std::vector<BodyPair> springLinks;
+
+    // Continuous collision: bullets of this step and where they started
+    size_t bulletCount = 0;
+    std::vector<uint32_t> bullets;
+    std::vector<Vector2D> bulletStart;
+
+    // Fixed stepping: unsimulated time and positions before the last step
+    float accumulator = 0.0f;
+    std::vector<float> previousX, previousY;
+
+    // Bodies no longer covered by their bounds in the broadphase, moved by the
+    // position solver or teleported since. Queries test them directly.
+    std::vector<uint32_t> movedBodies;
+    std::vector<uint8_t> moved; // per body, 1 when listed in movedBodies
+
+    void markMoved(uint32_t i) {
+        if (i >= moved.size() || moved[i]) return;
+        moved[i] = 1;
+        movedBodies.push_back(i);
+    }
+    void clearMoved() {
+        for (uint32_t i : movedBodies) moved[i] = 0;
+        movedBodies.clear();
+    }
+
+    // Runs fn(begin, end) over [0, count) on the job system if there is one
+    template <typename Fn>
+    void forRange(size_t count, size_t grain, Fn&& fn) const {
+        if (jobs) jobs->parallel_for(0, count, grain, fn);
+        else fn(0, count);
+    }
+
+    // fn(i) once for every body whose current bounds overlap box
+    template <typename Fn>
+    void forEachCandidate(const AABB& box, Fn&& fn) const;
+
+    // Query helpers emitting body handles through fn
+    template <typename Fn>
+    void forEachOverlap(const Collider& shape, const AABB& box, Fn&& fn) const;
+    template <typename Fn>
+    void forEachNearest(Vector2D point, size_t k, Fn&& fn) const;
+
+    // Runs query(q, emit) for every query of a batch and streams the handles
+    // it emits into handles; see overlapAABBBatch
+    template <typename Query>
+    size_t streamBatch(size_t queryCount, std::span<BodyHandle> handles, std::span<QueryRange> ranges,
+                       Query&& query) const;
+
+    // Closest hits of up to Broadphase::RayPacketSize rays traversed together
+    void raycastPacket(const RayQuery* rays, uint32_t count, RayHit* hits) const;
+
+    void applyForces();
+    void integrate(float dt);
+
+    // Wake every body of a generator's list, or every body for an empty one
+    void wakeBodies(std::span<const BodyHandle> bodies) {
+        if (bodies.empty()) {
+            for (uint32_t i = 0; i < storage.size(); ++i) islands.wake(storage, i);
+        }
+        for (BodyHandle body : bodies) islands.wake(storage, storage.indexOf(body));
+    }
+
+    Vector2D interpolatedPosition(uint32_t i) const {
+        const Vector2D current(storage.posX[i], storage.posY[i]);
+        // Bodies created since the last fixed step have no previous position
+        if (i >= previousX.size()) return current;
+        const float alpha = getInterpolationAlpha();
+        return Vector2D(previousX[i] + (current.x - previousX[i]) * alpha,
+                        previousY[i] + (current.y - previousY[i]) * alpha);
+    }
+    void rebuildStaticTree(float halfMargin);
+    void findStaticPairs();
+    void gatherBullets();
+    void sweepBullets();
 
 public:
-    PhysicsWorld(Vector2D g = Vector2D(0, 9.8f)) : gravity(g) {}
+    PhysicsWorld(Vector2D g = Vector2D(0, 9.8f))
+        : gravity(g), broadphase(std::make_unique<BruteForceBroadphase>()) {}
+
+    // Compatibility layer: the body's state is copied into the storage and the
+    // object itself is released
+    BodyHandle addBody(std::unique_ptr<PhysicsBody> body);
 
-    void addBody(std::unique_ptr<PhysicsBody> body) {
-        bodies.push_back(std::move(body));
+    BodyHandle createBody(const BodyDef& def) {
+        if (recorder) recorder->recordCreateBody(def);
+        const BodyHandle handle = storage.add(def);
+        const uint32_t i = storage.indexOf(handle);
+        if (storage.isBullet(i)) ++bulletCount;
+        if (def.filter != CollisionFilter()) ++filteredCount;
+        if (def.isStatic) {
+            dynamicSlot.push_back(NotDynamic);
+            staticsDirty = true;
+        } else {
+            dynamicSlot.push_back(static_cast<uint32_t>(dynamicBodies.size()));
+            dynamicBodies.push_back(i);
+        }
+        return handle;
     }
 
     void setGravity(Vector2D g) {
+        if (recorder) recorder->recordGravity(g);
         gravity = g;
     }
 
-    void update(float dt) {
-        // Apply gravity to all non-static bodies
-        for (auto& body : bodies) {
-            if (!body->isStatic) {
-                body->applyForce(gravity * body->mass);
-            }
-        }
+    // Only dynamic bodies go through the broadphase, static ones are kept
+    // apart. Queries scan all bodies until the next update fills it.
+    void setBroadphase(std::unique_ptr<Broadphase> bp) {
+        broadphase = std::move(bp);
+        broadphase->setJobSystem(jobs);
+        indexedBodies = 0;
+    }
 
-        // Update all bodies
-        for (auto& body : bodies) {
-            body->update(dt);
-        }
+    // Pool the step phases run on. Not owned, nullptr runs single threaded.
+    // Results are identical for any thread count.
+    void setJobSystem(RK::JobSystem* jobSystem) {
+        jobs = jobSystem;
+        broadphase->setJobSystem(jobs);
+    }
+
+    Broadphase& getBroadphase() const {
+        return *broadphase;
+    }
 
-        // Check collisions
-        for (size_t i = 0; i < bodies.size(); ++i) {
-            for (size_t j = i + 1; j < bodies.size(); ++j) {
-                if (bodies[i]->checkCollision(*bodies[j])) {
-                    bodies[i]->resolveCollision(*bodies[j]);
-                }
-            }
+    // Integration kernel, defaults to the best the CPU supports
+    void setSimdLevel(SimdLevel level) {
+        simdLevel = level;
+    }
+
+    ContactSolver& getSolver() {
+        return solver;
+    }
+
+    IslandManager& getIslands() {
+        return islands;
+    }
+
+#if PHYSICS_PROFILER
+    // Phase timings and counters of recent updates. Not there at all when
+    // the library is built without PHYSICS_PROFILER.
+    StepProfiler& getProfiler() {
+        return profiler;
+    }
+#endif
+
+    // Body state for other threads. Set getSnapshots().enabled to publish one
+    // after every update; readers call getSnapshots().acquire() from any
+    // thread while the world keeps stepping.
+    SnapshotPublisher& getSnapshots() {
+        return snapshots;
+    }
+
+    // Record every input from now on into log (not owned), with the state
+    // hash after each update; nullptr stops recording. Replay it with
+    // replay() from Replay.h. Start recording on a new world so the log holds
+    // all bodies.
+    void setRecorder(ReplayLog* log) {
+        recorder = log;
+    }
+
+    // Contact begin and end events of every update go to listener (not
+    // owned), nullptr stops them. Contacts of awake bodies that exist when a
+    // listener is set are reported as begun on the next update, those of
+    // sleeping bodies once they wake.
+    void setContactListener(ContactListener* listener) {
+        contactListener = listener;
+        contactTracker.clear();
+    }
+
+    // Manifolds solved during the last update
+    const std::vector<ContactManifold>& getContacts() const {
+        return manifolds;
+    }
+
+    TimeStepSettings timeStep;
+
+    // Simulate dt seconds with a fixed step of exactly dt
+    void update(float dt);
+
+    // Simulate frameTime seconds of caller time in whole fixed steps and
+    // return how many were taken. The remainder carries over to the next call;
+    // read the state in between through the interpolated accessors.
+    int advance(float frameTime);
+
+    // Fraction of a fixed step simulated ahead of the interpolated state
+    float getInterpolationAlpha() const {
+        return accumulator / timeStep.fixedDt;
+    }
+
+    // Position between the last two fixed steps at getInterpolationAlpha()
+    Vector2D getInterpolatedPosition(BodyHandle body) const {
+        return interpolatedPosition(storage.indexOf(body));
+    }
+
+    // Interpolated positions of all bodies in storage order
+    void getInterpolatedPositions(std::vector<Vector2D>& out) const {
+        out.resize(storage.size());
+        for (uint32_t i = 0; i < storage.size(); ++i) out[i] = interpolatedPosition(i);
+    }
+
+    void draw() const;
+
+    // ---------  Spatial queries (Query.cpp) ----------------
+    // Served by the broadphase and the static tree from the bounds of the
+    // last update, plus a direct test of bodies created or moved since.
+    // Results are exact for the current shapes. Queries are const and may
+    // run on any number of threads, but not during update().
+
+    // Closest body along the segment from -> to. False if there is none.
+    bool raycast(Vector2D from, Vector2D to, RayHit& hit) const;
+
+    // Bodies overlapping the box or circle, in no particular order
+    void overlapAABB(const AABB& box, std::vector<BodyHandle>& out) const;
+    void overlapCircle(Vector2D centre, float radius, std::vector<BodyHandle>& out) const;
+
+    // The k bodies closest to point, nearest first; ties go to the lower handle
+    // id. Bodies containing the point are at distance 0.
+    void kNearest(Vector2D point, size_t k, std::vector<BodyHandle>& out) const;
+
+    // Batched forms, spread over the job system, writing into caller buffers
+    // without allocating per query. Rays go through the broadphase in packets
+    // of consecutive rays, so batches ordered by origin, like the rays of one
+    // observer, share most of their traversal. hits must hold one hit per ray.
+    void raycastBatch(std::span<const RayQuery> rays, std::span<RayHit> hits) const;
+
+    // Query q's bodies are handles[ranges[q].offset, + ranges[q].count); ranges
+    // must hold one entry per query. Blocks of queries land in handles in
+    // scheduling order. Returns the number of handles all queries found; if
+    // that exceeds handles.size(), queries that did not fit have offset
+    // QueryRange::NoSpace and the batch can be rerun with a larger buffer.
+    size_t overlapAABBBatch(std::span<const AABB> boxes, std::span<BodyHandle> handles,
+                            std::span<QueryRange> ranges) const;
+    size_t overlapCircleBatch(std::span<const CircleQuery> circles, std::span<BodyHandle> handles,
+                              std::span<QueryRange> ranges) const;
+    size_t kNearestBatch(std::span<const NearestQuery> queries, std::span<BodyHandle> handles,
+                         std::span<QueryRange> ranges) const;
+
+    // Binary checkpoint of the whole simulation state (see Checkpoint.h):
+    // bodies, gravity, time stepping and the solver's warm-start cache.
+    // Handles stay valid across a save and load. False on I/O errors and, for
+    // loading, on files that are truncated or of another version, in which
+    // case the world is left untouched. The broadphase catches up on the next
+    // update.
+    bool saveCheckpoint(const char* path) const;
+    bool loadCheckpoint(const char* path);
+
+    size_t getBodyCount() const {
+        return storage.size();
+    }
+
+    const BodyStorage& getStorage() const {
+        return storage;
+    }
+
+    // ---------  Per-body access through handles ----------------
+    Vector2D getPosition(BodyHandle body) const {
+        const uint32_t i = storage.indexOf(body);
+        return Vector2D(storage.posX[i], storage.posY[i]);
+    }
+
+    Vector2D getVelocity(BodyHandle body) const {
+        const uint32_t i = storage.indexOf(body);
+        return Vector2D(storage.velX[i], storage.velY[i]);
+    }
+
+    bool isAwake(BodyHandle body) const {
+        return !storage.isSleeping(storage.indexOf(body));
+    }
+
+    // Wake the body and every body sleeping in the same island
+    void wake(BodyHandle body) {
+        if (recorder) recorder->recordWake(body);
+        islands.wake(storage, storage.indexOf(body));
+    }
+
+    // Bullets are swept from their old to their new position every step and
+    // stop at the first body in the way instead of passing through it. Only
+    // circles can be bullets.
+    void setBullet(BodyHandle body, bool bullet) {
+        if (recorder) recorder->recordBullet(body, bullet);
+        const uint32_t i = storage.indexOf(body);
+        if (storage.isStatic(i) || storage.shape[i] != ShapeType::Circle || bullet == storage.isBullet(i)) return;
+        if (bullet) {
+            storage.flags[i] |= BodyFlagBullet;
+            ++bulletCount;
+        } else {
+            storage.flags[i] &= ~BodyFlagBullet;
+            --bulletCount;
         }
     }
 
-    void draw() const {
-        std::cout << "=== Physics World ===" << std::endl;
-        for (const auto& body : bodies) {
-            body->draw();
+    bool isBullet(BodyHandle body) const {
+        return storage.isBullet(storage.indexOf(body));
+    }
+
+    // Pairs the filters reject are dropped right after the broadphase, before
+    // any narrowphase work. Wakes the body, so it meets its new partners.
+    void setFilter(BodyHandle body, const CollisionFilter& filter) {
+        if (recorder) recorder->recordFilter(body, filter);
+        const uint32_t i = storage.indexOf(body);
+        islands.wake(storage, i);
+        if (storage.filter[i] != CollisionFilter()) --filteredCount;
+        if (filter != CollisionFilter()) ++filteredCount;
+        storage.filter[i] = filter;
+    }
+
+    const CollisionFilter& getFilter(BodyHandle body) const {
+        return storage.filter[storage.indexOf(body)];
+    }
+
+    // ---------  Force generators (Force.cpp) ----------------
+    // Evaluated at the start of every update and integrated with gravity and
+    // the forces from applyForce. They act on awake dynamic bodies only, but
+    // adding, changing or removing a generator wakes the bodies it acts on,
+    // like applyForce does. Bodies joined by a spring sleep and wake
+    // together. Generators are recorded in replay logs but are not part of
+    // checkpoints: register the same ones on a world before loading into it.
+    const ForceRegistry& getForces() const {
+        return forces;
+    }
+
+    // Index into getForces().springs; removing a spring gives its index to
+    // the last one
+    uint32_t addSpring(const SpringDef& def) {
+        if (recorder) recorder->recordAddSpring(def);
+        islands.wake(storage, storage.indexOf(def.a));
+        islands.wake(storage, storage.indexOf(def.b));
+        return forces.springs.add(def);
+    }
+
+    void removeSpring(uint32_t spring) {
+        if (recorder) recorder->recordRemoveSpring(spring);
+        islands.wake(storage, storage.indexOf(forces.springs.a[spring]));
+        islands.wake(storage, storage.indexOf(forces.springs.b[spring]));
+        forces.springs.remove(spring);
+    }
+
+    // Per-body generators acting on bodies, or on every body when it is
+    // empty. Return the index into getForces().drags, radials or winds, which
+    // the setters take to change the parameters between updates.
+    uint32_t addDrag(const DragForce& drag, std::span<const BodyHandle> bodies = {}) {
+        if (recorder) recorder->recordAddDrag(drag, bodies);
+        wakeBodies(bodies);
+        return ForceRegistry::add(forces.drags, drag, bodies);
+    }
+
+    uint32_t addRadialForce(const RadialForce& field, std::span<const BodyHandle> bodies = {}) {
+        if (recorder) recorder->recordAddRadialForce(field, bodies);
+        wakeBodies(bodies);
+        return ForceRegistry::add(forces.radials, field, bodies);
+    }
+
+    uint32_t addWind(const WindForce& wind, std::span<const BodyHandle> bodies = {}) {
+        if (recorder) recorder->recordAddWind(wind, bodies);
+        wakeBodies(bodies);
+        return ForceRegistry::add(forces.winds, wind, bodies);
+    }
+
+    void setDrag(uint32_t index, const DragForce& drag) {
+        if (recorder) recorder->recordSetDrag(index, drag);
+        wakeBodies(forces.drags[index].bodies);
+        forces.drags[index].params = drag;
+    }
+
+    void setRadialForce(uint32_t index, const RadialForce& field) {
+        if (recorder) recorder->recordSetRadialForce(index, field);
+        wakeBodies(forces.radials[index].bodies);
+        forces.radials[index].params = field;
+    }
+
+    void setWind(uint32_t index, const WindForce& wind) {
+        if (recorder) recorder->recordSetWind(index, wind);
+        wakeBodies(forces.winds[index].bodies);
+        forces.winds[index].params = wind;
+    }
+
+    // Setting the state or applying a force wakes a sleeping body
+    void setPosition(BodyHandle body, Vector2D position) {
+        if (recorder) recorder->recordPosition(body, position);
+        const uint32_t i = storage.indexOf(body);
+        islands.wake(storage, i);
+        storage.posX[i] = position.x;
+        storage.posY[i] = position.y;
+        markMoved(i);
+        if (storage.isStatic(i)) staticsDirty = true;
+        // A teleport is not interpolated
+        if (i < previousX.size()) {
+            previousX[i] = position.x;
+            previousY[i] = position.y;
         }
-        std::cout << std::endl;
     }
 
-    size_t getBodyCount() const {
-        return bodies.size();
+    void setVelocity(BodyHandle body, Vector2D velocity) {
+        if (recorder) recorder->recordVelocity(body, velocity);
+        const uint32_t i = storage.indexOf(body);
+        islands.wake(storage, i);
+        storage.velX[i] = velocity.x;
+        storage.velY[i] = velocity.y;
+    }
+
+    // Force applied during the next update
+    void applyForce(BodyHandle body, Vector2D force) {
+        if (recorder) recorder->recordForce(body, force);
+        const uint32_t i = storage.indexOf(body);
+        if (storage.isStatic(i)) return;
+        islands.wake(storage, i);
+        storage.forceX[i] += force.x;
+        storage.forceY[i] += force.y;
     }
 };
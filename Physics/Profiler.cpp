@@ -0,0 +1,77 @@
+#include <Physics/Profiler.h>
+#include <algorithm>
+#include <cmath>
+
+const char* profilePhaseName(ProfilePhase phase) {
+    switch (phase) {
+    case ProfilePhase::Forces: return "forces";
+    case ProfilePhase::Integrate: return "integrate";
+    case ProfilePhase::Broadphase: return "broadphase";
+    case ProfilePhase::Narrowphase: return "narrowphase";
+    case ProfilePhase::Resolve: return "resolve";
+    case ProfilePhase::Islands: return "islands";
+    case ProfilePhase::Count: break;
+    }
+    return "unknown";
+}
+
+template <typename Field>
+ProfileSummary StepProfiler::summarizeField(Field&& field) const {
+    ProfileSummary summary;
+    if (count == 0) return summary;
+
+    scratch.resize(count);
+    for (size_t i = 0; i < count; ++i) scratch[i] = field(record(i));
+
+    // Nearest rank: the smallest value with at least p of the frames at or below it
+    const auto rank = [this](double p) {
+        const size_t r = static_cast<size_t>(std::ceil(p * static_cast<double>(count)));
+        return std::clamp<size_t>(r, 1, count) - 1;
+    };
+    const size_t r50 = rank(0.50);
+    const size_t r99 = rank(0.99);
+    std::nth_element(scratch.begin(), scratch.begin() + r50, scratch.end());
+    summary.p50 = scratch[r50];
+    std::nth_element(scratch.begin() + r50, scratch.begin() + r99, scratch.end());
+    summary.p99 = scratch[r99];
+    summary.max = *std::max_element(scratch.begin() + r99, scratch.end());
+    return summary;
+}
+
+ProfileSummary StepProfiler::summarize(ProfilePhase phase) const {
+    const size_t p = static_cast<size_t>(phase);
+    return summarizeField([p](const FrameRecord& r) { return r.phaseNs[p]; });
+}
+
+ProfileSummary StepProfiler::summarizeTotal() const {
+    return summarizeField([](const FrameRecord& r) { return r.totalNs; });
+}
+
+void StepProfiler::writeCsv(std::ostream& out) const {
+    out << "frame,total_ns";
+    for (size_t p = 0; p < ProfilePhaseCount; ++p) {
+        out << ',' << profilePhaseName(static_cast<ProfilePhase>(p)) << "_ns";
+    }
+    out << ",candidate_pairs,contacts,awake_bodies\n";
+
+    for (size_t i = 0; i < count; ++i) {
+        const FrameRecord& r = record(i);
+        out << r.frame << ',' << r.totalNs;
+        for (size_t p = 0; p < ProfilePhaseCount; ++p) out << ',' << r.phaseNs[p];
+        out << ',' << r.candidatePairs << ',' << r.contacts << ',' << r.awakeBodies << '\n';
+    }
+}
+
+void StepProfiler::writeJson(std::ostream& out) const {
+    out << "[";
+    for (size_t i = 0; i < count; ++i) {
+        const FrameRecord& r = record(i);
+        out << (i ? ",\n " : "\n ") << "{\"frame\": " << r.frame << ", \"total_ns\": " << r.totalNs;
+        for (size_t p = 0; p < ProfilePhaseCount; ++p) {
+            out << ", \"" << profilePhaseName(static_cast<ProfilePhase>(p)) << "_ns\": " << r.phaseNs[p];
+        }
+        out << ", \"candidate_pairs\": " << r.candidatePairs << ", \"contacts\": " << r.contacts
+            << ", \"awake_bodies\": " << r.awakeBodies << "}";
+    }
+    out << (count ? "\n]\n" : "]\n");
+}
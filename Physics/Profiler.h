@@ -0,0 +1,141 @@
+#pragma once
+
+// Per-phase timing and counters of PhysicsWorld::update.
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Set by the PHYSICS_PROFILER CMake option. When 0 the profile macros expand
+// to nothing and PhysicsWorld has no profiler member.
+#ifndef PHYSICS_PROFILER
+#define PHYSICS_PROFILER 1
+#endif
+
+enum class ProfilePhase : uint8_t {
+    Forces,
+    Integrate,
+    Broadphase,
+    Narrowphase,
+    Resolve,
+    Islands,
+    Count
+};
+
+const char* profilePhaseName(ProfilePhase phase);
+
+constexpr size_t ProfilePhaseCount = static_cast<size_t>(ProfilePhase::Count);
+
+// Everything recorded for one update
+struct FrameRecord {
+    uint64_t frame = 0;
+    uint64_t totalNs = 0;
+    uint64_t phaseNs[ProfilePhaseCount] = {};
+    uint32_t candidatePairs = 0;
+    uint32_t contacts = 0;
+    uint32_t awakeBodies = 0;
+};
+
+struct ProfileSummary {
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+};
+
+// Ring buffer of the last `capacity` frame records. The world opens a record
+// in beginFrame, phases add their time to it and endFrame closes it. A
+// capacity of 0 is raised to 1.
+class StepProfiler {
+public:
+    explicit StepProfiler(size_t capacity = 1024) : records(capacity > 0 ? capacity : 1) {}
+
+    void beginFrame() {
+        FrameRecord& record = records[head];
+        record = FrameRecord();
+        record.frame = frameCount;
+        frameStart = now();
+    }
+
+    void endFrame() {
+        records[head].totalNs = now() - frameStart;
+        head = (head + 1) % records.size();
+        if (count < records.size()) ++count;
+        ++frameCount;
+    }
+
+    // Record being written, valid between beginFrame and endFrame
+    FrameRecord& current() { return records[head]; }
+
+    void addTime(ProfilePhase phase, uint64_t ns) {
+        records[head].phaseNs[static_cast<size_t>(phase)] += ns;
+    }
+
+    // Recorded frames, oldest first
+    size_t size() const { return count; }
+    size_t capacity() const { return records.size(); }
+    const FrameRecord& record(size_t i) const {
+        return records[(head + records.size() - count + i) % records.size()];
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    ProfileSummary summarize(ProfilePhase phase) const;
+    ProfileSummary summarizeTotal() const;
+
+    // One row / object per recorded frame, oldest first
+    void writeCsv(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    template <typename Field>
+    ProfileSummary summarizeField(Field&& field) const;
+
+    std::vector<FrameRecord> records;
+    size_t head = 0;            // slot of the current frame
+    size_t count = 0;
+    uint64_t frameCount = 0;
+    uint64_t frameStart = 0;
+    mutable std::vector<uint64_t> scratch;
+};
+
+// Adds the time until the end of the scope to a phase of the current frame
+class ProfileScope {
+public:
+    ProfileScope(StepProfiler& profiler, ProfilePhase phase)
+        : profiler(profiler), phase(phase), start(StepProfiler::now()) {}
+    ~ProfileScope() { profiler.addTime(phase, StepProfiler::now() - start); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    StepProfiler& profiler;
+    ProfilePhase phase;
+    uint64_t start;
+};
+
+#define PHYSICS_PROFILE_CONCAT_(a, b) a##b
+#define PHYSICS_PROFILE_CONCAT(a, b) PHYSICS_PROFILE_CONCAT_(a, b)
+
+#if PHYSICS_PROFILER
+#define PHYSICS_PROFILE_BEGIN(profiler) (profiler).beginFrame()
+#define PHYSICS_PROFILE_END(profiler) (profiler).endFrame()
+#define PHYSICS_PROFILE_SCOPE(profiler, phase) \
+    ProfileScope PHYSICS_PROFILE_CONCAT(profileScope, __LINE__)((profiler), (phase))
+#define PHYSICS_PROFILE_COUNT(profiler, counter, value) \
+    ((profiler).current().counter = static_cast<uint32_t>(value))
+#else
+#define PHYSICS_PROFILE_BEGIN(profiler) ((void)0)
+#define PHYSICS_PROFILE_END(profiler) ((void)0)
+#define PHYSICS_PROFILE_SCOPE(profiler, phase) ((void)0)
+#define PHYSICS_PROFILE_COUNT(profiler, counter, value) ((void)0)
+#endif
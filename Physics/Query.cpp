@@ -0,0 +1,223 @@
+#include <Physics/PhysicsWorld.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace {
+
+// Per-thread scratch, so queries on any thread reuse their memory
+thread_local std::vector<std::pair<float, uint32_t>> nearestScratch; // distance, handle id
+thread_local std::vector<BodyHandle> batchScratch;
+
+// Keeps the closest hit, the lower handle id on a tie
+void keepClosest(const BodyStorage& storage, uint32_t i, Vector2D from, Vector2D delta, RayHit& hit) {
+    float fraction;
+    Vector2D normal;
+    if (!raycast(storage.collider(i), from, delta, fraction, normal)) return;
+    const BodyHandle body = storage.handleAt(i);
+    if (hit.body.isValid() && (fraction > hit.fraction || (fraction == hit.fraction && body.id > hit.body.id))) return;
+    hit.body = body;
+    hit.fraction = fraction;
+    hit.normal = normal;
+}
+
+} // namespace
+
+template <typename Fn>
+void PhysicsWorld::forEachCandidate(const AABB& box, Fn&& fn) const {
+    // Bodies created since the last update are unknown to the broadphase
+    // and the static tree
+    const uint32_t indexed = static_cast<uint32_t>(indexedBodies);
+    if (indexed > 0) {
+        const uint32_t known = static_cast<uint32_t>(broadphase->getIndexedCount());
+        broadphase->query(box, [&](uint32_t k) {
+            if (k < known && !moved[dynamicBodies[k]]) fn(dynamicBodies[k]);
+            return true;
+        });
+        staticTree.query(box, [&](uint32_t c) {
+            if (!moved[staticBodies[c]]) fn(staticBodies[c]);
+            return true;
+        });
+    }
+    for (uint32_t i : movedBodies) {
+        if (i < indexed && storage.bounds(i).overlaps(box)) fn(i);
+    }
+    for (uint32_t i = indexed; i < storage.size(); ++i) {
+        if (storage.bounds(i).overlaps(box)) fn(i);
+    }
+}
+
+template <typename Fn>
+void PhysicsWorld::forEachOverlap(const Collider& shape, const AABB& box, Fn&& fn) const {
+    forEachCandidate(box, [&](uint32_t i) {
+        Contact contact;
+        if (collide(shape, storage.collider(i), contact)) fn(storage.handleAt(i));
+    });
+}
+
+template <typename Fn>
+void PhysicsWorld::forEachNearest(Vector2D point, size_t k, Fn&& fn) const {
+    k = std::min(k, storage.size());
+    if (k == 0) return;
+
+    // Every body within distance r overlaps the square of half size r around
+    // the point. Double r until k bodies are within it or the square holds
+    // all bodies.
+    std::vector<std::pair<float, uint32_t>>& found = nearestScratch;
+    for (float r = 8.0f;; r *= 2.0f) {
+        found.clear();
+        size_t within = 0;
+        const AABB box(Vector2D(point.x - r, point.y - r), Vector2D(point.x + r, point.y + r));
+        forEachCandidate(box, [&](uint32_t i) {
+            const float d = distanceTo(storage.collider(i), point);
+            if (d <= r) ++within;
+            found.emplace_back(d, storage.ids[i]);
+        });
+        if (within >= k || found.size() == storage.size() || r == std::numeric_limits<float>::infinity()) break;
+    }
+
+    k = std::min(k, found.size());
+    std::partial_sort(found.begin(), found.begin() + k, found.end());
+    for (size_t i = 0; i < k; ++i) fn(BodyHandle{found[i].second});
+}
+
+bool PhysicsWorld::raycast(Vector2D from, Vector2D to, RayHit& hit) const {
+    hit = RayHit();
+    const Vector2D delta = to - from;
+    const uint32_t indexed = static_cast<uint32_t>(indexedBodies);
+
+    for (uint32_t i : movedBodies) {
+        if (i < indexed) keepClosest(storage, i, from, delta, hit);
+    }
+    for (uint32_t i = indexed; i < storage.size(); ++i) keepClosest(storage, i, from, delta, hit);
+    if (indexed > 0) {
+        const uint32_t known = static_cast<uint32_t>(broadphase->getIndexedCount());
+        broadphase->queryRay(from, to, [&](uint32_t k) {
+            if (k < known && !moved[dynamicBodies[k]]) keepClosest(storage, dynamicBodies[k], from, delta, hit);
+            return hit.fraction;
+        });
+        staticTree.raycast(from, to, hit.fraction, [&](uint32_t c) {
+            if (!moved[staticBodies[c]]) keepClosest(storage, staticBodies[c], from, delta, hit);
+            return hit.fraction;
+        });
+    }
+
+    if (!hit.body.isValid()) return false;
+    hit.point = from + delta * hit.fraction;
+    return true;
+}
+
+void PhysicsWorld::raycastPacket(const RayQuery* rays, uint32_t count, RayHit* hits) const {
+    const uint32_t indexed = static_cast<uint32_t>(indexedBodies);
+    Vector2D from[Broadphase::RayPacketSize], to[Broadphase::RayPacketSize], delta[Broadphase::RayPacketSize];
+    for (uint32_t r = 0; r < count; ++r) {
+        from[r] = rays[r].from;
+        to[r] = rays[r].to;
+        delta[r] = to[r] - from[r];
+        hits[r] = RayHit();
+        for (uint32_t i : movedBodies) {
+            if (i < indexed) keepClosest(storage, i, from[r], delta[r], hits[r]);
+        }
+        for (uint32_t i = indexed; i < storage.size(); ++i) keepClosest(storage, i, from[r], delta[r], hits[r]);
+    }
+
+    if (indexed > 0) {
+        const uint32_t known = static_cast<uint32_t>(broadphase->getIndexedCount());
+        broadphase->queryRayPacket(from, to, count, [&](uint32_t r, uint32_t k) {
+            if (k < known && !moved[dynamicBodies[k]]) keepClosest(storage, dynamicBodies[k], from[r], delta[r], hits[r]);
+            return hits[r].fraction;
+        });
+    }
+
+    // Static geometry ray by ray, each clipped to what the packet already hit
+    for (uint32_t r = 0; r < count; ++r) {
+        if (indexed > 0) {
+            staticTree.raycast(from[r], to[r], hits[r].fraction, [&](uint32_t c) {
+                if (!moved[staticBodies[c]]) keepClosest(storage, staticBodies[c], from[r], delta[r], hits[r]);
+                return hits[r].fraction;
+            });
+        }
+        if (hits[r].body.isValid()) hits[r].point = from[r] + delta[r] * hits[r].fraction;
+    }
+}
+
+void PhysicsWorld::overlapAABB(const AABB& box, std::vector<BodyHandle>& out) const {
+    out.clear();
+    const Collider shape{ShapeType::Rectangle, box.min, box.max - box.min};
+    forEachOverlap(shape, box, [&](BodyHandle body) { out.push_back(body); });
+}
+
+void PhysicsWorld::overlapCircle(Vector2D centre, float radius, std::vector<BodyHandle>& out) const {
+    out.clear();
+    const Collider shape{ShapeType::Circle, centre, Vector2D(radius, 0)};
+    const AABB box(Vector2D(centre.x - radius, centre.y - radius), Vector2D(centre.x + radius, centre.y + radius));
+    forEachOverlap(shape, box, [&](BodyHandle body) { out.push_back(body); });
+}
+
+void PhysicsWorld::kNearest(Vector2D point, size_t k, std::vector<BodyHandle>& out) const {
+    out.clear();
+    forEachNearest(point, k, [&](BodyHandle body) { out.push_back(body); });
+}
+
+// Each chunk of queries gathers its handles in the thread's scratch, claims
+// one block of the caller's buffer with a single atomic add and copies them
+// over, so threads only meet once per chunk
+template <typename Query>
+size_t PhysicsWorld::streamBatch(size_t queryCount, std::span<BodyHandle> handles, std::span<QueryRange> ranges,
+                                 Query&& query) const {
+    std::atomic<size_t> cursor{0};
+    forRange(queryCount, 64, [&](size_t begin, size_t end) {
+        std::vector<BodyHandle>& scratch = batchScratch;
+        scratch.clear();
+        for (size_t q = begin; q < end; ++q) {
+            const size_t first = scratch.size();
+            query(q, [&](BodyHandle body) { scratch.push_back(body); });
+            ranges[q].offset = static_cast<uint32_t>(first);
+            ranges[q].count = static_cast<uint32_t>(scratch.size() - first);
+        }
+
+        const size_t base = cursor.fetch_add(scratch.size(), std::memory_order_relaxed);
+        const bool fits = base + scratch.size() <= handles.size();
+        for (size_t q = begin; q < end; ++q) {
+            ranges[q].offset = fits ? static_cast<uint32_t>(base + ranges[q].offset) : QueryRange::NoSpace;
+        }
+        if (fits && !scratch.empty()) std::memcpy(handles.data() + base, scratch.data(), scratch.size() * sizeof(BodyHandle));
+    });
+    return cursor.load(std::memory_order_relaxed);
+}
+
+void PhysicsWorld::raycastBatch(std::span<const RayQuery> rays, std::span<RayHit> hits) const {
+    const uint32_t packet = Broadphase::RayPacketSize;
+    forRange(rays.size(), 4 * packet, [&](size_t begin, size_t end) {
+        for (size_t q = begin; q < end; q += packet) {
+            raycastPacket(rays.data() + q, static_cast<uint32_t>(std::min<size_t>(packet, end - q)), hits.data() + q);
+        }
+    });
+}
+
+size_t PhysicsWorld::overlapAABBBatch(std::span<const AABB> boxes, std::span<BodyHandle> handles,
+                                      std::span<QueryRange> ranges) const {
+    return streamBatch(boxes.size(), handles, ranges, [&](size_t q, auto&& emit) {
+        const AABB& box = boxes[q];
+        forEachOverlap(Collider{ShapeType::Rectangle, box.min, box.max - box.min}, box, emit);
+    });
+}
+
+size_t PhysicsWorld::overlapCircleBatch(std::span<const CircleQuery> circles, std::span<BodyHandle> handles,
+                                        std::span<QueryRange> ranges) const {
+    return streamBatch(circles.size(), handles, ranges, [&](size_t q, auto&& emit) {
+        const Vector2D c = circles[q].centre;
+        const float r = circles[q].radius;
+        forEachOverlap(Collider{ShapeType::Circle, c, Vector2D(r, 0)},
+                       AABB(Vector2D(c.x - r, c.y - r), Vector2D(c.x + r, c.y + r)), emit);
+    });
+}
+
+size_t PhysicsWorld::kNearestBatch(std::span<const NearestQuery> queries, std::span<BodyHandle> handles,
+                                   std::span<QueryRange> ranges) const {
+    return streamBatch(queries.size(), handles, ranges, [&](size_t q, auto&& emit) {
+        forEachNearest(queries[q].point, queries[q].k, emit);
+    });
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Spatial queries against the bodies of a PhysicsWorld: rays, box and circle
+// overlaps and nearest neighbours. They are served by the world's broadphase,
+// see PhysicsWorld::raycast and friends.
+
+#include <Physics/BodyStorage.h>
+#include <Physics/Vector2D.h>
+
+// Closest body along a ray
+struct RayHit {
+    BodyHandle body;          // invalid when nothing was hit
+    Vector2D point;
+    Vector2D normal;          // surface normal, zero for a ray starting inside the body
+    float fraction = 1.0f;    // of the way from the ray's start to its end
+};
+
+// Inputs of the batched queries
+struct RayQuery {
+    Vector2D from;
+    Vector2D to;
+};
+
+struct CircleQuery {
+    Vector2D centre;
+    float radius = 0.0f;
+};
+
+struct NearestQuery {
+    Vector2D point;
+    size_t k = 1;
+};
+
+// Where the results of one query of a batch landed in the caller's handle
+// buffer: handles[offset, offset + count)
+struct QueryRange {
+    static constexpr uint32_t NoSpace = 0xFFFFFFFFu;
+
+    uint32_t offset = 0;    // NoSpace when the buffer was too small for them
+    uint32_t count = 0;
+};
@@ -0,0 +1,367 @@
+#include <Physics/Replay.h>
+#include <Physics/PhysicsWorld.h>
+#include <Shared/Hash.h>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+constexpr char ReplayMagic[8] = {'R', 'K', 'R', 'E', 'P', 'L', 'A', 'Y'};
+constexpr uint32_t ReplayVersion = 3;
+
+enum BodyDefBits : uint8_t {
+    DefStatic = 1 << 0,
+    DefBullet = 1 << 1,
+};
+
+template <typename T>
+bool take(const std::vector<uint8_t>& bytes, size_t& offset, T& value) {
+    if (offset + sizeof(T) > bytes.size()) return false;
+    std::memcpy(&value, bytes.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+bool takeVector(const std::vector<uint8_t>& bytes, size_t& offset, Vector2D& value) {
+    return take(bytes, offset, value.x) && take(bytes, offset, value.y);
+}
+
+bool takeFilter(const std::vector<uint8_t>& bytes, size_t& offset, CollisionFilter& filter) {
+    return take(bytes, offset, filter.category) && take(bytes, offset, filter.mask) && take(bytes, offset, filter.group);
+}
+
+bool takeBodies(const std::vector<uint8_t>& bytes, size_t& offset, std::vector<BodyHandle>& bodies) {
+    uint32_t count = 0;
+    if (!take(bytes, offset, count) || count > (bytes.size() - offset) / sizeof(uint32_t)) return false;
+    bodies.resize(count);
+    for (BodyHandle& body : bodies) take(bytes, offset, body.id);
+    return true;
+}
+
+bool takeRadial(const std::vector<uint8_t>& bytes, size_t& offset, RadialForce& field) {
+    return takeVector(bytes, offset, field.centre) && take(bytes, offset, field.strength) &&
+           take(bytes, offset, field.radius);
+}
+
+bool takeWind(const std::vector<uint8_t>& bytes, size_t& offset, WindForce& wind) {
+    return takeVector(bytes, offset, wind.velocity) && take(bytes, offset, wind.coefficient) &&
+           takeVector(bytes, offset, wind.region.min) && takeVector(bytes, offset, wind.region.max);
+}
+
+} // namespace
+
+/* ---------------------------- Recording --------------------------- */
+
+void ReplayLog::recordCreateBody(const BodyDef& def) {
+    put(ReplayOp::CreateBody);
+    put(def.shape);
+    put(static_cast<uint8_t>((def.isStatic ? DefStatic : 0) | (def.bullet ? DefBullet : 0)));
+    put(def.position.x);
+    put(def.position.y);
+    put(def.velocity.x);
+    put(def.velocity.y);
+    put(def.radius);
+    put(def.width);
+    put(def.height);
+    put(def.mass);
+    put(def.restitution);
+    put(def.filter.category);
+    put(def.filter.mask);
+    put(def.filter.group);
+}
+
+void ReplayLog::recordGravity(Vector2D gravity) {
+    put(ReplayOp::SetGravity);
+    put(gravity.x);
+    put(gravity.y);
+}
+
+void ReplayLog::putBodyValue(ReplayOp op, BodyHandle body, Vector2D value) {
+    put(op);
+    put(body.id);
+    put(value.x);
+    put(value.y);
+}
+
+void ReplayLog::recordForce(BodyHandle body, Vector2D force) {
+    putBodyValue(ReplayOp::ApplyForce, body, force);
+}
+
+void ReplayLog::recordPosition(BodyHandle body, Vector2D position) {
+    putBodyValue(ReplayOp::SetPosition, body, position);
+}
+
+void ReplayLog::recordVelocity(BodyHandle body, Vector2D velocity) {
+    putBodyValue(ReplayOp::SetVelocity, body, velocity);
+}
+
+void ReplayLog::recordBullet(BodyHandle body, bool bullet) {
+    put(ReplayOp::SetBullet);
+    put(body.id);
+    put(static_cast<uint8_t>(bullet));
+}
+
+void ReplayLog::recordWake(BodyHandle body) {
+    put(ReplayOp::Wake);
+    put(body.id);
+}
+
+void ReplayLog::recordFilter(BodyHandle body, const CollisionFilter& filter) {
+    put(ReplayOp::SetFilter);
+    put(body.id);
+    put(filter.category);
+    put(filter.mask);
+    put(filter.group);
+}
+
+void ReplayLog::recordAddSpring(const SpringDef& def) {
+    put(ReplayOp::AddSpring);
+    put(def.a.id);
+    put(def.b.id);
+    put(def.restLength);
+    put(def.stiffness);
+    put(def.damping);
+}
+
+void ReplayLog::recordRemoveSpring(uint32_t spring) {
+    put(ReplayOp::RemoveSpring);
+    put(spring);
+}
+
+void ReplayLog::putBodies(std::span<const BodyHandle> bodies) {
+    put(static_cast<uint32_t>(bodies.size()));
+    for (BodyHandle body : bodies) put(body.id);
+}
+
+void ReplayLog::putRadial(const RadialForce& field) {
+    put(field.centre.x);
+    put(field.centre.y);
+    put(field.strength);
+    put(field.radius);
+}
+
+void ReplayLog::putWind(const WindForce& wind) {
+    put(wind.velocity.x);
+    put(wind.velocity.y);
+    put(wind.coefficient);
+    put(wind.region.min.x);
+    put(wind.region.min.y);
+    put(wind.region.max.x);
+    put(wind.region.max.y);
+}
+
+void ReplayLog::recordAddDrag(const DragForce& drag, std::span<const BodyHandle> bodies) {
+    put(ReplayOp::AddDrag);
+    put(drag.linear);
+    put(drag.quadratic);
+    putBodies(bodies);
+}
+
+void ReplayLog::recordAddRadialForce(const RadialForce& field, std::span<const BodyHandle> bodies) {
+    put(ReplayOp::AddRadialForce);
+    putRadial(field);
+    putBodies(bodies);
+}
+
+void ReplayLog::recordAddWind(const WindForce& wind, std::span<const BodyHandle> bodies) {
+    put(ReplayOp::AddWind);
+    putWind(wind);
+    putBodies(bodies);
+}
+
+void ReplayLog::recordSetDrag(uint32_t index, const DragForce& drag) {
+    put(ReplayOp::SetDrag);
+    put(index);
+    put(drag.linear);
+    put(drag.quadratic);
+}
+
+void ReplayLog::recordSetRadialForce(uint32_t index, const RadialForce& field) {
+    put(ReplayOp::SetRadialForce);
+    put(index);
+    putRadial(field);
+}
+
+void ReplayLog::recordSetWind(uint32_t index, const WindForce& wind) {
+    put(ReplayOp::SetWind);
+    put(index);
+    putWind(wind);
+}
+
+void ReplayLog::recordStep(float dt, uint64_t stateHash) {
+    put(ReplayOp::Step);
+    put(dt);
+    put(stateHash);
+    ++steps;
+}
+
+/* ----------------------------- Reading ---------------------------- */
+
+bool ReplayLog::read(size_t& offset, ReplayRecord& record) const {
+    size_t at = offset;
+    if (!take(bytes, at, record.op)) return false;
+    bool ok = true;
+    switch (record.op) {
+    case ReplayOp::CreateBody: {
+        uint8_t bits = 0;
+        BodyDef& def = record.def;
+        ok = take(bytes, at, def.shape) && take(bytes, at, bits) &&
+             takeVector(bytes, at, def.position) && takeVector(bytes, at, def.velocity) &&
+             take(bytes, at, def.radius) && take(bytes, at, def.width) && take(bytes, at, def.height) &&
+             take(bytes, at, def.mass) && take(bytes, at, def.restitution) && takeFilter(bytes, at, def.filter);
+        def.isStatic = bits & DefStatic;
+        def.bullet = bits & DefBullet;
+        break;
+    }
+    case ReplayOp::SetGravity:
+        ok = takeVector(bytes, at, record.value);
+        break;
+    case ReplayOp::ApplyForce:
+    case ReplayOp::SetPosition:
+    case ReplayOp::SetVelocity:
+        ok = take(bytes, at, record.body.id) && takeVector(bytes, at, record.value);
+        break;
+    case ReplayOp::SetBullet: {
+        uint8_t flag = 0;
+        ok = take(bytes, at, record.body.id) && take(bytes, at, flag);
+        record.flag = flag != 0;
+        break;
+    }
+    case ReplayOp::Wake:
+        ok = take(bytes, at, record.body.id);
+        break;
+    case ReplayOp::SetFilter:
+        ok = take(bytes, at, record.body.id) && takeFilter(bytes, at, record.filter);
+        break;
+    case ReplayOp::AddSpring: {
+        SpringDef& def = record.spring;
+        ok = take(bytes, at, def.a.id) && take(bytes, at, def.b.id) && take(bytes, at, def.restLength) &&
+             take(bytes, at, def.stiffness) && take(bytes, at, def.damping);
+        break;
+    }
+    case ReplayOp::RemoveSpring:
+        ok = take(bytes, at, record.index);
+        break;
+    case ReplayOp::AddDrag:
+        ok = take(bytes, at, record.drag.linear) && take(bytes, at, record.drag.quadratic) &&
+             takeBodies(bytes, at, record.bodies);
+        break;
+    case ReplayOp::AddRadialForce:
+        ok = takeRadial(bytes, at, record.radial) && takeBodies(bytes, at, record.bodies);
+        break;
+    case ReplayOp::AddWind:
+        ok = takeWind(bytes, at, record.wind) && takeBodies(bytes, at, record.bodies);
+        break;
+    case ReplayOp::SetDrag:
+        ok = take(bytes, at, record.index) && take(bytes, at, record.drag.linear) &&
+             take(bytes, at, record.drag.quadratic);
+        break;
+    case ReplayOp::SetRadialForce:
+        ok = take(bytes, at, record.index) && takeRadial(bytes, at, record.radial);
+        break;
+    case ReplayOp::SetWind:
+        ok = take(bytes, at, record.index) && takeWind(bytes, at, record.wind);
+        break;
+    case ReplayOp::Step:
+        ok = take(bytes, at, record.dt) && take(bytes, at, record.stateHash);
+        break;
+    default:
+        ok = false;
+    }
+    if (ok) offset = at;
+    return ok;
+}
+
+bool ReplayLog::save(const char* path) const {
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    const uint64_t size = bytes.size();
+    bool ok = std::fwrite(ReplayMagic, sizeof(ReplayMagic), 1, file) == 1 &&
+              std::fwrite(&ReplayVersion, sizeof(ReplayVersion), 1, file) == 1 &&
+              std::fwrite(&size, sizeof(size), 1, file) == 1 &&
+              (size == 0 || std::fwrite(bytes.data(), 1, size, file) == size);
+    return std::fclose(file) == 0 && ok;
+}
+
+bool ReplayLog::load(const char* path) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (!file) return false;
+    char magic[sizeof(ReplayMagic)];
+    uint32_t version = 0;
+    uint64_t size = 0;
+    bool ok = std::fread(magic, sizeof(magic), 1, file) == 1 &&
+              std::memcmp(magic, ReplayMagic, sizeof(magic)) == 0 &&
+              std::fread(&version, sizeof(version), 1, file) == 1 && version == ReplayVersion &&
+              std::fread(&size, sizeof(size), 1, file) == 1;
+    std::vector<uint8_t> loaded;
+    if (ok) {
+        loaded.resize(size);
+        ok = size == 0 || std::fread(loaded.data(), 1, size, file) == size;
+    }
+    std::fclose(file);
+    if (!ok) return false;
+
+    // Count the steps, which also checks every record decodes
+    ReplayLog decoded;
+    decoded.bytes.swap(loaded);
+    size_t offset = 0;
+    ReplayRecord record;
+    while (decoded.read(offset, record)) {
+        if (record.op == ReplayOp::Step) ++decoded.steps;
+    }
+    if (offset != decoded.bytes.size()) return false;
+    bytes.swap(decoded.bytes);
+    steps = decoded.steps;
+    return true;
+}
+
+/* ----------------------------- Replay ----------------------------- */
+
+uint64_t hashWorldState(const BodyStorage& storage) {
+    const size_t n = storage.size();
+    uint64_t hash = RK::hashBytes(storage.posX.data(), n * sizeof(float));
+    hash = RK::hashBytes(storage.posY.data(), n * sizeof(float), hash);
+    hash = RK::hashBytes(storage.velX.data(), n * sizeof(float), hash);
+    hash = RK::hashBytes(storage.velY.data(), n * sizeof(float), hash);
+    return RK::hashBytes(storage.flags.data(), n, hash);
+}
+
+ReplayResult replay(const ReplayLog& log, PhysicsWorld& world, uint64_t maxSteps) {
+    ReplayResult result;
+    size_t offset = 0;
+    ReplayRecord r;
+    while (result.steps < maxSteps && log.read(offset, r)) {
+        switch (r.op) {
+        case ReplayOp::CreateBody: world.createBody(r.def); break;
+        case ReplayOp::SetGravity: world.setGravity(r.value); break;
+        case ReplayOp::ApplyForce: world.applyForce(r.body, r.value); break;
+        case ReplayOp::SetPosition: world.setPosition(r.body, r.value); break;
+        case ReplayOp::SetVelocity: world.setVelocity(r.body, r.value); break;
+        case ReplayOp::SetBullet: world.setBullet(r.body, r.flag); break;
+        case ReplayOp::Wake: world.wake(r.body); break;
+        case ReplayOp::SetFilter: world.setFilter(r.body, r.filter); break;
+        case ReplayOp::AddSpring: world.addSpring(r.spring); break;
+        case ReplayOp::RemoveSpring: world.removeSpring(r.index); break;
+        case ReplayOp::AddDrag: world.addDrag(r.drag, r.bodies); break;
+        case ReplayOp::AddRadialForce: world.addRadialForce(r.radial, r.bodies); break;
+        case ReplayOp::AddWind: world.addWind(r.wind, r.bodies); break;
+        case ReplayOp::SetDrag: world.setDrag(r.index, r.drag); break;
+        case ReplayOp::SetRadialForce: world.setRadialForce(r.index, r.radial); break;
+        case ReplayOp::SetWind: world.setWind(r.index, r.wind); break;
+        case ReplayOp::Step: {
+            world.update(r.dt);
+            const uint64_t hash = hashWorldState(world.getStorage());
+            if (hash != r.stateHash) {
+                result.firstDivergence = static_cast<int64_t>(result.steps);
+                result.expectedHash = r.stateHash;
+                result.actualHash = hash;
+                ++result.steps;
+                return result;
+            }
+            ++result.steps;
+            break;
+        }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+// Input recording and deterministic replay with per-step state hashes.
+
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+#include <Physics/BodyStorage.h>
+#include <Physics/Force.h>
+#include <Physics/Vector2D.h>
+
+class PhysicsWorld;
+
+enum class ReplayOp : uint8_t {
+    CreateBody,
+    SetGravity,
+    ApplyForce,
+    SetPosition,
+    SetVelocity,
+    SetBullet,
+    Wake,
+    Step,       // one update(dt) and the state hash after it
+    SetFilter,
+    AddSpring,
+    RemoveSpring,
+    AddDrag,    // parameters, then the body list
+    AddRadialForce,
+    AddWind,
+    SetDrag,    // generator index, then parameters
+    SetRadialForce,
+    SetWind,
+};
+
+// One decoded entry of a ReplayLog; fields not used by op are left as is
+struct ReplayRecord {
+    ReplayOp op = ReplayOp::Step;
+    BodyDef def;                // CreateBody
+    BodyHandle body;            // per-body ops
+    Vector2D value;             // gravity, force, position or velocity
+    bool flag = false;          // SetBullet
+    CollisionFilter filter;     // SetFilter
+    SpringDef spring;           // AddSpring
+    uint32_t index = 0;         // RemoveSpring, SetDrag, SetRadialForce, SetWind
+    DragForce drag;             // AddDrag, SetDrag
+    RadialForce radial;         // AddRadialForce, SetRadialForce
+    WindForce wind;             // AddWind, SetWind
+    std::vector<BodyHandle> bodies; // AddDrag, AddRadialForce, AddWind
+    float dt = 0.0f;            // Step
+    uint64_t stateHash = 0;     // Step
+};
+
+// Append-only log of every input a PhysicsWorld received, in call order.
+// Records are packed bytes: an op byte and its raw little endian payload.
+// advance() shows up as the updates it ran.
+class ReplayLog {
+public:
+    void recordCreateBody(const BodyDef& def);
+    void recordGravity(Vector2D gravity);
+    void recordForce(BodyHandle body, Vector2D force);
+    void recordPosition(BodyHandle body, Vector2D position);
+    void recordVelocity(BodyHandle body, Vector2D velocity);
+    void recordBullet(BodyHandle body, bool bullet);
+    void recordWake(BodyHandle body);
+    void recordFilter(BodyHandle body, const CollisionFilter& filter);
+    void recordAddSpring(const SpringDef& def);
+    void recordRemoveSpring(uint32_t spring);
+    void recordAddDrag(const DragForce& drag, std::span<const BodyHandle> bodies);
+    void recordAddRadialForce(const RadialForce& field, std::span<const BodyHandle> bodies);
+    void recordAddWind(const WindForce& wind, std::span<const BodyHandle> bodies);
+    void recordSetDrag(uint32_t index, const DragForce& drag);
+    void recordSetRadialForce(uint32_t index, const RadialForce& field);
+    void recordSetWind(uint32_t index, const WindForce& wind);
+    void recordStep(float dt, uint64_t stateHash);
+
+    // Decode the record at offset and move offset past it; false at the end
+    bool read(size_t& offset, ReplayRecord& record) const;
+
+    size_t getStepCount() const { return steps; }
+    const std::vector<uint8_t>& getBytes() const { return bytes; }
+    void clear() { bytes.clear(); steps = 0; }
+
+    // A magic and version header, then the records. load() replaces the log
+    // and fails on I/O errors or files of another format or version.
+    bool save(const char* path) const;
+    bool load(const char* path);
+
+private:
+    template <typename T>
+    void put(const T& value) {
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(&value);
+        bytes.insert(bytes.end(), raw, raw + sizeof(T));
+    }
+    void putBodyValue(ReplayOp op, BodyHandle body, Vector2D value);
+    void putBodies(std::span<const BodyHandle> bodies);
+    void putRadial(const RadialForce& field);
+    void putWind(const WindForce& wind);
+
+    std::vector<uint8_t> bytes;
+    size_t steps = 0;
+};
+
+// Hash of the simulated state: positions, velocities and flags of every body
+// in storage order. Two worlds that agree on it agree bit for bit.
+uint64_t hashWorldState(const BodyStorage& storage);
+
+struct ReplayResult {
+    uint64_t steps = 0;                 // steps replayed, including a diverging one
+    int64_t firstDivergence = -1;       // index of the first step whose hash differs
+    uint64_t expectedHash = 0;          // of that step, as recorded
+    uint64_t actualHash = 0;            // of that step, as replayed
+
+    bool diverged() const { return firstDivergence >= 0; }
+};
+
+// Re-execute log on world and compare the state hash after every step.
+// Stops at the first divergence or after maxSteps steps, so a long session
+// can be bisected by replaying prefixes. world must be new and configured
+// like the recorded one (broadphase, solver and sleep settings), as those are
+// not part of the log; the thread count does not matter.
+ReplayResult replay(const ReplayLog& log, PhysicsWorld& world,
+                    uint64_t maxSteps = std::numeric_limits<uint64_t>::max());
@@ -0,0 +1,41 @@
+#include <Physics/Snapshot.h>
+
+SnapshotPublisher::SnapshotPublisher() {
+    for (int i = 0; i < 3; ++i) slots.push_back(std::make_unique<Slot>());
+}
+
+SnapshotPublisher::Slot* SnapshotPublisher::freeSlot() {
+    Slot* const live = current.load(std::memory_order_relaxed);
+    for (const std::unique_ptr<Slot>& slot : slots) {
+        // seq_cst pairs with acquire(): a reader that counted itself in
+        // after this load sees the slot is no longer current and backs off
+        if (slot.get() != live && slot->readers.load(std::memory_order_seq_cst) == 0) return slot.get();
+    }
+    slots.push_back(std::make_unique<Slot>());
+    return slots.back().get();
+}
+
+void SnapshotPublisher::publish(const BodyStorage& storage) {
+    Slot* slot = freeSlot();
+    WorldSnapshot& s = slot->snapshot;
+    s.sequence = ++published;
+    s.ids.assign(storage.ids.begin(), storage.ids.end());
+    s.posX.assign(storage.posX.begin(), storage.posX.end());
+    s.posY.assign(storage.posY.begin(), storage.posY.end());
+    s.velX.assign(storage.velX.begin(), storage.velX.end());
+    s.velY.assign(storage.velY.begin(), storage.velY.end());
+    s.flags.assign(storage.flags.begin(), storage.flags.end());
+    current.store(slot, std::memory_order_seq_cst);
+}
+
+SnapshotRef SnapshotPublisher::acquire() const {
+    for (;;) {
+        Slot* slot = current.load(std::memory_order_seq_cst);
+        if (!slot) return SnapshotRef();
+        slot->readers.fetch_add(1, std::memory_order_seq_cst);
+        // Still current: the publisher cannot pick it until we let go.
+        // Otherwise it may already be rewriting it, so try again.
+        if (current.load(std::memory_order_seq_cst) == slot) return SnapshotRef(&slot->snapshot, &slot->readers);
+        slot->readers.fetch_sub(1, std::memory_order_release);
+    }
+}
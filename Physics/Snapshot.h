@@ -0,0 +1,105 @@
+#pragma once
+
+// Body state published after each update for readers on other threads.
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <Physics/BodyStorage.h>
+#include <Physics/Vector2D.h>
+
+// State of every body after one update, in storage order. A published
+// snapshot is never written again while any reader holds it.
+struct WorldSnapshot {
+    uint64_t sequence = 0;          // 1 for the first published update, then counting up
+    std::vector<uint32_t> ids;      // handle id of each body
+    std::vector<float> posX, posY;
+    std::vector<float> velX, velY;
+    std::vector<uint8_t> flags;     // BodyFlags
+
+    size_t size() const { return ids.size(); }
+
+    Vector2D getPosition(size_t i) const { return Vector2D(posX[i], posY[i]); }
+    Vector2D getVelocity(size_t i) const { return Vector2D(velX[i], velY[i]); }
+    bool isAwake(size_t i) const { return !(flags[i] & BodyFlagSleeping); }
+};
+
+// A reader's hold on a snapshot; releasing it lets the publisher reuse the
+// buffer. Movable, not copyable.
+class SnapshotRef {
+public:
+    SnapshotRef() = default;
+    SnapshotRef(const WorldSnapshot* snapshot, std::atomic<uint32_t>* readers) : snapshot(snapshot), readers(readers) {}
+    ~SnapshotRef() { release(); }
+
+    SnapshotRef(SnapshotRef&& other) noexcept : snapshot(other.snapshot), readers(other.readers) {
+        other.snapshot = nullptr;
+        other.readers = nullptr;
+    }
+    SnapshotRef& operator = (SnapshotRef&& other) noexcept {
+        if (this != &other) {
+            release();
+            snapshot = other.snapshot;
+            readers = other.readers;
+            other.snapshot = nullptr;
+            other.readers = nullptr;
+        }
+        return *this;
+    }
+
+    // Empty before the first publish
+    explicit operator bool() const { return snapshot != nullptr; }
+    const WorldSnapshot& operator * () const { return *snapshot; }
+    const WorldSnapshot* operator -> () const { return snapshot; }
+
+    void release() {
+        if (readers) readers->fetch_sub(1, std::memory_order_release);
+        snapshot = nullptr;
+        readers = nullptr;
+    }
+
+private:
+    const WorldSnapshot* snapshot = nullptr;
+    std::atomic<uint32_t>* readers = nullptr;
+};
+
+// RCU-style publishing of WorldSnapshots. The step thread copies the state
+// into a buffer no reader holds and swaps it in as current; any number of
+// readers take the current one with a reference count and never block the
+// step or each other. Three buffers cover one snapshot being read while the
+// next is written; more are added only while readers hold on to old ones,
+// and buffers keep their capacity, so steady publishing does not allocate.
+//
+// All readers must release their snapshots before the publisher is destroyed.
+class SnapshotPublisher {
+public:
+    bool enabled = false; // PhysicsWorld publishes after every update when set
+
+    SnapshotPublisher();
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator = (const SnapshotPublisher&) = delete;
+
+    // Step thread only
+    void publish(const BodyStorage& storage);
+
+    // Any thread: the latest published snapshot
+    SnapshotRef acquire() const;
+
+    // Step thread only
+    uint64_t getPublishedCount() const { return published; }
+    size_t getBufferCount() const { return slots.size(); }
+
+private:
+    struct Slot {
+        WorldSnapshot snapshot;
+        std::atomic<uint32_t> readers{0};
+    };
+
+    Slot* freeSlot();
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::atomic<Slot*> current{nullptr};
+    uint64_t published = 0;
+};
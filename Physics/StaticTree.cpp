@@ -0,0 +1,126 @@
+#include <Physics/StaticTree.h>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr uint32_t BinCount = 16;
+constexpr uint32_t MaxBuildDepth = 64; // deeper nodes split at the median
+
+} // namespace
+
+void StaticTree::build(const AABB* boxes, const uint32_t* userData, size_t count) {
+    clear();
+    if (count == 0) return;
+    items.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        items[k] = Item{boxes[k], (boxes[k].min + boxes[k].max) * 0.5f, userData[k]};
+    }
+
+    nodes.reserve(2 * (count / MaxLeafSize + 1));
+    nodes.emplace_back();
+    buildNode(0, 0, static_cast<uint32_t>(count), 0);
+
+    leafBoxes.reserve(count);
+    leafData.reserve(count);
+    for (const Item& item : items) {
+        leafBoxes.push_back(item.box);
+        leafData.push_back(item.userData);
+    }
+}
+
+// Called right after the node was appended, so its children go directly
+// behind it
+void StaticTree::buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t depth) {
+    AABB box = items[begin].box;
+    AABB centres(items[begin].centre, items[begin].centre);
+    for (uint32_t k = begin + 1; k < end; ++k) {
+        box = box.merged(items[k].box);
+        centres = centres.merged(AABB(items[k].centre, items[k].centre));
+    }
+    nodes[nodeIndex].box = box;
+
+    const uint32_t count = end - begin;
+    if (count <= MaxLeafSize) {
+        nodes[nodeIndex].index = begin;
+        nodes[nodeIndex].count = count;
+        return;
+    }
+
+    // Split along the longer axis of the box centres
+    const int axis = centres.max.x - centres.min.x >= centres.max.y - centres.min.y ? 0 : 1;
+    auto along = [axis](Vector2D v) { return axis == 0 ? v.x : v.y; };
+    const float lo = along(centres.min);
+    const float extent = along(centres.max) - lo;
+
+    uint32_t middle = begin + count / 2;
+    bool median = extent <= 0.0f || depth >= MaxBuildDepth;
+    if (!median) {
+        // Bin the centres, then pick the bin boundary with the lowest
+        // perimeter cost: boxes on each side times the perimeter around them
+        struct Bin {
+            AABB box;
+            uint32_t count = 0;
+        };
+        Bin bins[BinCount];
+        const float scale = BinCount / extent;
+        auto binOf = [&](const Item& item) {
+            return std::min(BinCount - 1, static_cast<uint32_t>((along(item.centre) - lo) * scale));
+        };
+        for (uint32_t k = begin; k < end; ++k) {
+            Bin& bin = bins[binOf(items[k])];
+            bin.box = bin.count == 0 ? items[k].box : bin.box.merged(items[k].box);
+            ++bin.count;
+        }
+
+        // rightCost[b]: boxes in bins b.. and their perimeter
+        float rightCost[BinCount];
+        AABB right;
+        uint32_t rightCount = 0;
+        for (uint32_t b = BinCount - 1; b > 0; --b) {
+            if (bins[b].count > 0) {
+                right = rightCount == 0 ? bins[b].box : right.merged(bins[b].box);
+                rightCount += bins[b].count;
+            }
+            rightCost[b] = rightCount == 0 ? 0.0f : rightCount * right.perimeter();
+        }
+
+        float bestCost = std::numeric_limits<float>::max();
+        uint32_t bestSplit = 0;
+        AABB left;
+        uint32_t leftCount = 0;
+        for (uint32_t b = 1; b < BinCount; ++b) {
+            if (bins[b - 1].count > 0) {
+                left = leftCount == 0 ? bins[b - 1].box : left.merged(bins[b - 1].box);
+                leftCount += bins[b - 1].count;
+            }
+            if (leftCount == 0 || leftCount == count) continue;
+            const float cost = leftCount * left.perimeter() + rightCost[b];
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestSplit = b;
+            }
+        }
+
+        if (bestSplit == 0) {
+            median = true;
+        } else {
+            Item* split = std::partition(items.data() + begin, items.data() + end,
+                                         [&](const Item& item) { return binOf(item) < bestSplit; });
+            middle = static_cast<uint32_t>(split - items.data());
+        }
+    }
+    if (median) {
+        std::nth_element(items.begin() + begin, items.begin() + middle, items.begin() + end,
+                         [&](const Item& a, const Item& b) { return along(a.centre) < along(b.centre); });
+    }
+
+    nodes[nodeIndex].count = 0;
+    const uint32_t first = static_cast<uint32_t>(nodes.size());
+    nodes.emplace_back();
+    buildNode(first, begin, middle, depth + 1);
+    const uint32_t second = static_cast<uint32_t>(nodes.size());
+    nodes[nodeIndex].index = second;
+    nodes.emplace_back();
+    buildNode(second, middle, end, depth + 1);
+}
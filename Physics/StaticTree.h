@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <Physics/AABB.h>
+
+// Bounding volume hierarchy over boxes that do not move, such as level
+// geometry. Built in one go with a binned surface area heuristic (perimeter
+// in 2D) and never updated: when the boxes change it is rebuilt. Nodes are
+// packed depth first in one array, a node's first child directly after it,
+// and the boxes are stored in leaf order, so traversal reads memory mostly
+// front to back.
+class StaticTree {
+public:
+    static constexpr uint32_t MaxLeafSize = 4;
+
+    // Replace the contents with boxes[k], reported as userData[k]
+    void build(const AABB* boxes, const uint32_t* userData, size_t count);
+
+    void clear() {
+        nodes.clear();
+        leafBoxes.clear();
+        leafData.clear();
+    }
+
+    size_t size() const { return leafData.size(); }
+    size_t getNodeCount() const { return nodes.size(); }
+
+    // Calls callback(userData) for every box overlapping box. The callback
+    // returns false to stop the query early.
+    template <typename Callback>
+    void query(const AABB& box, Callback&& callback) const {
+        if (nodes.empty()) return;
+        uint32_t stack[MaxDepth];
+        int32_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (!node.box.overlaps(box)) continue;
+            if (node.count > 0) {
+                for (uint32_t k = node.index; k < node.index + node.count; ++k) {
+                    if (leafBoxes[k].overlaps(box) && !callback(leafData[k])) return;
+                }
+            } else {
+                assert(top + 2 <= MaxDepth);
+                stack[top++] = node.index;
+                stack[top++] = static_cast<uint32_t>(&node - nodes.data()) + 1;
+            }
+        }
+    }
+
+    // Calls callback(userData) for every box the segment from + t * (to - from),
+    // t in [0, maxFraction], enters. The callback returns the new maxFraction;
+    // a negative value stops the query.
+    template <typename Callback>
+    void raycast(Vector2D from, Vector2D to, float maxFraction, Callback&& callback) const {
+        if (nodes.empty()) return;
+        const Vector2D delta = to - from;
+        uint32_t stack[MaxDepth];
+        int32_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (!node.box.intersectsSegment(from, delta, maxFraction)) continue;
+            if (node.count > 0) {
+                for (uint32_t k = node.index; k < node.index + node.count; ++k) {
+                    if (!leafBoxes[k].intersectsSegment(from, delta, maxFraction)) continue;
+                    const float clipped = callback(leafData[k]);
+                    if (clipped < 0.0f) return;
+                    maxFraction = std::min(maxFraction, clipped);
+                }
+            } else {
+                assert(top + 2 <= MaxDepth);
+                stack[top++] = node.index;
+                stack[top++] = static_cast<uint32_t>(&node - nodes.data()) + 1;
+            }
+        }
+    }
+
+private:
+    // Splits that cannot separate the boxes fall back to halving the range,
+    // so the depth stays logarithmic
+    static constexpr int32_t MaxDepth = 128;
+
+    struct Node {
+        AABB box;
+        uint32_t index;   // leaf: first box; inner: second child (the first follows the node)
+        uint32_t count;   // boxes in a leaf, 0 for inner nodes
+    };
+
+    struct Item {
+        AABB box;
+        Vector2D centre;
+        uint32_t userData;
+    };
+
+    void buildNode(uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t depth);
+
+    std::vector<Node> nodes;
+    std::vector<AABB> leafBoxes;     // in leaf order
+    std::vector<uint32_t> leafData;
+    std::vector<Item> items;         // build scratch
+};
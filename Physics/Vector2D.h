@@ -28,9 +28,9 @@ public:
     }
 
     Vector2D& operator-=(const Vector2D& other) {
-	x -= other.x;
-	y += other.y;
-	return *this;
+        x -= other.x;
+        y -= other.y;
+        return *this;
     }
     
     float dot(const Vector2D& other) const {
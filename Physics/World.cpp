@@ -1,11 +1,351 @@
+#include <Physics/PhysicsWorld.h>
+#include <Physics/Circle.h>
+#include <Physics/Rectangle.h>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
 
-class World {
+BodyHandle PhysicsWorld::addBody(std::unique_ptr<PhysicsBody> body) {
+    BodyDef def;
+    def.shape = body->shapeType;
+    def.position = body->position;
+    def.velocity = body->velocity;
+    def.mass = body->mass;
+    def.restitution = body->restitution;
+    def.isStatic = body->isStatic;
+    if (body->shapeType == ShapeType::Circle) {
+        def.radius = static_cast<const Circle&>(*body).radius;
+    } else {
+        const Rectangle& rect = static_cast<const Rectangle&>(*body);
+        def.width = rect.width;
+        def.height = rect.height;
+    }
 
+    BodyHandle handle = createBody(def);
+    // Forces applied to the object before it was added
+    applyForce(handle, body->acceleration * body->mass);
+    return handle;
+}
 
-public:
+void PhysicsWorld::update(float dt) {
+    PHYSICS_PROFILE_BEGIN(profiler);
 
-	void show() {}
+    // Force generators add to the forces accumulated since the last update
+    springLinks.clear();
+    if (!forces.empty()) {
+        PHYSICS_PROFILE_SCOPE(profiler, ProfilePhase::Forces);
+        applyForces();
+    }
 
+    // Gravity and accumulated forces, then move the awake bodies
+    {
+        PHYSICS_PROFILE_SCOPE(profiler, ProfilePhase::Integrate);
+        gatherBullets();
+        integrate(dt);
+    }
 
-};
+    // Bounds grow by half the contact margin, so bodies closer than the margin
+    // become candidates
+    const float halfMargin = solver.settings.contactMargin * 0.5f;
 
+    // Broadphase: candidate pairs from the body bounds. Sleeping bodies pair
+    // like static ones: only with awake bodies.
+    {
+        PHYSICS_PROFILE_SCOPE(profiler, ProfilePhase::Broadphase);
+        const size_t count = storage.size();
+        if (staticsDirty) rebuildStaticTree(halfMargin);
+        indexedBodies = count;
+
+        const size_t dynamicCount = dynamicBodies.size();
+        bounds.resize(dynamicCount);
+        statics.resize(dynamicCount);
+        clearMoved();
+        moved.resize(count);
+        movedBodies.reserve(count);
+        forRange(dynamicCount, 4096, [this, halfMargin](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                const uint32_t i = dynamicBodies[k];
+                bounds[k] = storage.bounds(i).fattened(halfMargin);
+                statics[k] = storage.isSleeping(i);
+            }
+        });
+        // Bullets cover their whole path, so pairs include what they swept
+        for (size_t k = 0; k < bullets.size(); ++k) {
+            const uint32_t slot = dynamicSlot[bullets[k]];
+            const float r = storage.extentX[bullets[k]] + halfMargin;
+            const Vector2D& start = bulletStart[k];
+            bounds[slot] = bounds[slot].merged(AABB(Vector2D(start.x - r, start.y - r), Vector2D(start.x + r, start.y + r)));
+        }
+        broadphase->findPairs(bounds, statics, dynamicPairs);
+        // Broadphase indices grow with the body index, so the pairs stay sorted
+        for (BodyPair& p : dynamicPairs) p = BodyPair(dynamicBodies[p.a], dynamicBodies[p.b]);
+
+        findStaticPairs();
+        pairs.resize(dynamicPairs.size() + staticPairs.size());
+        std::merge(dynamicPairs.begin(), dynamicPairs.end(), staticPairs.begin(), staticPairs.end(), pairs.begin());
+
+        // Pairs the collision filters reject never reach the narrowphase
+        if (filteredCount > 0) {
+            const std::vector<CollisionFilter>& filter = storage.filter;
+            pairs.erase(std::remove_if(pairs.begin(), pairs.end(), [&filter](const BodyPair& p) {
+                return !shouldCollide(filter[p.a], filter[p.b]);
+            }), pairs.end());
+        }
+    }
+
+    {
+        PHYSICS_PROFILE_SCOPE(profiler, ProfilePhase::Narrowphase);
+
+        // Bullets stop at their first impact, before the contacts are built
+        if (!bullets.empty()) sweepBullets();
+
+        // Narrowphase on the candidates only, all from the same positions
+        Contact* contacts = frameArena.allocateArray<Contact>(pairs.size());
+        uint8_t* touching = frameArena.allocateArray<uint8_t>(pairs.size());
+        forRange(pairs.size(), 1024, [this, halfMargin, contacts, touching](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p) {
+                touching[p] = collide(inflated(storage.collider(pairs[p].a), halfMargin),
+                                      inflated(storage.collider(pairs[p].b), halfMargin), contacts[p]);
+                if (touching[p]) contacts[p].depth -= 2 * halfMargin;
+            }
+        });
+
+        // An awake body touching a sleeping one wakes its island
+        if (islands.getSleepingCount() > 0) {
+            for (size_t p = 0; p < pairs.size(); ++p) {
+                if (!touching[p]) continue;
+                islands.wake(storage, pairs[p].a);
+                islands.wake(storage, pairs[p].b);
+            }
+        }
+
+        // Manifolds in pair order
+        manifolds.clear();
+        for (size_t p = 0; p < pairs.size(); ++p) {
+            if (!touching[p]) continue;
+            const uint32_t a = pairs[p].a, b = pairs[p].b;
+            ContactManifold m;
+            m.a = a;
+            m.b = b;
+            m.key = pairKey(storage.handleAt(a), storage.handleAt(b));
+            m.normal = contacts[p].normal;
+            m.depth = contacts[p].depth;
+            m.startA = Vector2D(storage.posX[a], storage.posY[a]);
+            m.startB = Vector2D(storage.posX[b], storage.posY[b]);
+            manifolds.push_back(m);
+        }
+    }
+
+    // Solve all manifolds together
+    {
+        PHYSICS_PROFILE_SCOPE(profiler, ProfilePhase::Resolve);
+        solver.solve(storage, manifolds, dt);
+        // Position correction may push a body out of its bounds
+        for (const ContactManifold& m : manifolds) {
+            for (uint32_t i : {m.a, m.b}) {
+                const uint32_t slot = dynamicSlot[i];
+                if (slot != NotDynamic && !bounds[slot].contains(storage.bounds(i))) markMoved(i);
+            }
+        }
+    }
+
+    {
+        PHYSICS_PROFILE_SCOPE(profiler, ProfilePhase::Islands);
+        islands.update(storage, manifolds, dt, springLinks);
+    }
+
+    // Contact events, all at once after the step
+    if (contactListener) {
+        contactTracker.update(storage, manifolds);
+        contactListener->onContacts(contactTracker.getBegin(), contactTracker.getEnd());
+    }
+
+    PHYSICS_PROFILE_COUNT(profiler, candidatePairs, pairs.size());
+    PHYSICS_PROFILE_COUNT(profiler, contacts, manifolds.size());
+    PHYSICS_PROFILE_COUNT(profiler, awakeBodies, islands.getAwakeCount());
+
+    if (snapshots.enabled) snapshots.publish(storage);
+    if (recorder) recorder->recordStep(dt, hashWorldState(storage));
+    PHYSICS_PROFILE_END(profiler);
+
+    frameArena.reset();
+}
+
+int PhysicsWorld::advance(float frameTime) {
+    accumulator += std::max(frameTime, 0.0f);
+
+    int steps = 0;
+    const int substeps = std::max(timeStep.substeps, 1);
+    const float dt = timeStep.fixedDt / substeps;
+    while (accumulator >= timeStep.fixedDt && steps < timeStep.maxStepsPerCall) {
+        previousX.assign(storage.posX.begin(), storage.posX.end());
+        previousY.assign(storage.posY.begin(), storage.posY.end());
+        for (int i = 0; i < substeps; ++i) update(dt);
+        accumulator -= timeStep.fixedDt;
+        ++steps;
+    }
+
+    // Behind by more than the cap: drop the backlog instead of simulating it
+    // in later calls, which would only fall further behind
+    if (accumulator >= timeStep.fixedDt) {
+        accumulator = std::fmod(accumulator, timeStep.fixedDt);
+    }
+    return steps;
+}
+
+void PhysicsWorld::rebuildStaticTree(float halfMargin) {
+    staticBounds.clear();
+    staticBodies.clear();
+    for (uint32_t i = 0; i < storage.size(); ++i) {
+        if (!storage.isStatic(i)) continue;
+        staticBounds.push_back(storage.bounds(i).fattened(halfMargin));
+        staticBodies.push_back(i);
+    }
+    std::vector<uint32_t> indices(staticBodies.size());
+    for (uint32_t c = 0; c < indices.size(); ++c) indices[c] = c;
+    staticTree.build(staticBounds.data(), indices.data(), indices.size());
+    staticsDirty = false;
+    // Every dynamic body queries the new tree
+    staticReach.clear();
+    staticFatPairs.clear();
+}
+
+// Awake dynamic bodies against the static tree. Bodies that left their reach
+// box (or have none yet) query again, in chunks of fixed size so the result
+// does not depend on the thread count.
+void PhysicsWorld::findStaticPairs() {
+    staticPairs.clear();
+    if (staticBodies.empty()) return;
+    const uint32_t count = static_cast<uint32_t>(dynamicBodies.size());
+    if (count < staticReach.size()) {
+        staticReach.clear();
+        staticFatPairs.clear();
+    }
+
+    reachMoved.assign(count, 0);
+    reachMovedList.clear();
+    for (uint32_t k = 0; k < count; ++k) {
+        if (k < staticReach.size()) {
+            if (staticReach[k].contains(bounds[k])) continue;
+            staticReach[k] = bounds[k].fattened(staticReachMargin);
+        } else {
+            staticReach.push_back(bounds[k].fattened(staticReachMargin));
+        }
+        reachMoved[k] = 1;
+        reachMovedList.push_back(k);
+    }
+    staticFatPairs.erase(std::remove_if(staticFatPairs.begin(), staticFatPairs.end(),
+                                        [this](const BodyPair& p) { return reachMoved[p.a]; }),
+                         staticFatPairs.end());
+
+    const size_t grain = 256;
+    const size_t chunks = (reachMovedList.size() + grain - 1) / grain;
+    if (staticChunkPairs.size() < chunks) staticChunkPairs.resize(chunks);
+    forRange(chunks, 1, [&](size_t first, size_t last) {
+        for (size_t c = first; c < last; ++c) {
+            std::vector<BodyPair>& out = staticChunkPairs[c];
+            out.clear();
+            for (size_t m = c * grain; m < std::min(reachMovedList.size(), (c + 1) * grain); ++m) {
+                const uint32_t k = reachMovedList[m];
+                staticTree.query(staticReach[k], [&](uint32_t s) {
+                    out.emplace_back(k, s);
+                    return true;
+                });
+            }
+        }
+    });
+    staticNewPairs.clear();
+    for (size_t c = 0; c < chunks; ++c) {
+        staticNewPairs.insert(staticNewPairs.end(), staticChunkPairs[c].begin(), staticChunkPairs[c].end());
+    }
+    staticMerged.clear();
+    std::merge(staticFatPairs.begin(), staticFatPairs.end(), staticNewPairs.begin(), staticNewPairs.end(),
+               std::back_inserter(staticMerged));
+    staticFatPairs.swap(staticMerged);
+
+    // Candidates are the kept pairs of awake bodies whose bounds overlap
+    for (const BodyPair& p : staticFatPairs) {
+        if (statics[p.a] || !bounds[p.a].overlaps(staticBounds[p.b])) continue;
+        const uint32_t i = dynamicBodies[p.a], s = staticBodies[p.b];
+        staticPairs.emplace_back(std::min(i, s), std::max(i, s));
+    }
+    std::sort(staticPairs.begin(), staticPairs.end());
+}
+
+void PhysicsWorld::gatherBullets() {
+    bullets.clear();
+    bulletStart.clear();
+    if (bulletCount == 0) return;
+    for (uint32_t i = 0; i < storage.size(); ++i) {
+        if ((storage.flags[i] & (BodyFlagBullet | BodyFlagSleeping)) != BodyFlagBullet) continue;
+        bullets.push_back(i);
+        bulletStart.emplace_back(storage.posX[i], storage.posY[i]);
+    }
+}
+
+void PhysicsWorld::sweepBullets() {
+    // Slots of non-bullets stay uninitialised, they are never read
+    uint32_t* bulletSlot = frameArena.allocateArray<uint32_t>(storage.size());
+    float* bulletToi = frameArena.allocateArray<float>(bullets.size());
+    for (size_t k = 0; k < bullets.size(); ++k) {
+        bulletSlot[bullets[k]] = static_cast<uint32_t>(k);
+        bulletToi[k] = 1.0f;
+    }
+
+    // Other bodies are taken where they ended the step, so only the bullet's
+    // own motion is swept
+    const auto sweep = [this, bulletSlot, bulletToi](uint32_t bullet, uint32_t other) {
+        // Flagged, but asleep when the bullets were gathered
+        if (storage.isSleeping(bullet)) return;
+        const uint32_t k = bulletSlot[bullet];
+        const Vector2D start = bulletStart[k];
+        const Vector2D motion(storage.posX[bullet] - start.x, storage.posY[bullet] - start.y);
+        const Collider circle{ShapeType::Circle, start, Vector2D(storage.extentX[bullet], 0)};
+        float toi;
+        if (timeOfImpact(circle, motion, storage.collider(other), toi)) {
+            bulletToi[k] = std::min(bulletToi[k], toi);
+        }
+    };
+    for (const BodyPair& pair : pairs) {
+        if (storage.isBullet(pair.a)) sweep(pair.a, pair.b);
+        if (storage.isBullet(pair.b)) sweep(pair.b, pair.a);
+    }
+
+    // Advance to the time of impact; the rest of the step's motion is dropped
+    // and the contact at the impact point turns the velocity
+    for (size_t k = 0; k < bullets.size(); ++k) {
+        if (bulletToi[k] >= 1.0f) continue;
+        const uint32_t i = bullets[k];
+        const Vector2D& start = bulletStart[k];
+        storage.posX[i] = start.x + (storage.posX[i] - start.x) * bulletToi[k];
+        storage.posY[i] = start.y + (storage.posY[i] - start.y) * bulletToi[k];
+    }
+}
+
+void PhysicsWorld::integrate(float dt) {
+    IntegrationColumns columns{
+        storage.posX.data(), storage.posY.data(),
+        storage.velX.data(), storage.velY.data(),
+        storage.forceX.data(), storage.forceY.data(),
+        storage.invMass.data(), storage.flags.data(),
+        storage.size()
+    };
+    // Chunks are multiples of 8 bodies long, so only the last one has a tail
+    forRange(columns.count, 4096, [&](size_t begin, size_t end) {
+        integrateBodies(columns, begin, end, gravity, dt, BodyFlagStatic | BodyFlagSleeping, simdLevel);
+    });
+}
+
+void PhysicsWorld::draw() const {
+    std::cout << "=== Physics World ===" << std::endl;
+    for (uint32_t i = 0; i < storage.size(); ++i) {
+        if (storage.shape[i] == ShapeType::Circle) {
+            std::cout << "Circle at (" << storage.posX[i] << ", " << storage.posY[i]
+                      << ") radius: " << storage.extentX[i] << std::endl;
+        } else {
+            std::cout << "Rectangle at (" << storage.posX[i] << ", " << storage.posY[i]
+                      << ") size: " << storage.extentX[i] << "x" << storage.extentY[i] << std::endl;
+        }
+    }
+    std::cout << std::endl;
+}
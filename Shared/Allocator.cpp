@@ -0,0 +1,119 @@
+//
+// Pool and arena allocators.
+//
+
+#include <Shared/Allocator.h>
+#include <cassert>
+#include <cstdint>
+
+namespace RK
+{
+
+static Size alignUp(Size value, Size align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+/* ------------------------- PoolAllocator ------------------------- */
+
+PoolAllocator::PoolAllocator(Size blockSize, Size blocksPerChunk, Size alignment)
+    : blocksPerChunk(blocksPerChunk > 0 ? blocksPerChunk : 1),
+      alignment(alignment < alignof(FreeBlock) ? alignof(FreeBlock) : alignment) {
+    assert((this->alignment & (this->alignment - 1)) == 0);
+    // Every block must hold the free list link and keep the next one aligned
+    blockBytes = alignUp(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize, this->alignment);
+}
+
+PoolAllocator::~PoolAllocator() {
+    for (void* chunk : chunks) {
+        ::operator delete(chunk, std::align_val_t(alignment));
+    }
+}
+
+void* PoolAllocator::allocate() {
+    if (!freeList) grow();
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    ++live;
+    return block;
+}
+
+void PoolAllocator::deallocate(void* block) noexcept {
+    if (!block) return;
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = freeList;
+    freeList = freed;
+    --live;
+}
+
+void PoolAllocator::reserve(Size count) {
+    while (blockCount < count) grow();
+}
+
+void PoolAllocator::grow() {
+    std::byte* chunk = static_cast<std::byte*>(
+        ::operator new(blockBytes * blocksPerChunk, std::align_val_t(alignment)));
+    chunks.push_back(chunk);
+
+    // Thread the new blocks onto the free list, lowest address first
+    for (Size i = blocksPerChunk; i-- > 0;) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockBytes);
+        block->next = freeList;
+        freeList = block;
+    }
+    blockCount += blocksPerChunk;
+}
+
+/* --------------------------- FrameArena -------------------------- */
+
+FrameArena::FrameArena(Size chunkSize) : chunkSize(chunkSize > 0 ? chunkSize : 1) {}
+
+FrameArena::~FrameArena() {
+    releaseChunks();
+}
+
+void* FrameArena::allocate(Size bytes, Size align) {
+    assert((align & (align - 1)) == 0);
+    const std::uintptr_t at = alignUp(reinterpret_cast<std::uintptr_t>(cursor), align);
+    if (!cursor || at + bytes > reinterpret_cast<std::uintptr_t>(limit)) {
+        addChunk(bytes + align);
+        return allocate(bytes, align);
+    }
+    std::byte* result = reinterpret_cast<std::byte*>(at);
+    usedBytes += static_cast<Size>(result + bytes - cursor);
+    cursor = result + bytes;
+    return result;
+}
+
+void FrameArena::reset() {
+    // Spilled into several chunks: swap them for one holding the whole frame
+    if (chunks.size() > 1) {
+        const Size total = totalBytes;
+        releaseChunks();
+        addChunk(total);
+    }
+    if (!chunks.empty()) {
+        cursor = chunks.front().data;
+        limit = cursor + chunks.front().size;
+    }
+    usedBytes = 0;
+}
+
+void FrameArena::addChunk(Size minBytes) {
+    const Size size = minBytes > chunkSize ? minBytes : chunkSize;
+    Chunk chunk{static_cast<std::byte*>(::operator new(size, std::align_val_t(alignof(std::max_align_t)))), size};
+    chunks.push_back(chunk);
+    cursor = chunk.data;
+    limit = chunk.data + size;
+    totalBytes += size;
+}
+
+void FrameArena::releaseChunks() noexcept {
+    for (const Chunk& chunk : chunks) {
+        ::operator delete(chunk.data, std::align_val_t(alignof(std::max_align_t)));
+    }
+    chunks.clear();
+    cursor = limit = nullptr;
+    totalBytes = 0;
+}
+
+} // namespace RK
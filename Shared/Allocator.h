@@ -0,0 +1,147 @@
+//
+// Pool and arena allocators for memory that churns every step.
+//
+
+#pragma once
+
+#include <Shared/Types.h>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace RK
+{
+
+// Fixed-size blocks carved from large chunks. Freed blocks go on an intrusive
+// free list and are handed out again before any new chunk is allocated, so a
+// pool that reached its peak never touches the heap again. Not thread safe.
+class PoolAllocator {
+public:
+    explicit PoolAllocator(Size blockSize, Size blocksPerChunk = 256,
+                           Size alignment = alignof(std::max_align_t));
+    ~PoolAllocator();
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator = (const PoolAllocator&) = delete;
+
+    void* allocate();
+    void deallocate(void* block) noexcept;
+
+    // Carve chunks until at least count blocks exist
+    void reserve(Size count);
+
+    Size blockSize() const noexcept { return blockBytes; }
+    Size capacity() const noexcept { return blockCount; }   // blocks carved so far
+    Size liveBlocks() const noexcept { return live; }       // allocated, not yet freed
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void grow();
+
+    Size blockBytes;
+    Size blocksPerChunk;
+    Size alignment;
+    FreeBlock* freeList = nullptr;
+    std::vector<void*> chunks;
+    Size blockCount = 0;
+    Size live = 0;
+};
+
+// Typed front end of a PoolAllocator
+template <typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(Size blocksPerChunk = 256) : pool(sizeof(T), blocksPerChunk, alignof(T)) {}
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        void* block = pool.allocate();
+        return new (block) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object) noexcept {
+        if (!object) return;
+        object->~T();
+        pool.deallocate(object);
+    }
+
+    Size liveObjects() const noexcept { return pool.liveBlocks(); }
+
+private:
+    PoolAllocator pool;
+};
+
+// Linear allocator for scratch memory with a common lifetime, e.g. one world
+// step: allocations bump a pointer and reset() releases all of them at once.
+// When a frame overflows the chunk, the next reset() replaces the chunks with
+// one big enough for the whole frame, so a steady workload settles on a single
+// chunk and no heap traffic. Not thread safe.
+class FrameArena {
+public:
+    explicit FrameArena(Size chunkSize = 64 * 1024);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator = (const FrameArena&) = delete;
+
+    void* allocate(Size bytes, Size align = alignof(std::max_align_t));
+
+    // Uninitialised storage for count objects; they are never destroyed
+    template <typename T>
+    T* allocateArray(Size count) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena memory is released without destructors");
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void reset();
+
+    Size used() const noexcept { return usedBytes; }       // allocated since the last reset
+    Size capacity() const noexcept { return totalBytes; }  // bytes held in chunks
+
+private:
+    struct Chunk {
+        std::byte* data;
+        Size size;
+    };
+
+    void addChunk(Size minBytes);
+    void releaseChunks() noexcept;
+
+    Size chunkSize;
+    std::vector<Chunk> chunks;
+    std::byte* cursor = nullptr;
+    std::byte* limit = nullptr;
+    Size usedBytes = 0;
+    Size totalBytes = 0;
+};
+
+// Allocator policies for containers such as Array<T>: raw storage with an
+// explicit size and alignment
+
+// General heap
+struct HeapAllocator {
+    void* allocate(Size bytes, Size align) {
+        if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) return ::operator new(bytes);
+        return ::operator new(bytes, std::align_val_t(align));
+    }
+    void deallocate(void* block, Size, Size align) noexcept {
+        if (align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) ::operator delete(block);
+        else ::operator delete(block, std::align_val_t(align));
+    }
+};
+
+// Storage from a FrameArena. Freeing is a no-op: the arena's reset releases
+// everything, so containers on it must not outlive that reset.
+struct ArenaAllocator {
+    FrameArena* arena = nullptr;
+
+    void* allocate(Size bytes, Size align) { return arena->allocate(bytes, align); }
+    void deallocate(void*, Size, Size) noexcept {}
+};
+
+} // namespace RK
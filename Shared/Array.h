@@ -6,83 +6,152 @@
 
 #include <iostream>
 #include <initializer_list>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <Shared/Allocator.h>
 #include <Shared/Types.h>
 
-template <typename T>
+// Growable contiguous array. Storage is raw memory from Alloc; elements are
+// constructed in place only when they exist, so T needs no default
+// constructor. Capacity grows geometrically. Trivially copyable elements are
+// relocated with memcpy, others are moved and destroyed one by one (copied
+// if their move may throw, so a failed growth leaves the array untouched).
+template <typename T, typename Alloc = RK::HeapAllocator>
 class Array {
 
 public:
     ~Array () {
-        delete[] _data;
+        destroyAll();
+        release();
     }
 
     Array () = default;
 
-    Array(const std::initializer_list<T> & list) {
-        _data = new T[list.size()];
-        _size = list.size();
-        Size i = 0;
+    explicit Array (const Alloc& allocator) : _allocator(allocator) {}
+
+    Array(const std::initializer_list<T> & list, const Alloc& allocator = Alloc()) : _allocator(allocator) {
+        reserve(list.size());
         for (const T & item : list) {
-            _data[i++] = item;
+            new (_data + _size) T(item);
+            _size++;
         }
     }
 
     // Copy
-    Array (const Array& other) {
-        _data = new T[other._size];
-        _size = other._size;
-        Size i = 0;
-        for (const T & item : other)
-            _data[i++] = item;
+    Array (const Array& other) : _allocator(other._allocator) {
+        reserve(other._size);
+        for (const T & item : other) {
+            new (_data + _size) T(item);
+            _size++;
+        }
     }
     Array& operator = (const Array& other) {
         if (this == &other) {
             return *this;
         }
-        T *newData = new T[other._size];
-        delete[] _data;
-
-        for (Size i = 0; i < other._size; i++) {
-            newData[i] = other._data[i];
+        clear();
+        reserve(other._size);
+        for (const T & item : other) {
+            new (_data + _size) T(item);
+            _size++;
         }
-        _size = other._size;
-        _data = newData;
         return *this;
     }
 
     // Move
-    Array (Array&& other) noexcept {
+    Array (Array&& other) noexcept : _allocator(other._allocator) {
         _data = other._data;
         _size = other._size;
+        _capacity = other._capacity;
         other._data = nullptr;
         other._size = 0;
+        other._capacity = 0;
     }
     Array& operator = (Array&& other) noexcept {
         if (this == &other) {
             return *this;
         }
-        delete [] _data;
+        destroyAll();
+        release();
+        _allocator = other._allocator;
         _data = other._data;
         _size = other._size;
+        _capacity = other._capacity;
         other._data = nullptr;
         other._size = 0;
+        other._capacity = 0;
         return *this;
     }
 
     /* --------------------------------------------------------- */
     Size size () const noexcept { return _size; }
+    Size capacity () const noexcept { return _capacity; }
+    Bool empty () const noexcept { return _size == 0; }
 
     T& operator[] (Size index) const noexcept { return _data[index]; }
 
     T* data () const noexcept { return _data; }
 
+    T& front () const noexcept { return _data[0]; }
+    T& back () const noexcept { return _data[_size - 1]; }
+
+    // Make room for capacity elements without constructing any
+    void reserve (const Size capacity) {
+        if (capacity > _capacity) reallocate(capacity);
+    }
+
+    template <typename... Args>
+    T& emplace_back (Args&&... args) {
+        if (_size < _capacity) {
+            new (_data + _size) T(std::forward<Args>(args)...);
+        } else {
+            // Build the new element first: args may refer to an element of
+            // the old buffer
+            const Size capacity = grownCapacity(_size + 1);
+            T* buffer = allocate(capacity);
+            try {
+                new (buffer + _size) T(std::forward<Args>(args)...);
+            } catch (...) {
+                deallocate(buffer, capacity);
+                throw;
+            }
+            try {
+                relocate(buffer);
+            } catch (...) {
+                buffer[_size].~T();
+                deallocate(buffer, capacity);
+                throw;
+            }
+            release();
+            _data = buffer;
+            _capacity = capacity;
+        }
+        return _data[_size++];
+    }
+
+    void push_back (const T& value) { emplace_back(value); }
+    void push_back (T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back () noexcept {
+        _size--;
+        _data[_size].~T();
+    }
+
+    // Destroys the elements, keeps the storage
+    void clear () noexcept {
+        destroyAll();
+        _size = 0;
+    }
+
+    // New elements are value-initialised
     void resize (const Size size) {
-      if (size == _size || size < 1) return;
-      T *buffer = new T[size];
-      std::copy(_data, _data+sizeof(T)*std::min(size, _size), buffer);
-      _size = size;
-      delete [] _data;
-      _data = buffer;
+        resizeWith(size, [](T* slot) { new (slot) T(); });
+    }
+
+    void resize (const Size size, const T& value) {
+        resizeWith(size, [&value](T* slot) { new (slot) T(value); });
     }
 
     // ---------  Iterators ----------------
@@ -100,14 +169,7 @@ public:
     }
     // Not compare
     Bool operator != (const Array& other) const noexcept {
-        if (_size != other._size) 
-            return true;
-	    bool is_all_equals = true;
-	    for (Size i = 0; i < _size; i++) {
-		    if (_data[i] != other._data[i])
-            is_all_equals = false;
-	    }
-	    return !is_all_equals;	
+        return !(*this == other);
     }
 
     // Output stream
@@ -119,7 +181,87 @@ public:
     }
 
 private:
+    static constexpr Bool trivial = std::is_trivially_copyable_v<T>;
+
+    Size grownCapacity (const Size needed) const noexcept {
+        const Size doubled = _capacity < 8 ? 8 : _capacity * 2;
+        return doubled > needed ? doubled : needed;
+    }
+
+    T* allocate (const Size capacity) {
+        return static_cast<T*>(_allocator.allocate(capacity * sizeof(T), alignof(T)));
+    }
+
+    void deallocate (T* buffer, const Size capacity) noexcept {
+        _allocator.deallocate(buffer, capacity * sizeof(T), alignof(T));
+    }
+
+    void release () noexcept {
+        if (_data) deallocate(_data, _capacity);
+        _data = nullptr;
+        _capacity = 0;
+    }
+
+    // Move the elements into buffer and end their lifetime here. Types whose
+    // move may throw are copied instead, and if a copy throws the copies made
+    // so far are destroyed and the elements stay where they were.
+    void relocate (T* buffer) {
+        if (_size == 0) return;
+        if constexpr (trivial) {
+            std::memcpy(static_cast<void*>(buffer), static_cast<const void*>(_data), _size * sizeof(T));
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            for (Size i = 0; i < _size; i++) {
+                new (buffer + i) T(std::move(_data[i]));
+                _data[i].~T();
+            }
+        } else {
+            Size copied = 0;
+            try {
+                for (; copied < _size; copied++) {
+                    new (buffer + copied) T(static_cast<const T&>(_data[copied]));
+                }
+            } catch (...) {
+                while (copied > 0) buffer[--copied].~T();
+                throw;
+            }
+            destroyAll();
+        }
+    }
+
+    void reallocate (const Size capacity) {
+        T* buffer = allocate(capacity);
+        try {
+            relocate(buffer);
+        } catch (...) {
+            deallocate(buffer, capacity);
+            throw;
+        }
+        release();
+        _data = buffer;
+        _capacity = capacity;
+    }
+
+    void destroyAll () noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (Size i = 0; i < _size; i++) _data[i].~T();
+        }
+    }
+
+    template <typename Construct>
+    void resizeWith (const Size size, Construct&& construct) {
+        if (size < _size) {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (Size i = size; i < _size; i++) _data[i].~T();
+            }
+            _size = size;
+            return;
+        }
+        reserve(size);
+        for (; _size < size; _size++) construct(_data + _size);
+    }
+
     T *_data = nullptr;
     Size _size = 0;
+    Size _capacity = 0;
+    [[no_unique_address]] Alloc _allocator;
 };
-
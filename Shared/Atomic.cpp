@@ -0,0 +1,33 @@
+//
+// Lock-free building blocks.
+//
+
+#include <Shared/Atomic.h>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace RK
+{
+
+static inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+void Backoff::pause() noexcept {
+    // Up to 2^6 pause hints, a few hundred nanoseconds, before giving up the core
+    if (step <= 6) {
+        for (UInt32 i = 0; i < (1u << step); i++) cpuRelax();
+        step++;
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace RK
@@ -0,0 +1,313 @@
+//
+// Lock-free building blocks: SPSC ring, bounded MPMC queue, Chase-Lev
+// work-stealing deque and a cache-line padded counter.
+//
+
+#pragma once
+
+#include <Shared/Types.h>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace RK
+{
+
+// Destructive interference size on the targets we build for. Fixed rather
+// than std::hardware_destructive_interference_size, which may change between
+// compiler versions and so is not ABI stable.
+constexpr Size CacheLineSize = 64;
+
+// Keeps value on a cache line of its own, so threads writing neighbouring
+// data do not invalidate it
+template <typename T>
+struct alignas(CacheLineSize) CachePadded {
+    T value{};
+};
+
+// Spin wait for the lock-free queues: a few rounds of exponentially more CPU
+// pause hints, then yielding the thread
+class Backoff {
+public:
+    void pause() noexcept;
+    void reset() noexcept { step = 0; }
+
+private:
+    UInt32 step = 0;
+};
+
+// Round up to a power of two, at least 2
+inline Size ringCapacity(Size capacity) noexcept {
+    Size result = 2;
+    while (result < capacity) result <<= 1;
+    return result;
+}
+
+// Relaxed counter alone on its cache line. Many threads may add at once.
+class alignas(CacheLineSize) PaddedCounter {
+public:
+    UInt64 add(UInt64 amount = 1) noexcept { return value.fetch_add(amount, std::memory_order_relaxed) + amount; }
+    UInt64 load() const noexcept { return value.load(std::memory_order_relaxed); }
+    void reset() noexcept { value.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<UInt64> value{0};
+};
+
+// Bounded single-producer single-consumer ring. One thread may push and one
+// other thread may pop at the same time; each side keeps a cached copy of
+// the other's index and only rereads it when the ring looks full or empty.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(Size capacity)
+        : mask(ringCapacity(capacity) - 1), slots(new Slot[mask + 1]) {}
+
+    ~SpscRing() {
+        const Size tail = producer.value.tail.load(std::memory_order_acquire);
+        for (Size i = consumer.value.head.load(std::memory_order_relaxed); i != tail; i++) {
+            std::launder(reinterpret_cast<T*>(slots[i & mask].storage))->~T();
+        }
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator = (const SpscRing&) = delete;
+
+    // Producer
+    template <typename... Args>
+    Bool tryEmplace(Args&&... args) {
+        const Size tail = producer.value.tail.load(std::memory_order_relaxed);
+        if (tail - producer.value.cachedHead > mask) {
+            producer.value.cachedHead = consumer.value.head.load(std::memory_order_acquire);
+            if (tail - producer.value.cachedHead > mask) return false;
+        }
+        new (slots[tail & mask].storage) T(std::forward<Args>(args)...);
+        producer.value.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    Bool tryPush(const T& item) { return tryEmplace(item); }
+    Bool tryPush(T&& item) { return tryEmplace(std::move(item)); }
+
+    // Consumer
+    Bool tryPop(T& out) {
+        const Size head = consumer.value.head.load(std::memory_order_relaxed);
+        if (head == consumer.value.cachedTail) {
+            consumer.value.cachedTail = producer.value.tail.load(std::memory_order_acquire);
+            if (head == consumer.value.cachedTail) return false;
+        }
+        T* item = std::launder(reinterpret_cast<T*>(slots[head & mask].storage));
+        out = std::move(*item);
+        item->~T();
+        consumer.value.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    Size capacity() const noexcept { return mask + 1; }
+
+    // Exact only while neither side is running
+    Size size() const noexcept {
+        return producer.value.tail.load(std::memory_order_acquire) - consumer.value.head.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+    struct Producer {
+        std::atomic<Size> tail{0};
+        Size cachedHead = 0;
+    };
+    struct Consumer {
+        std::atomic<Size> head{0};
+        Size cachedTail = 0;
+    };
+
+    const Size mask;
+    std::unique_ptr<Slot[]> slots;
+    CachePadded<Producer> producer;
+    CachePadded<Consumer> consumer;
+};
+
+// Bounded multi-producer multi-consumer queue (Vyukov). Every slot carries a
+// sequence number telling whether it is ready for the producer or the
+// consumer of a given lap, so a push or pop costs one CAS on the shared index
+// and never waits for a stalled thread on another slot.
+template <typename T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(Size capacity)
+        : mask(ringCapacity(capacity) - 1), cells(new Cell[mask + 1]) {
+        for (Size i = 0; i <= mask; i++) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~MpmcQueue() {
+        const Size end = enqueuePos.value.load(std::memory_order_acquire);
+        for (Size i = dequeuePos.value.load(std::memory_order_relaxed); i != end; i++) {
+            std::launder(reinterpret_cast<T*>(cells[i & mask].storage))->~T();
+        }
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator = (const MpmcQueue&) = delete;
+
+    template <typename... Args>
+    Bool tryEmplace(Args&&... args) {
+        Size pos = enqueuePos.value.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            const Size sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // full
+            } else {
+                pos = enqueuePos.value.load(std::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    Bool tryPush(const T& item) { return tryEmplace(item); }
+    Bool tryPush(T&& item) { return tryEmplace(std::move(item)); }
+
+    Bool tryPop(T& out) {
+        Size pos = dequeuePos.value.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[pos & mask];
+            const Size sequence = cell->sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (dequeuePos.value.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // empty
+            } else {
+                pos = dequeuePos.value.load(std::memory_order_relaxed);
+            }
+        }
+        T* item = std::launder(reinterpret_cast<T*>(cell->storage));
+        out = std::move(*item);
+        item->~T();
+        // Ready for the producer of the next lap
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    Size capacity() const noexcept { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<Size> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    const Size mask;
+    std::unique_ptr<Cell[]> cells;
+    CachePadded<std::atomic<Size>> enqueuePos;
+    CachePadded<std::atomic<Size>> dequeuePos;
+};
+
+// Chase-Lev work-stealing deque (Lê, Pop, Cohen, Zappa Nardelli 2013). The
+// owning thread pushes and pops at the bottom, any thread may steal from the
+// top. Items are copied through atomics, so T must be small and trivially
+// copyable: an index or a pointer to the work. The ring grows on push; old
+// rings are kept until destruction because a thief may still be reading one.
+//
+// The paper's fences are expressed as seq_cst operations on top and bottom,
+// which ThreadSanitizer understands.
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "items are copied through atomics");
+    static_assert(std::atomic<T>::is_always_lock_free, "items must fit a lock-free atomic");
+
+public:
+    explicit WorkStealingDeque(Size capacity = 256) {
+        rings.push_back(std::make_unique<Ring>(ringCapacity(capacity)));
+        ring.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator = (const WorkStealingDeque&) = delete;
+
+    // Owner only
+    void push(T item) {
+        const Int64 b = bottom.value.load(std::memory_order_relaxed);
+        const Int64 t = top.value.load(std::memory_order_acquire);
+        Ring* r = ring.load(std::memory_order_relaxed);
+        if (b - t > static_cast<Int64>(r->mask)) r = grow(r, t, b);
+        r->put(b, item);
+        bottom.value.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only, newest first
+    Bool pop(T& out) {
+        const Int64 b = bottom.value.load(std::memory_order_relaxed) - 1;
+        Ring* r = ring.load(std::memory_order_relaxed);
+        bottom.value.store(b, std::memory_order_seq_cst);
+        Int64 t = top.value.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom.value.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = r->get(b);
+        if (t < b) return true;
+        // The last item: race the thieves for it
+        const Bool won = top.value.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                           std::memory_order_relaxed);
+        bottom.value.store(b + 1, std::memory_order_relaxed);
+        return won;
+    }
+
+    // Any thread, oldest first. False if empty or another thread got the item.
+    Bool steal(T& out) {
+        Int64 t = top.value.load(std::memory_order_seq_cst);
+        const Int64 b = bottom.value.load(std::memory_order_seq_cst);
+        if (t >= b) return false;
+        const T item = ring.load(std::memory_order_acquire)->get(t);
+        if (!top.value.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        out = item;
+        return true;
+    }
+
+    // A snapshot; other threads may change it right away
+    Size size() const noexcept {
+        const Int64 b = bottom.value.load(std::memory_order_relaxed);
+        const Int64 t = top.value.load(std::memory_order_relaxed);
+        return b > t ? static_cast<Size>(b - t) : 0;
+    }
+    Bool empty() const noexcept { return size() == 0; }
+
+private:
+    struct Ring {
+        explicit Ring(Size capacity) : mask(capacity - 1), items(new std::atomic<T>[capacity]) {}
+
+        T get(Int64 i) const noexcept { return items[i & mask].load(std::memory_order_relaxed); }
+        void put(Int64 i, T item) noexcept { items[i & mask].store(item, std::memory_order_relaxed); }
+
+        const Size mask;
+        std::unique_ptr<std::atomic<T>[]> items;
+    };
+
+    Ring* grow(Ring* old, Int64 t, Int64 b) {
+        rings.push_back(std::make_unique<Ring>((old->mask + 1) * 2));
+        Ring* bigger = rings.back().get();
+        for (Int64 i = t; i < b; i++) bigger->put(i, old->get(i));
+        ring.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    CachePadded<std::atomic<Int64>> top;
+    CachePadded<std::atomic<Int64>> bottom;
+    std::atomic<Ring*> ring{nullptr};
+    std::vector<std::unique_ptr<Ring>> rings; // owner only
+};
+
+} // namespace RK
@@ -0,0 +1,36 @@
+//
+// Non-owning reference to a callable, for passing callbacks through virtual
+// interfaces without std::function's allocation.
+//
+
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+namespace RK
+{
+
+template <typename Signature>
+class FunctionRef;
+
+// Holds a pointer to the callable: it must outlive the FunctionRef, which is
+// meant to be a by-value parameter
+template <typename R, typename... Args>
+class FunctionRef<R(Args...)> {
+public:
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, FunctionRef>>>
+    FunctionRef(F&& f) noexcept
+        : object(const_cast<void*>(static_cast<const void*>(&f))),
+          invoke([](void* o, Args... args) -> R {
+              return (*static_cast<std::remove_reference_t<F>*>(o))(std::forward<Args>(args)...);
+          }) {}
+
+    R operator () (Args... args) const { return invoke(object, std::forward<Args>(args)...); }
+
+private:
+    void* object;
+    R (*invoke)(void*, Args...);
+};
+
+} // namespace RK
@@ -0,0 +1,66 @@
+//
+// Fast non-cryptographic hashing of large buffers.
+//
+
+#pragma once
+
+#include <Shared/Types.h>
+#include <cstring>
+
+namespace RK
+{
+
+namespace detail {
+
+constexpr UInt64 HashPrime1 = 0x9E3779B185EBCA87ull;
+constexpr UInt64 HashPrime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr UInt64 HashPrime3 = 0x165667B19E3779F9ull;
+
+inline UInt64 rotl(UInt64 x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline UInt64 hashRound(UInt64 acc, UInt64 word) {
+    return rotl(acc + word * HashPrime2, 31) * HashPrime1;
+}
+
+inline UInt64 readWord(const UChar* p) {
+    UInt64 word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+} // namespace detail
+
+// 64-bit hash with XXH64-style rounds. The bulk runs four independent lanes
+// over 32 bytes per iteration so the multiplies overlap, several GB/s on one
+// core. Chain calls through seed to hash several buffers as one.
+inline UInt64 hashBytes(const void* data, Size bytes, UInt64 seed = 0) {
+    using namespace detail;
+    const UChar* p = static_cast<const UChar*>(data);
+    const UChar* end = p + bytes;
+    UInt64 hash;
+
+    if (bytes >= 32) {
+        UInt64 lanes[4] = {seed + HashPrime1 + HashPrime2, seed + HashPrime2, seed, seed - HashPrime1};
+        for (; p + 32 <= end; p += 32) {
+            for (int i = 0; i < 4; i++) lanes[i] = hashRound(lanes[i], readWord(p + 8 * i));
+        }
+        hash = rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18);
+        for (int i = 0; i < 4; i++) hash = (hash ^ hashRound(0, lanes[i])) * HashPrime1 + HashPrime3;
+    } else {
+        hash = seed + HashPrime3;
+    }
+    hash += bytes;
+
+    for (; p + 8 <= end; p += 8) hash = rotl(hash ^ hashRound(0, readWord(p)), 27) * HashPrime1 + HashPrime3;
+    for (; p < end; p++) hash = rotl(hash ^ (*p * HashPrime3), 11) * HashPrime1;
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= HashPrime2;
+    hash ^= hash >> 29;
+    hash *= HashPrime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+} // namespace RK
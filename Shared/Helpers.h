@@ -7,23 +7,88 @@
 #include <Shared/Types.h>
 #include <iostream>
 
+// The SSE2 string loops read whole 16 byte blocks, which can run past the
+// terminator inside the same page. That is harmless on real hardware but is
+// an overflow to AddressSanitizer, so sanitized builds use the scalar loops.
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define RK_NO_SIMD_STRINGS 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#define RK_NO_SIMD_STRINGS 1
+#endif
+
+#if defined(__SSE2__) && !defined(RK_NO_SIMD_STRINGS)
+#define RK_SIMD_STRINGS 1
+#include <emmintrin.h>
+#endif
+
 namespace RK
 {
 
+#if defined(RK_SIMD_STRINGS)
+// True if a 16 byte load at ptr could touch the next page
+inline Bool nearPageEnd(const char * ptr) {
+    return (reinterpret_cast<uintptr_t>(ptr) & 4095) > 4096 - 16;
+}
+#endif
+
+// 16 bytes per step with SSE2. Loads are aligned, so they never cross into a
+// page the string does not reach.
 inline Size str_length(const char * str) {
+#if defined(RK_SIMD_STRINGS)
+    const __m128i zero = _mm_setzero_si128();
+    const Size misalign = reinterpret_cast<uintptr_t>(str) & 15;
+    const char *block = str - misalign;
+    UInt32 mask = static_cast<UInt32>(_mm_movemask_epi8(
+        _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(block)), zero))) >> misalign;
+    if (mask) return __builtin_ctz(mask);
+    for (;;) {
+        block += 16;
+        mask = static_cast<UInt32>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(block)), zero)));
+        if (mask) return static_cast<Size>(block - str) + __builtin_ctz(mask);
+    }
+#else
     const char *ptr = str;
     while (*ptr != '\0')
         ptr++;
     return ptr - str;
+#endif
 }
 
+// 0 if the strings are equal, 1 otherwise. Compares 16 bytes per step with
+// SSE2, falling back to single bytes only next to a page boundary.
 inline Size str_compare(const char * s1, const char * s2) {
-    if (*s1 != *s2) return 0;
-    while (*++s1 == *++s2 && (*s1 != '\0' && *s2 != '\0'));
-    if (*s1 == '\0' && *s2 == '\0') return 0;
-    int miss = 0;
-    while (*s1 && *s2 && *s1++ != *s2++) miss++;
-    return miss;
+#if defined(RK_SIMD_STRINGS)
+    const __m128i zero = _mm_setzero_si128();
+    Size i = 0;
+    for (;;) {
+        if (nearPageEnd(s1 + i) || nearPageEnd(s2 + i)) {
+            if (s1[i] != s2[i]) return 1;
+            if (s1[i] == '\0') return 0;
+            i++;
+            continue;
+        }
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + i));
+        const UInt32 diff = ~static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) & 0xFFFF;
+        const UInt32 ends = static_cast<UInt32>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, zero)));
+        if (diff | ends) {
+            // Whichever comes first decides: a mismatch or the shared terminator
+            return (diff >> __builtin_ctz(diff | ends)) & 1;
+        }
+        i += 16;
+    }
+#else
+    while (*s1 == *s2) {
+        if (*s1 == '\0') return 0;
+        s1++;
+        s2++;
+    }
+    return 1;
+#endif
 }
 
 template <typename T>
@@ -0,0 +1,127 @@
+//
+// Worker pool with per-thread work-stealing deques.
+//
+
+#include <Shared/JobSystem.h>
+#include <algorithm>
+
+namespace RK
+{
+
+namespace {
+// Which pool the current thread works for, and its queue there
+thread_local const JobSystem* tlsPool = nullptr;
+thread_local Size tlsQueue = 0;
+}
+
+JobSystem::JobSystem(Size threadCount)
+    : poolSize(threadCount > 0 ? threadCount : 1) {
+    queues = std::make_unique<Queue[]>(poolSize);
+    workers.reserve(poolSize - 1);
+    for (Size i = 1; i < poolSize; i++) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true);
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+Size JobSystem::currentQueue() const {
+    return tlsPool == this ? tlsQueue : 0;
+}
+
+void JobSystem::run(RangeFn invoke, const void* fn, Size begin, Size end, Size grain) {
+    if (poolSize == 1 || end - begin <= grain) {
+        // Still hand out grain sized pieces, callers may rely on it
+        for (Size b = begin; b < end; b += grain) {
+            invoke(fn, b, std::min(end, b + grain));
+        }
+        return;
+    }
+
+    Group group{invoke, fn, grain, {end - begin}};
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        activeGroups.fetch_add(1);
+    }
+    wake.notify_all();
+
+    const Size queue = currentQueue();
+    execute(queue, Task{&group, begin, end});
+
+    // Help with whatever is queued until our own range is done
+    while (group.remaining.load(std::memory_order_acquire) > 0) {
+        Task task;
+        if (pop(queue, task) || steal(queue, task)) {
+            execute(queue, task);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    activeGroups.fetch_sub(1);
+}
+
+void JobSystem::execute(Size queue, Task task) {
+    const Size grain = task.group->grain;
+    // Split off upper halves, on grain boundaries, for others to steal
+    while (task.end - task.begin > grain) {
+        const Size chunks = (task.end - task.begin + grain - 1) / grain;
+        const Size mid = task.begin + (chunks / 2) * grain;
+        {
+            std::lock_guard<std::mutex> lock(queues[queue].mutex);
+            queues[queue].pushBack(Task{task.group, mid, task.end});
+        }
+        task.end = mid;
+    }
+    task.group->invoke(task.group->fn, task.begin, task.end);
+    task.group->remaining.fetch_sub(task.end - task.begin, std::memory_order_acq_rel);
+}
+
+// Newest task of our own queue
+bool JobSystem::pop(Size queue, Task& task) {
+    std::lock_guard<std::mutex> lock(queues[queue].mutex);
+    if (queues[queue].empty()) return false;
+    task = queues[queue].popBack();
+    return true;
+}
+
+// Oldest task of some other queue
+bool JobSystem::steal(Size thief, Task& task) {
+    const Size count = threadCount();
+    for (Size offset = 1; offset < count; offset++) {
+        Queue& victim = queues[(thief + offset) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.empty()) continue;
+        task = victim.popFront();
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::workerLoop(Size index) {
+    tlsPool = this;
+    tlsQueue = index;
+    while (!stopping.load()) {
+        Task task;
+        if (pop(index, task) || steal(index, task)) {
+            execute(index, task);
+            continue;
+        }
+        if (activeGroups.load() > 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping.load() || activeGroups.load() > 0; });
+    }
+}
+
+} // RK
@@ -0,0 +1,124 @@
+//
+// Worker pool with per-thread work-stealing deques.
+//
+
+#pragma once
+
+#include <Shared/Types.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace RK
+{
+
+// A pool of threadCount - 1 workers; the thread calling parallel_for works
+// too. Ranges are split lazily: a thread keeps halving its range, pushes the
+// upper halves onto its own deque and runs the rest. Idle threads steal the
+// oldest (largest) halves from the other deques.
+class JobSystem {
+public:
+    explicit JobSystem(Size threadCount = defaultThreadCount());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator = (const JobSystem&) = delete;
+
+    Size threadCount() const noexcept { return poolSize; }
+
+    static Size defaultThreadCount() {
+        const Size hw = std::thread::hardware_concurrency();
+        return hw > 0 ? hw : 1;
+    }
+
+    // Calls fn(chunkBegin, chunkEnd) for pieces of [begin, end) and returns
+    // once all of them ran. Pieces start at begin + k * grain and are at most
+    // grain long, whatever the thread count.
+    template <typename Fn>
+    void parallel_for(Size begin, Size end, Size grain, Fn&& fn) {
+        if (begin >= end) return;
+        if (grain == 0) grain = 1;
+        using FnType = std::remove_reference_t<Fn>;
+        RangeFn invoke = [](const void* f, Size b, Size e) {
+            (*static_cast<FnType*>(const_cast<void*>(f)))(b, e);
+        };
+        run(invoke, &fn, begin, end, grain);
+    }
+
+private:
+    using RangeFn = void (*)(const void* fn, Size begin, Size end);
+
+    struct Group {
+        RangeFn invoke;
+        const void* fn;
+        Size grain;
+        std::atomic<Size> remaining; // items not yet processed
+    };
+
+    struct Task {
+        Group* group;
+        Size begin;
+        Size end;
+    };
+
+    // Queue 0 belongs to threads outside the pool, 1.. to the workers. A ring
+    // buffer rather than std::deque: it keeps its storage when it runs empty,
+    // so steady parallel_for calls do not allocate.
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::vector<Task> ring; // size is zero or a power of two
+        Size head = 0;
+        Size count = 0;
+
+        bool empty() const { return count == 0; }
+
+        void pushBack(const Task& task) {
+            if (count == ring.size()) grow();
+            ring[(head + count) & (ring.size() - 1)] = task;
+            ++count;
+        }
+
+        Task popBack() {
+            --count;
+            return ring[(head + count) & (ring.size() - 1)];
+        }
+
+        Task popFront() {
+            const Task task = ring[head];
+            head = (head + 1) & (ring.size() - 1);
+            --count;
+            return task;
+        }
+
+        void grow() {
+            std::vector<Task> bigger(ring.empty() ? 16 : ring.size() * 2);
+            for (Size i = 0; i < count; i++) bigger[i] = ring[(head + i) & (ring.size() - 1)];
+            ring.swap(bigger);
+            head = 0;
+        }
+    };
+
+    void run(RangeFn invoke, const void* fn, Size begin, Size end, Size grain);
+    void workerLoop(Size index);
+    void execute(Size queue, Task task);
+    bool pop(Size queue, Task& task);
+    bool steal(Size thief, Task& task);
+    Size currentQueue() const;
+
+    // Fixed before the first worker starts; workers read it while the
+    // constructor is still filling in workers
+    const Size poolSize;
+    std::vector<std::thread> workers;
+    std::unique_ptr<Queue[]> queues;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<Size> activeGroups{0};
+    std::atomic<Bool> stopping{false};
+};
+
+} // RK
@@ -6,101 +6,179 @@
 
 #include <Shared/Types.h>
 #include <Shared/Helpers.h>
+#include <cstring>
 #include <initializer_list>
 #include <type_traits>
 
 namespace RK {
 
-// String
+// String with small-string optimisation: up to InlineCapacity characters live
+// inside the object itself, longer ones on the heap. Always null terminated.
+//
+// Layout (24 bytes on 64-bit): either {data, size, capacity} for heap strings,
+// or the characters inline with the last byte holding the inline size. The top
+// bit of that byte, which is the top byte of capacity in heap mode, tells the
+// two apart.
 template <typename T>
 struct StringImpl {
     using ValType = T;
+    static_assert(std::is_trivially_copyable_v<ValType>, "characters are copied as bytes");
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "the heap flag lives in the top byte of capacity");
+
+private:
+    struct Heap {
+        ValType *data;
+        Size size;
+        Size capacity;  // top byte holds HeapFlag
+    };
+    static constexpr Size TagByte = sizeof(Heap) - 1;
+    static constexpr UInt8 HeapFlag = 0x80;
+    static constexpr Size HeapBits = Size(HeapFlag) << (8 * (sizeof(Size) - 1));
+
+public:
+    // Characters held without allocating, not counting the terminator
+    static constexpr Size InlineCapacity = TagByte / sizeof(ValType) - 1;
+
     /* ---------  CONSTRUCTORS  --------- */
     ~StringImpl () {
-        delete[] _data;
+        if (!isInline()) delete[] _heap.data;
     }
     StringImpl () = default;
 
     StringImpl(const char* str) {
         const Size len = str_length(str);
-        _data = new ValType[len+1];
-        _size = len;
-        for (Size index = 0; index < len; index++ ) {
-            _data[index] = str[index];
+        reserve(len);
+        ValType *dst = data();
+        if constexpr (std::is_same_v<ValType, char>) {
+            std::memcpy(dst, str, len);
+        } else {
+            for (Size index = 0; index < len; index++ ) {
+                dst[index] = str[index];
+            }
         }
+        setSize(len);
     }
     StringImpl(const std::initializer_list<ValType>& list) {
-        _data = new ValType[list.size()+1];
-        _size = list.size();
-        Size index = 0;
-        for (const ValType & item : list) {
-            _data[index++] = item;
-        }
+        assign(list.begin(), list.size());
     }
     // Copy
     StringImpl (const StringImpl& other) {
-        _data = new ValType[other.size() + 1];
-        _size = other.size();
-        Size i = 0;
-        for (const ValType & item : other) {
-            _data[i++] = item;
-        }
+        assign(other.data(), other.size());
     }
-    // Move
+    // Move: the representation is taken over bytewise, other becomes empty
     StringImpl (StringImpl&& other) noexcept {
-        _data = other._data;
-        _size = other._size;
-        other._data = nullptr;
-        other._size = 0;
+        std::memcpy(_bytes, other._bytes, sizeof(_bytes));
+        other.makeEmpty();
     }
 
     StringImpl& operator = (const StringImpl& other) {
         if (this == &other) { return *this; }
-        delete[] _data;
-        _data = new ValType[other._size + 1];
-        _size = other._size;
-        Size i = 0;
-        for (const ValType & item : other) {
-            _data[i++] = item;
-        }
+        assign(other.data(), other.size());
         return *this;
     }
 
     StringImpl& operator = (StringImpl&& other) noexcept {
         if (this == &other) { return *this; }
-        delete[] _data;
-        _data = other._data;
-        _size = other._size;
-        other._data = nullptr;
-        other._size = 0;
+        if (!isInline()) delete[] _heap.data;
+        std::memcpy(_bytes, other._bytes, sizeof(_bytes));
+        other.makeEmpty();
         return *this;
     }
 
     /* --------------------------------------------------------- */
-    Size size () const noexcept { return _size; }
-    const ValType* value() const { return _data; }
+    Bool isInline () const noexcept { return !(_bytes[TagByte] & HeapFlag); }
+
+    Size size () const noexcept { return isInline() ? _bytes[TagByte] : _heap.size; }
+    Bool empty () const noexcept { return size() == 0; }
+    Size capacity () const noexcept { return isInline() ? InlineCapacity : _heap.capacity & ~HeapBits; }
+
+    const ValType* value() const noexcept { return data(); }
+    const ValType* data () const noexcept { return isInline() ? _small : _heap.data; }
+    ValType* data () noexcept { return isInline() ? _small : _heap.data; }
+    const ValType* c_str () const noexcept { return data(); }
+
+    const ValType& operator[] (Size index) const noexcept { return data()[index]; }
+    ValType& operator[] (Size index) noexcept { return data()[index]; }
+
+    // Grows with zero characters or truncates
+    void resize (const Size size) {
+        const Size old = this->size();
+        if (size > old) {
+            reserve(size);
+            std::memset(data() + old, 0, (size - old) * sizeof(ValType));
+        }
+        setSize(size);
+    }
+
+    void reserve (const Size capacity) {
+        if (capacity <= this->capacity()) return;
+        const Size len = size();
+        ValType *buffer = new ValType[capacity + 1];
+        std::memcpy(buffer, data(), (len + 1) * sizeof(ValType));
+        if (!isInline()) delete[] _heap.data;
+        _heap.data = buffer;
+        _heap.size = len;
+        _heap.capacity = capacity | HeapBits;
+    }
+
+    void assign (const ValType* str, Size len) {
+        if (len > capacity()) {
+            // Nothing to keep: drop the old contents before growing
+            setSize(0);
+            reserve(len);
+        }
+        std::memmove(data(), str, len * sizeof(ValType));
+        setSize(len);
+    }
 
-    ValType& operator[] (Size index) const noexcept { return _data[index]; }
-    void resize (const Size size) noexcept { _size = size; }
+    void append (const ValType* str, Size len) {
+        const Size old = size();
+        if (old + len > capacity()) {
+            // str may point into this string: fill the new buffer before
+            // the old one is released or overwritten
+            const Size grown = growCapacity(old + len);
+            ValType *buffer = new ValType[grown + 1];
+            std::memcpy(buffer, data(), old * sizeof(ValType));
+            std::memcpy(buffer + old, str, len * sizeof(ValType));
+            buffer[old + len] = ValType();
+            if (!isInline()) delete[] _heap.data;
+            _heap.data = buffer;
+            _heap.size = old + len;
+            _heap.capacity = grown | HeapBits;
+            return;
+        }
+        std::memcpy(data() + old, str, len * sizeof(ValType));
+        setSize(old + len);
+    }
 
-    ValType& operator[] (Size index) noexcept { return _data[index]; }
+    void push_back (ValType c) { append(&c, 1); }
 
     // ---------  Iterators ----------------
-    const ValType& begin () const noexcept { return _data; }
-    const ValType& end () const noexcept { return _data + _size; }
+    const ValType* begin () const noexcept { return data(); }
+    const ValType* end () const noexcept { return data() + size(); }
+    ValType* begin () noexcept { return data(); }
+    ValType* end () noexcept { return data() + size(); }
 
     // Compare if ValType = Char
     template<typename U = ValType>
     std::enable_if_t<std::is_same<U, Char>::value, Bool>
     operator == ( const char *str ) const {
-        return RK::str_compare(_data, str) == 0;
+        return RK::str_compare(data(), str) == 0;
     }
 
-    // Compare if ValType = Char
     template<typename U = ValType>
     std::enable_if_t<std::is_same<U, Char>::value, Bool>
-    operator == ( const StringImpl & other ) const {
-        return RK::str_compare(_data, other._data) == 0;
+    operator != ( const char *str ) const {
+        return !(*this == str);
+    }
+
+    Bool operator == ( const StringImpl & other ) const {
+        const Size len = size();
+        return len == other.size() && std::memcmp(data(), other.data(), len * sizeof(ValType)) == 0;
+    }
+
+    Bool operator != ( const StringImpl & other ) const {
+        return !(*this == other);
     }
 
     // Output stream
@@ -111,12 +189,28 @@ struct StringImpl {
         return os;
     }
 
-    // Swap
-
 private:
+    Size growCapacity (Size needed) const noexcept {
+        const Size doubled = capacity() * 2;
+        return doubled > needed ? doubled : needed;
+    }
+
+    void setSize (Size size) noexcept {
+        if (isInline()) _bytes[TagByte] = static_cast<UInt8>(size);
+        else _heap.size = size;
+        data()[size] = ValType();
+    }
+
+    void makeEmpty () noexcept {
+        std::memset(_bytes, 0, sizeof(_bytes));
+    }
+
     /* ---------  DATA  --------- */
-    ValType *_data = nullptr;
-    Size _size = 0;
+    union {
+        Heap _heap;
+        ValType _small[TagByte / sizeof(ValType)];
+        UInt8 _bytes[sizeof(Heap)] = {};
+    };
 };
 
 using String = StringImpl<Char>;
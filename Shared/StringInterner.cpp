@@ -0,0 +1,73 @@
+//
+// String interning.
+//
+
+#include <Shared/StringInterner.h>
+#include <cstring>
+
+namespace RK
+{
+
+StringInterner::StringInterner() : slots(64, InvalidStringId), text(16 * 1024) {
+    entries.push_back({"", 0, 0});
+}
+
+UInt32 StringInterner::hashOf(const char* str, Size length) noexcept {
+    // FNV-1a
+    UInt32 hash = 2166136261u;
+    for (Size i = 0; i < length; ++i) {
+        hash ^= static_cast<UChar>(str[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+Size StringInterner::probe(const char* str, Size length, UInt32 hash) const noexcept {
+    const Size mask = slots.size() - 1;
+    for (Size slot = hash & mask;; slot = (slot + 1) & mask) {
+        const StringId id = slots[slot];
+        if (id == InvalidStringId) return slot;
+        const Entry& entry = entries[id];
+        if (entry.hash == hash && entry.length == length && std::memcmp(entry.text, str, length) == 0) {
+            return slot;
+        }
+    }
+}
+
+StringId StringInterner::intern(const char* str, Size length) {
+    const UInt32 hash = hashOf(str, length);
+    Size slot = probe(str, length, hash);
+    if (slots[slot] != InvalidStringId) return slots[slot];
+
+    // Keep the load factor under a half
+    if ((entries.size() + 1) * 2 > slots.size()) {
+        grow();
+        slot = probe(str, length, hash);
+    }
+
+    char* copy = static_cast<char*>(text.allocate(length + 1, 1));
+    std::memcpy(copy, str, length);
+    copy[length] = '\0';
+
+    const StringId id = static_cast<StringId>(entries.size());
+    entries.push_back({copy, static_cast<UInt32>(length), hash});
+    slots[slot] = id;
+    return id;
+}
+
+StringId StringInterner::find(const char* str, Size length) const {
+    return slots[probe(str, length, hashOf(str, length))];
+}
+
+void StringInterner::grow() {
+    std::vector<StringId> old(slots.size() * 2, InvalidStringId);
+    old.swap(slots);
+    const Size mask = slots.size() - 1;
+    for (StringId id = 1; id < entries.size(); ++id) {
+        Size slot = entries[id].hash & mask;
+        while (slots[slot] != InvalidStringId) slot = (slot + 1) & mask;
+        slots[slot] = id;
+    }
+}
+
+} // namespace RK
@@ -0,0 +1,62 @@
+//
+// String interning: one stored copy per distinct string and a small integer id
+// that compares and hashes in O(1).
+//
+
+#pragma once
+
+#include <Shared/Allocator.h>
+#include <Shared/String.h>
+#include <Shared/Types.h>
+#include <vector>
+
+namespace RK
+{
+
+// Equal strings interned by the same interner get equal ids
+using StringId = UInt32;
+
+// Never handed out by intern(): the id of "no string"
+constexpr StringId InvalidStringId = 0;
+
+// Interned text is never freed or moved, so c_str() pointers stay valid for
+// the lifetime of the interner. Not thread safe.
+class StringInterner {
+public:
+    StringInterner();
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator = (const StringInterner&) = delete;
+
+    StringId intern(const char* str, Size length);
+    StringId intern(const char* str) { return intern(str, str_length(str)); }
+    StringId intern(const String& str) { return intern(str.c_str(), str.size()); }
+
+    // Id of a string interned before, InvalidStringId otherwise
+    StringId find(const char* str, Size length) const;
+    StringId find(const char* str) const { return find(str, str_length(str)); }
+
+    const char* c_str(StringId id) const noexcept { return entries[id].text; }
+    Size length(StringId id) const noexcept { return entries[id].length; }
+
+    Size size() const noexcept { return entries.size() - 1; }   // distinct strings interned
+
+private:
+    struct Entry {
+        const char* text;
+        UInt32 length;
+        UInt32 hash;
+    };
+
+    static UInt32 hashOf(const char* str, Size length) noexcept;
+
+    // Slot holding the string, or the empty slot where it would go
+    Size probe(const char* str, Size length, UInt32 hash) const noexcept;
+    void grow();
+
+    std::vector<Entry> entries;     // indexed by id; entry 0 is the invalid id
+    std::vector<StringId> slots;    // open addressing, power of two, 0 = empty
+    FrameArena text;                // never reset
+};
+
+} // namespace RK
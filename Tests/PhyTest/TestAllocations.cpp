@@ -0,0 +1,123 @@
+//
+// Steady stepping does not allocate: operator new is counted over 10k steps.
+//
+
+#include <Physics/Circle.h>
+#include <Physics/PhysicsWorld.h>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+static std::atomic<bool> counting{false};
+static std::atomic<size_t> allocations{0};
+
+void* operator new(size_t size) {
+    if (counting) ++allocations;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    if (counting) ++allocations;
+    const size_t a = static_cast<size_t>(align);
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Circles raining onto a ground with a few boxes and a bullet bouncing
+// between two walls, so every phase of the step has work
+static void populate(PhysicsWorld& world) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> x(10.0f, 390.0f), y(0.0f, 300.0f), r(2.0f, 4.0f);
+
+    for (float wallX : {0.0f, 400.0f}) {
+        BodyDef wall;
+        wall.shape = ShapeType::Rectangle;
+        wall.position = Vector2D(wallX - 5, -200);
+        wall.width = 5;
+        wall.height = 600;
+        wall.isStatic = true;
+        world.createBody(wall);
+    }
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 350);
+    ground.width = 400;
+    ground.height = 50;
+    ground.isStatic = true;
+    world.createBody(ground);
+
+    for (int i = 0; i < 200; ++i) {
+        BodyDef def;
+        def.position = Vector2D(x(rng), y(rng));
+        def.radius = r(rng);
+        def.restitution = 0.3f;
+        if (i % 10 == 0) {
+            def.shape = ShapeType::Rectangle;
+            def.width = def.height = 6;
+        }
+        world.createBody(def);
+    }
+
+    BodyDef bullet;
+    bullet.position = Vector2D(200, -100);
+    bullet.velocity = Vector2D(5000, 0);
+    bullet.radius = 1;
+    bullet.restitution = 1.0f;
+    bullet.bullet = true;
+    world.createBody(bullet);
+}
+
+static size_t countSteadyAllocations(std::unique_ptr<Broadphase> broadphase, RK::JobSystem* jobs) {
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    world.setBroadphase(std::move(broadphase));
+    world.setJobSystem(jobs);
+    world.getIslands().settings.enabled = false; // keep everything moving
+    populate(world);
+
+    // Warm up until every scratch buffer reached its peak size
+    for (int i = 0; i < 1200; ++i) world.update(1.0f / 60.0f);
+
+    allocations = 0;
+    counting = true;
+    for (int i = 0; i < 10000; ++i) world.update(1.0f / 60.0f);
+    counting = false;
+    return allocations;
+}
+
+static void testSteadyStepping() {
+    const size_t grid = countSteadyAllocations(std::make_unique<UniformGridBroadphase>(16.0f), nullptr);
+    const size_t tree = countSteadyAllocations(std::make_unique<DynamicTreeBroadphase>(), nullptr);
+    RK::JobSystem jobs(2);
+    const size_t threaded = countSteadyAllocations(std::make_unique<UniformGridBroadphase>(16.0f), &jobs);
+    assert(grid == 0);
+    assert(tree == 0);
+    assert(threaded == 0);
+}
+
+static void testBodyObjectsArePooled() {
+    PhysicsWorld world;
+    // The first body carves the pool, later ones reuse the same block
+    world.addBody(std::make_unique<Circle>(Vector2D(0, 0), 1, 1.0f));
+    allocations = 0;
+    counting = true;
+    for (int i = 0; i < 100; ++i) {
+        auto circle = std::make_unique<Circle>(Vector2D(float(i), 0), 1, 1.0f);
+        circle.reset();
+    }
+    counting = false;
+    assert(allocations == 0);
+}
+
+int main() {
+    testSteadyStepping();
+    testBodyObjectsArePooled();
+    return 0;
+}
@@ -0,0 +1,61 @@
+//
+// SoA body storage and the addBody compatibility layer.
+//
+
+#include <Physics/Circle.h>
+#include <Physics/Rectangle.h>
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+
+static void testAddBodyCopiesState() {
+    PhysicsWorld world(Vector2D(0, 0));
+    auto circle = std::make_unique<Circle>(Vector2D(1, 2), 3, 2.0f, 0.5f);
+    circle->velocity = Vector2D(4, 5);
+    auto box = std::make_unique<Rectangle>(Vector2D(10, 20), 30, 40, 1.0f);
+    box->isStatic = true;
+
+    BodyHandle c = world.addBody(std::move(circle));
+    BodyHandle b = world.addBody(std::move(box));
+    assert(c != b && world.getBodyCount() == 2);
+
+    const BodyStorage& storage = world.getStorage();
+    const uint32_t ci = storage.indexOf(c), bi = storage.indexOf(b);
+    assert(storage.shape[ci] == ShapeType::Circle && storage.extentX[ci] == 3);
+    assert(storage.invMass[ci] == 0.5f && storage.restitution[ci] == 0.5f);
+    assert(storage.shape[bi] == ShapeType::Rectangle);
+    assert(storage.extentX[bi] == 30 && storage.extentY[bi] == 40);
+    assert(storage.isStatic(bi) && storage.invMass[bi] == 0);
+    assert(storage.handleAt(ci) == c);
+
+    assert(world.getPosition(c).x == 1 && world.getVelocity(c).y == 5);
+    assert(world.getPosition(b).y == 20);
+}
+
+static void testIntegrateAndForces() {
+    PhysicsWorld world(Vector2D(0, 10));
+    BodyDef def;
+    def.mass = 2.0f;
+    BodyHandle body = world.createBody(def);
+    def.isStatic = true;
+    def.position = Vector2D(100, 100);
+    BodyHandle wall = world.createBody(def);
+
+    world.applyForce(body, Vector2D(4, 0));
+    world.applyForce(wall, Vector2D(4, 0));
+    world.update(0.5f);
+
+    // v = (g + F/m) * dt, x = v * dt
+    assert(world.getVelocity(body).x == 1.0f && world.getVelocity(body).y == 5.0f);
+    assert(world.getPosition(body).x == 0.5f && world.getPosition(body).y == 2.5f);
+    assert(world.getPosition(wall).x == 100 && world.getVelocity(wall).x == 0);
+
+    // Forces only last one step
+    world.update(0.5f);
+    assert(world.getVelocity(body).x == 1.0f);
+}
+
+int main() {
+    testAddBodyCopiesState();
+    testIntegrateAndForces();
+    return 0;
+}
@@ -0,0 +1,183 @@
+//
+// Broadphase tests: every broadphase must report exactly the brute force pairs.
+//
+
+#include <Physics/Broadphase.h>
+#include <Physics/Circle.h>
+#include <Physics/Rectangle.h>
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <limits>
+#include <random>
+
+static std::vector<AABB> randomBounds(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(1.0f, 40.0f);
+    std::vector<AABB> bounds;
+    for (size_t i = 0; i < count; ++i) {
+        Vector2D lo(pos(rng), pos(rng));
+        bounds.emplace_back(lo, Vector2D(lo.x + size(rng), lo.y + size(rng)));
+    }
+    // A few large bodies spanning many cells
+    bounds.emplace_back(Vector2D(-400, 300), Vector2D(400, 350));
+    bounds.emplace_back(Vector2D(-20, -600), Vector2D(10, 600));
+    return bounds;
+}
+
+// Every fifth body and the large ones are static
+static std::vector<uint8_t> someStatic(size_t count) {
+    std::vector<uint8_t> statics(count, 0);
+    for (size_t i = 0; i < count; i += 5) statics[i] = 1;
+    statics[count - 1] = statics[count - 2] = 1;
+    return statics;
+}
+
+static void testMatchesBruteForce(Broadphase& broadphase) {
+    BruteForceBroadphase reference;
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        std::vector<AABB> bounds = randomBounds(1500, seed);
+        std::vector<uint8_t> statics = someStatic(bounds.size());
+        std::vector<BodyPair> expected, actual;
+        reference.findPairs(bounds, statics, expected);
+        broadphase.findPairs(bounds, statics, actual);
+        assert(!expected.empty());
+        assert(expected == actual);
+
+        // No static-static pairs
+        for (const BodyPair& p : actual) assert(!(statics[p.a] && statics[p.b]));
+    }
+}
+
+// Persistent state must stay correct while bodies move and are added
+static void testIncremental(Broadphase& broadphase) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> jitter(-5.0f, 5.0f);
+    std::uniform_real_distribution<float> small(-0.5f, 0.5f);
+    std::vector<AABB> bounds = randomBounds(800, 11);
+    std::vector<uint8_t> statics = someStatic(bounds.size());
+    BruteForceBroadphase reference;
+    std::vector<BodyPair> expected, actual;
+    for (int step = 0; step < 20; ++step) {
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            if (statics[i]) continue;
+            // Mix of slow movers (stay inside a fat box) and fast ones
+            Vector2D d = i % 3 ? Vector2D(small(rng), small(rng)) : Vector2D(jitter(rng), jitter(rng));
+            bounds[i] = AABB(bounds[i].min + d, bounds[i].max + d);
+        }
+        if (step % 5 == 0) {
+            bounds.emplace_back(Vector2D(0, 0), Vector2D(30, 30));
+            statics.push_back(0);
+        }
+        reference.findPairs(bounds, statics, expected);
+        broadphase.findPairs(bounds, statics, actual);
+        assert(expected == actual);
+    }
+}
+
+static void testTreeQuery() {
+    std::vector<AABB> bounds = randomBounds(1000, 21);
+    AABBTree tree;
+    std::vector<int32_t> proxies;
+    for (uint32_t i = 0; i < bounds.size(); ++i) proxies.push_back(tree.insert(bounds[i], i));
+    // Remove every other leaf again
+    for (uint32_t i = 0; i < bounds.size(); i += 2) tree.remove(proxies[i]);
+
+    assert(tree.getHeight() < 40);
+
+    AABB box(Vector2D(-100, -100), Vector2D(150, 120));
+    size_t expected = 0, found = 0;
+    for (uint32_t i = 1; i < bounds.size(); i += 2) {
+        if (bounds[i].overlaps(box)) ++expected;
+    }
+    tree.query(box, [&](uint32_t id) {
+        assert(id % 2 == 1 && bounds[id].overlaps(box));
+        ++found;
+        return true;
+    });
+    assert(found == expected);
+}
+
+// One huge body, one with infinite and one with NaN bounds: the grid must not
+// walk their cells, and still report and find them like brute force
+static void testGridOversize() {
+    std::vector<AABB> bounds = randomBounds(300, 5);
+    bounds.emplace_back(Vector2D(-1.0e8f, -1.0e8f), Vector2D(1.0e8f, 1.0e8f));
+    const float inf = std::numeric_limits<float>::infinity();
+    bounds.emplace_back(Vector2D(-inf, 0), Vector2D(inf, 10));
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    bounds.emplace_back(Vector2D(nan, nan), Vector2D(nan, nan));
+    std::vector<uint8_t> statics = someStatic(bounds.size());
+    statics[bounds.size() - 3] = 0;
+
+    UniformGridBroadphase grid(25.0f);
+    BruteForceBroadphase reference;
+    std::vector<BodyPair> expected, actual;
+    reference.findPairs(bounds, statics, expected);
+    grid.findPairs(bounds, statics, actual);
+    assert(expected == actual);
+
+    const uint32_t huge = static_cast<uint32_t>(bounds.size() - 3);
+    bool found = false;
+    grid.query(AABB(Vector2D(0, 0), Vector2D(1, 1)), [&](uint32_t i) {
+        found |= i == huge;
+        return true;
+    });
+    assert(found);
+    found = false;
+    grid.queryRay(Vector2D(0, 0), Vector2D(5, 5), [&](uint32_t i) {
+        found |= i == huge;
+        return 1.0f;
+    });
+    assert(found);
+}
+
+static void testWorldWithGrid() {
+    auto build = [](PhysicsWorld& world) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> pos(0.0f, 300.0f);
+        for (int i = 0; i < 200; ++i) {
+            world.addBody(std::make_unique<Circle>(Vector2D(pos(rng), pos(rng)), 6.0f, 1.0f));
+        }
+    };
+    PhysicsWorld brute, grid;
+    grid.setBroadphase(std::make_unique<UniformGridBroadphase>(16.0f));
+    build(brute);
+    build(grid);
+    for (int step = 0; step < 30; ++step) {
+        brute.update(1.0f / 60.0f);
+        grid.update(1.0f / 60.0f);
+    }
+    assert(brute.getBodyCount() == grid.getBodyCount());
+    const BodyStorage& a = brute.getStorage();
+    const BodyStorage& b = grid.getStorage();
+    assert(a.posX == b.posX && a.posY == b.posY);
+}
+
+int main() {
+    UniformGridBroadphase grid(25.0f);
+    testMatchesBruteForce(grid);
+
+    UniformGridBroadphase coarseGrid(400.0f);
+    testMatchesBruteForce(coarseGrid);
+
+    SweepAndPruneBroadphase sap;
+    testMatchesBruteForce(sap);
+
+    SweepAndPruneBroadphase sapY(SweepAndPruneBroadphase::Axis::Y);
+    testMatchesBruteForce(sapY);
+
+    SweepAndPruneBroadphase incrementalSap;
+    testIncremental(incrementalSap);
+
+    DynamicTreeBroadphase tree;
+    testMatchesBruteForce(tree);
+
+    DynamicTreeBroadphase incrementalTree(2.0f);
+    testIncremental(incrementalTree);
+
+    testTreeQuery();
+    testGridOversize();
+    testWorldWithGrid();
+    return 0;
+}
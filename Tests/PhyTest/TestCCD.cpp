@@ -0,0 +1,113 @@
+//
+// Continuous collision: swept-circle time of impact and bullet bodies.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <cmath>
+
+static bool near(float a, float b) {
+    return std::abs(a - b) < 1e-4f;
+}
+
+static Collider circle(Vector2D centre, float radius) {
+    return Collider{ShapeType::Circle, centre, Vector2D(radius, 0)};
+}
+
+static Collider box(Vector2D corner, float width, float height) {
+    return Collider{ShapeType::Rectangle, corner, Vector2D(width, height)};
+}
+
+static void testSweepCircleCircle() {
+    float toi = -1;
+    // Radii sum 3, centres 10 apart: touching after 7 of the 14 units
+    assert(timeOfImpact(circle(Vector2D(0, 0), 1), Vector2D(14, 0), circle(Vector2D(10, 0), 2), toi));
+    assert(near(toi, 0.5f));
+    // Too short, moving away, passing by
+    assert(!timeOfImpact(circle(Vector2D(0, 0), 1), Vector2D(6, 0), circle(Vector2D(10, 0), 2), toi));
+    assert(!timeOfImpact(circle(Vector2D(0, 0), 1), Vector2D(-14, 0), circle(Vector2D(10, 0), 2), toi));
+    assert(!timeOfImpact(circle(Vector2D(0, 5), 1), Vector2D(20, 0), circle(Vector2D(10, 0), 2), toi));
+    // Already overlapping is left to the narrowphase
+    assert(!timeOfImpact(circle(Vector2D(8, 0), 1), Vector2D(4, 0), circle(Vector2D(10, 0), 2), toi));
+}
+
+static void testSweepCircleRectangle() {
+    const Collider wall = box(Vector2D(100, -50), 2, 100);
+    float toi = -1;
+    // Face: the circle touches x = 100 when its centre reaches 98
+    assert(timeOfImpact(circle(Vector2D(0, 0), 2), Vector2D(196, 0), wall, toi));
+    assert(near(toi, 0.5f));
+    // Straight through a thin wall in one step
+    assert(timeOfImpact(circle(Vector2D(90, 0), 2), Vector2D(50, 0), wall, toi));
+    assert(near(toi, 8.0f / 50.0f));
+    // Corner: passing just above the top edge, clipping the rounded corner
+    assert(timeOfImpact(circle(Vector2D(0, -51), 2), Vector2D(200, 0), wall, toi));
+    const float x = 100 - std::sqrt(4.0f - 1.0f);
+    assert(near(toi, x / 200.0f));
+    // Missing the corner entirely
+    assert(!timeOfImpact(circle(Vector2D(0, -53), 2), Vector2D(200, 0), wall, toi));
+    // Moving parallel to the wall
+    assert(!timeOfImpact(circle(Vector2D(95, -100), 2), Vector2D(0, 200), wall, toi));
+}
+
+// A small fast circle shot at a thin static wall
+static float shootAtWall(bool bullet) {
+    PhysicsWorld world(Vector2D(0, 0));
+    BodyDef wall;
+    wall.shape = ShapeType::Rectangle;
+    wall.position = Vector2D(100, -50);
+    wall.width = 2;
+    wall.height = 100;
+    wall.isStatic = true;
+    world.createBody(wall);
+
+    BodyDef ball;
+    ball.position = Vector2D(0, 0);
+    ball.velocity = Vector2D(3600, 0); // 60 units per step
+    ball.radius = 2;
+    ball.restitution = 0.5f;
+    ball.bullet = bullet;
+    const BodyHandle handle = world.createBody(ball);
+    assert(world.isBullet(handle) == bullet);
+
+    for (int i = 0; i < 10; ++i) world.update(1.0f / 60.0f);
+    return world.getPosition(handle).x;
+}
+
+static void testBulletDoesNotTunnel() {
+    // Without CCD the ball jumps from x = 60 to x = 120, straight past the wall
+    assert(shootAtWall(false) > 102);
+    // With it the ball stops at the wall and bounces back
+    assert(shootAtWall(true) < 100);
+}
+
+static void testBulletHitsSmallCircle() {
+    PhysicsWorld world(Vector2D(0, 0));
+    BodyDef target;
+    target.position = Vector2D(250, 0); // between two steps of the ball
+    target.radius = 1;
+    const BodyHandle targetHandle = world.createBody(target);
+
+    BodyDef ball;
+    ball.velocity = Vector2D(6000, 0);
+    ball.radius = 1;
+    ball.restitution = 0.0f;
+    const BodyHandle ballHandle = world.createBody(ball);
+    world.setBullet(ballHandle, true);
+
+    for (int i = 0; i < 5; ++i) world.update(1.0f / 60.0f);
+    // Equal masses, no restitution: the target takes over half the velocity
+    assert(world.getVelocity(targetHandle).x > 1000);
+    assert(world.getPosition(ballHandle).x < world.getPosition(targetHandle).x);
+
+    world.setBullet(ballHandle, false);
+    assert(!world.isBullet(ballHandle));
+}
+
+int main() {
+    testSweepCircleCircle();
+    testSweepCircleRectangle();
+    testBulletDoesNotTunnel();
+    testBulletHitsSmallCircle();
+    return 0;
+}
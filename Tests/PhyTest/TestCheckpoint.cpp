@@ -0,0 +1,240 @@
+//
+// Binary checkpoints: a restored world continues exactly like the original.
+//
+
+#include <Physics/Checkpoint.h>
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static std::string tempPath(const char* name) {
+    return std::string("/tmp/") + name + "_" + std::to_string(::getpid()) + ".ckpt";
+}
+
+// Boxes and balls piling up in a bin, with a bullet, so contacts, warm
+// starting and sleeping all carry state across the checkpoint
+static void populate(PhysicsWorld& world) {
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 100);
+    ground.width = 100;
+    ground.height = 10;
+    ground.isStatic = true;
+    world.createBody(ground);
+    for (int i = 0; i < 40; ++i) {
+        BodyDef def;
+        def.position = Vector2D(10.0f + float(i % 8) * 10.0f, 90.0f - float(i / 8) * 10.0f);
+        def.radius = 4;
+        def.restitution = 0.2f;
+        if (i % 3 == 0) {
+            def.shape = ShapeType::Rectangle;
+            def.width = def.height = 7;
+        }
+        // Some bodies pass through each other
+        if (i % 4 == 0) def.filter.group = -1;
+        world.createBody(def);
+    }
+    BodyDef bullet;
+    bullet.position = Vector2D(50, -50);
+    bullet.velocity = Vector2D(0, 3000);
+    bullet.radius = 1;
+    bullet.bullet = true;
+    world.createBody(bullet);
+}
+
+static void assertSameState(const PhysicsWorld& a, const PhysicsWorld& b) {
+    const BodyStorage& sa = a.getStorage();
+    const BodyStorage& sb = b.getStorage();
+    assert(sa.size() == sb.size());
+    assert(std::memcmp(sa.posX.data(), sb.posX.data(), sa.size() * sizeof(float)) == 0);
+    assert(std::memcmp(sa.posY.data(), sb.posY.data(), sa.size() * sizeof(float)) == 0);
+    assert(std::memcmp(sa.velX.data(), sb.velX.data(), sa.size() * sizeof(float)) == 0);
+    assert(std::memcmp(sa.velY.data(), sb.velY.data(), sa.size() * sizeof(float)) == 0);
+    assert(sa.flags == sb.flags);
+    assert(sa.filter == sb.filter);
+}
+
+static void testRestoreContinuesIdentically() {
+    const std::string path = tempPath("restore");
+    PhysicsWorld original(Vector2D(0, 98));
+    populate(original);
+    for (int i = 0; i < 45; ++i) original.advance(1.0f / 50.0f);
+    assert(!original.getSolver().getCache().empty());
+    assert(original.saveCheckpoint(path.c_str()));
+
+    PhysicsWorld restored;
+    assert(restored.loadCheckpoint(path.c_str()));
+    assertSameState(original, restored);
+    assert(restored.getInterpolationAlpha() == original.getInterpolationAlpha());
+    const BodyHandle someBody{17};
+    assert(restored.getPosition(someBody).x == original.getPosition(someBody).x);
+    assert(restored.isBullet(BodyHandle{41}));
+
+    for (int i = 0; i < 120; ++i) {
+        original.advance(1.0f / 50.0f);
+        restored.advance(1.0f / 50.0f);
+    }
+    assertSameState(original, restored);
+    std::remove(path.c_str());
+}
+
+// A stack of boxes on the ground that has fallen asleep
+static std::vector<BodyHandle> sleepingStack(PhysicsWorld& world) {
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 400);
+    ground.width = 800;
+    ground.height = 50;
+    ground.isStatic = true;
+    world.createBody(ground);
+    std::vector<BodyHandle> stack;
+    for (int i = 0; i < 3; ++i) {
+        BodyDef box;
+        box.shape = ShapeType::Rectangle;
+        box.position = Vector2D(100, 400 - 20.0f * (i + 1));
+        box.width = box.height = 20;
+        box.restitution = 0.0f;
+        stack.push_back(world.createBody(box));
+    }
+    for (int i = 0; i < 120; ++i) world.update(1.0f / 60.0f);
+    for (BodyHandle b : stack) assert(!world.isAwake(b));
+    return stack;
+}
+
+static void testRestoredSleepersWake() {
+    const std::string path = tempPath("sleepers");
+    PhysicsWorld original(Vector2D(0, 98));
+    const std::vector<BodyHandle> stack = sleepingStack(original);
+    assert(original.saveCheckpoint(path.c_str()));
+
+    PhysicsWorld restored(Vector2D(0, 98));
+    assert(restored.loadCheckpoint(path.c_str()));
+    assert(restored.getIslands().getSleepingCount() == 3);
+    assert(restored.getIslands().getAwakeCount() == 0);
+
+    // Drop a ball on the stack: the restored island wakes as a whole
+    BodyDef ball;
+    ball.position = Vector2D(110, 300);
+    ball.radius = 5;
+    ball.restitution = 0.0f;
+    restored.createBody(ball);
+    bool woke = false;
+    for (int i = 0; i < 60 && !woke; ++i) {
+        restored.update(1.0f / 60.0f);
+        woke = restored.isAwake(stack[0]);
+    }
+    assert(woke);
+    for (BodyHandle b : stack) assert(restored.isAwake(b));
+    assert(restored.getIslands().getSleepingCount() == 0);
+    std::remove(path.c_str());
+}
+
+static void testBadFilesAreRejected() {
+    const std::string path = tempPath("bad");
+    PhysicsWorld world;
+    populate(world);
+    assert(world.saveCheckpoint(path.c_str()));
+
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    std::vector<char> bytes(1 << 16);
+    bytes.resize(std::fread(bytes.data(), 1, bytes.size(), f));
+    std::fclose(f);
+
+    auto writeBytes = [&](const std::vector<char>& data) {
+        std::FILE* out = std::fopen(path.c_str(), "wb");
+        std::fwrite(data.data(), 1, data.size(), out);
+        std::fclose(out);
+    };
+
+    PhysicsWorld target;
+    const BodyHandle kept = target.createBody(BodyDef());
+
+    std::vector<char> truncated(bytes.begin(), bytes.end() - 64);
+    writeBytes(truncated);
+    assert(!target.loadCheckpoint(path.c_str()));
+
+    std::vector<char> newer = bytes;
+    CheckpointHeader header;
+    std::memcpy(&header, newer.data(), sizeof(header));
+    header.version = CheckpointVersion + 1;
+    std::memcpy(newer.data(), &header, sizeof(header));
+    writeBytes(newer);
+    assert(!target.loadCheckpoint(path.c_str()));
+
+    // A section offset near the end of the address range, whose end wraps
+    std::vector<char> wrapped = bytes;
+    std::memcpy(&header, wrapped.data(), sizeof(header));
+    header.sections[static_cast<uint32_t>(CheckpointSection::PosX)] = ~uint64_t(0) - CheckpointAlignment + 1;
+    std::memcpy(wrapped.data(), &header, sizeof(header));
+    writeBytes(wrapped);
+    assert(!target.loadCheckpoint(path.c_str()));
+
+    // Two bodies with one id, and a sleeping ring linking to an id no body
+    // has, are rejected before they reach the id table or the islands
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    auto idsAt = [&](std::vector<char>& data, CheckpointSection section) {
+        return reinterpret_cast<uint32_t*>(data.data() + header.sections[static_cast<uint32_t>(section)]);
+    };
+    std::vector<char> duplicate = bytes;
+    idsAt(duplicate, CheckpointSection::Ids)[1] = idsAt(duplicate, CheckpointSection::Ids)[0];
+    writeBytes(duplicate);
+    assert(!target.loadCheckpoint(path.c_str()));
+
+    std::vector<char> dangling = bytes;
+    CheckpointHeader moreIds = header;
+    moreIds.idCount = header.bodyCount + 1;
+    std::memcpy(dangling.data(), &moreIds, sizeof(moreIds));
+    idsAt(dangling, CheckpointSection::SleepNext)[0] = header.bodyCount;
+    writeBytes(dangling);
+    assert(!target.loadCheckpoint(path.c_str()));
+
+    // Sleeping rings that do not close, or that pass through an awake body,
+    // and awake bodies linking elsewhere
+    {
+        PhysicsWorld sleeper(Vector2D(0, 98));
+        sleepingStack(sleeper);
+        assert(sleeper.saveCheckpoint(path.c_str()));
+        std::FILE* in = std::fopen(path.c_str(), "rb");
+        std::vector<char> asleep(1 << 16);
+        asleep.resize(std::fread(asleep.data(), 1, asleep.size(), in));
+        std::fclose(in);
+        std::memcpy(&header, asleep.data(), sizeof(header));
+
+        // Bodies 1..3 form the ring; 1 -> 2 -> 2 never returns to 1
+        std::vector<char> open = asleep;
+        const uint32_t* next = idsAt(open, CheckpointSection::SleepNext);
+        const uint32_t into = next[1] == 2 ? 2 : 3;
+        idsAt(open, CheckpointSection::SleepNext)[into] = into;
+        writeBytes(open);
+        assert(!target.loadCheckpoint(path.c_str()));
+
+        std::vector<char> throughAwake = asleep;
+        idsAt(throughAwake, CheckpointSection::SleepNext)[1] = 0;
+        writeBytes(throughAwake);
+        assert(!target.loadCheckpoint(path.c_str()));
+
+        std::vector<char> awakeLink = asleep;
+        idsAt(awakeLink, CheckpointSection::SleepNext)[0] = 1;
+        writeBytes(awakeLink);
+        assert(!target.loadCheckpoint(path.c_str()));
+
+        writeBytes(asleep);
+        PhysicsWorld intact;
+        assert(intact.loadCheckpoint(path.c_str()));
+    }
+
+    assert(!target.loadCheckpoint("/nonexistent/world.ckpt"));
+    // Failed loads leave the world as it was
+    assert(target.getBodyCount() == 1 && target.getPosition(kept).x == 0);
+    std::remove(path.c_str());
+}
+
+int main() {
+    testRestoreContinuesIdentically();
+    testRestoredSleepersWake();
+    testBadFilesAreRejected();
+    return 0;
+}
@@ -0,0 +1,77 @@
+//
+// Narrowphase dispatch tests for every shape pair.
+//
+
+#include <Physics/Circle.h>
+#include <Physics/Rectangle.h>
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <cmath>
+
+static bool near(float a, float b) {
+    return std::abs(a - b) < 1e-4f;
+}
+
+static void testCircleCircle() {
+    Circle a(Vector2D(0, 0), 2, 1), b(Vector2D(3, 0), 2, 1), far(Vector2D(10, 0), 2, 1);
+    Contact contact;
+    assert(collide(a, b, contact));
+    assert(near(contact.normal.x, -1) && near(contact.normal.y, 0));
+    assert(near(contact.depth, 1));
+    assert(!collide(a, far, contact));
+}
+
+static void testCircleRectangle() {
+    // Circle resting 1 unit into the top face of the box
+    Circle circle(Vector2D(5, -1), 2, 1);
+    Rectangle box(Vector2D(0, 0), 10, 4, 1);
+    Contact contact;
+    assert(collide(circle, box, contact));
+    assert(near(contact.normal.x, 0) && near(contact.normal.y, -1));
+    assert(near(contact.depth, 1));
+
+    // Same pair the other way round flips the normal
+    assert(collide(box, circle, contact));
+    assert(near(contact.normal.y, 1));
+    assert(circle.checkCollision(box) && box.checkCollision(circle));
+
+    // Centre inside the box, nearest edge is the right one
+    Circle inside(Vector2D(9, 2), 1, 1);
+    assert(collide(inside, box, contact));
+    assert(near(contact.normal.x, 1) && near(contact.depth, 2));
+
+    // Near a corner but outside the radius
+    Circle corner(Vector2D(-1.5f, -1.5f), 2, 1);
+    assert(!collide(corner, box, contact));
+}
+
+static void testRectangleRectangle() {
+    Rectangle a(Vector2D(0, 0), 4, 4, 1), b(Vector2D(3, 1), 4, 4, 1), c(Vector2D(4, 0), 4, 4, 1);
+    Contact contact;
+    assert(collide(a, b, contact));
+    assert(near(contact.normal.x, -1) && near(contact.depth, 1));
+    // Touching edges do not collide
+    assert(!collide(a, c, contact));
+}
+
+// Circles used to fall straight through the static ground
+static void testCircleLandsOnGround() {
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    BodyHandle circle = world.addBody(std::make_unique<Circle>(Vector2D(100, 50), 20, 1.0f, 0.5f));
+    auto ground = std::make_unique<Rectangle>(Vector2D(0, 400), 800, 50, 1.0f, 0.6f);
+    ground->isStatic = true;
+    BodyHandle groundHandle = world.addBody(std::move(ground));
+
+    for (int i = 0; i < 600; ++i) world.update(1.0f / 60.0f);
+
+    assert(world.getPosition(circle).y < 400 && world.getPosition(circle).y > 370);
+    assert(world.getPosition(groundHandle).y == 400);
+}
+
+int main() {
+    testCircleCircle();
+    testCircleRectangle();
+    testRectangleRectangle();
+    testCircleLandsOnGround();
+    return 0;
+}
@@ -0,0 +1,104 @@
+//
+// Contact events: one begin when bodies meet, one end when they part, none
+// while they rest or sleep in between.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+struct Recorder : ContactListener {
+    std::vector<ContactEvent> begins, ends;
+    int calls = 0;
+
+    void onContacts(std::span<const ContactEvent> begin, std::span<const ContactEvent> end) override {
+        ++calls;
+        begins.insert(begins.end(), begin.begin(), begin.end());
+        ends.insert(ends.end(), end.begin(), end.end());
+        for (const ContactEvent& e : begin) assert(e.a.id < e.b.id);
+        for (size_t i = 1; i < begin.size(); ++i) assert(begin[i - 1].a.id <= begin[i].a.id);
+    }
+
+    size_t count(const std::vector<ContactEvent>& events, BodyHandle a, BodyHandle b) const {
+        return std::count_if(events.begin(), events.end(), [&](const ContactEvent& e) {
+            return (e.a == a && e.b == b) || (e.a == b && e.b == a);
+        });
+    }
+};
+
+static BodyHandle addGround(PhysicsWorld& world) {
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 100);
+    ground.width = 200;
+    ground.height = 20;
+    ground.isStatic = true;
+    return world.createBody(ground);
+}
+
+static void testLandRestSleepAndLeave() {
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    world.setBroadphase(std::make_unique<UniformGridBroadphase>(16.0f));
+    Recorder recorder;
+    world.setContactListener(&recorder);
+    const BodyHandle ground = addGround(world);
+    BodyDef ball;
+    ball.position = Vector2D(100, 50);
+    ball.radius = 5;
+    ball.restitution = 0.0f;
+    const BodyHandle body = world.createBody(ball);
+
+    // Falls, lands, comes to rest and falls asleep on the ground
+    for (int step = 0; step < 300; ++step) world.update(1.0f / 60.0f);
+    assert(recorder.calls == 300);
+    assert(!world.isAwake(body));
+    assert(recorder.count(recorder.begins, ground, body) == 1);
+    assert(recorder.ends.empty());
+
+    // Lifted away: the contact ends once
+    world.setPosition(body, Vector2D(100, 0));
+    for (int step = 0; step < 5; ++step) world.update(1.0f / 60.0f);
+    assert(recorder.count(recorder.ends, ground, body) == 1);
+
+    // And begins again when it lands
+    for (int step = 0; step < 120; ++step) world.update(1.0f / 60.0f);
+    assert(recorder.count(recorder.begins, ground, body) == 2);
+    assert(recorder.count(recorder.ends, ground, body) == 1);
+}
+
+static void testFilteredPairsHaveNoEvents() {
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    Recorder recorder;
+    world.setContactListener(&recorder);
+    const BodyHandle ground = addGround(world);
+    BodyDef ball;
+    ball.position = Vector2D(50, 80);
+    ball.radius = 5;
+    ball.restitution = 0.0f;
+    ball.filter.group = -2;
+    const BodyHandle a = world.createBody(ball);
+    ball.position = Vector2D(52, 80);
+    const BodyHandle b = world.createBody(ball);
+    for (int step = 0; step < 60; ++step) world.update(1.0f / 60.0f);
+    assert(recorder.count(recorder.begins, a, b) == 0);
+    assert(recorder.count(recorder.begins, ground, a) == 1);
+    assert(recorder.count(recorder.begins, ground, b) == 1);
+
+    // Without a listener nothing is tracked; a new one sees the contacts of
+    // awake bodies as begun
+    world.setContactListener(nullptr);
+    for (int step = 0; step < 10; ++step) world.update(1.0f / 60.0f);
+    Recorder late;
+    world.setContactListener(&late);
+    world.wake(a);
+    world.update(1.0f / 60.0f);
+    assert(late.count(late.begins, ground, a) == 1);
+    assert(late.ends.empty());
+}
+
+int main() {
+    testLandRestSleepAndLeave();
+    testFilteredPairsHaveNoEvents();
+    return 0;
+}
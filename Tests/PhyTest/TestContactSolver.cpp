@@ -0,0 +1,119 @@
+//
+// Sequential impulse solver: stacks settle and warm starting helps them.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+struct Stack {
+    PhysicsWorld world{Vector2D(0, 98.0f)};
+    std::vector<BodyHandle> boxes;
+};
+
+// Boxes of 20x20 stacked on a static ground whose top is at y = 400
+static void buildStack(Stack& stack, int height) {
+    // Sleeping would drop the contacts of a settled stack
+    stack.world.getIslands().settings.enabled = false;
+
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 400);
+    ground.width = 800;
+    ground.height = 50;
+    ground.isStatic = true;
+    stack.world.createBody(ground);
+
+    for (int i = 0; i < height; ++i) {
+        BodyDef box;
+        box.shape = ShapeType::Rectangle;
+        box.position = Vector2D(100, 400 - 20.0f * (i + 1) - 1.0f * i);
+        box.width = box.height = 20;
+        box.restitution = 0.2f;
+        stack.boxes.push_back(stack.world.createBody(box));
+    }
+}
+
+// Total penetration of the stack below its ideal resting height
+static float sink(const Stack& stack) {
+    float total = 0;
+    for (size_t i = 0; i < stack.boxes.size(); ++i) {
+        const float ideal = 400 - 20.0f * (i + 1);
+        total += std::max(0.0f, stack.world.getPosition(stack.boxes[i]).y - ideal);
+    }
+    return total;
+}
+
+static float maxSpeed(const Stack& stack) {
+    float speed = 0;
+    for (BodyHandle box : stack.boxes) speed = std::max(speed, stack.world.getVelocity(box).magnitude());
+    return speed;
+}
+
+static void testStackSettles() {
+    Stack stack;
+    buildStack(stack, 8);
+    for (int i = 0; i < 600; ++i) stack.world.update(1.0f / 60.0f);
+
+    assert(maxSpeed(stack) < 2.0f);
+    // Each box sits within the slop of the one below
+    for (size_t i = 0; i < stack.boxes.size(); ++i) {
+        const float ideal = 400 - 20.0f * (i + 1);
+        const Vector2D p = stack.world.getPosition(stack.boxes[i]);
+        assert(std::abs(p.y - ideal) < 0.5f * (i + 1));
+        assert(p.x == 100);
+    }
+    assert(stack.world.getContacts().size() == stack.boxes.size());
+}
+
+static void testWarmStartingSettlesFaster() {
+    Stack warm, cold;
+    buildStack(warm, 10);
+    buildStack(cold, 10);
+    warm.world.getSolver().settings.velocityIterations = 2;
+    cold.world.getSolver().settings.velocityIterations = 2;
+    cold.world.getSolver().settings.warmStarting = false;
+
+    for (int i = 0; i < 300; ++i) {
+        warm.world.update(1.0f / 60.0f);
+        cold.world.update(1.0f / 60.0f);
+    }
+    assert(sink(warm) < sink(cold));
+    assert(maxSpeed(warm) <= maxSpeed(cold));
+}
+
+// A fresh impact still bounces; only resting contacts lose restitution.
+// Drops from many heights, so some impacts are first caught across a gap by
+// a speculative contact and others only once the ball is touching.
+static void testImpactBounces() {
+    for (int drop = 0; drop < 40; ++drop) {
+        Stack stack;
+        buildStack(stack, 0);
+        BodyDef ball;
+        ball.position = Vector2D(100, 300 + 0.37f * drop);
+        ball.radius = 10;
+        ball.restitution = 0.5f;
+        const BodyHandle handle = stack.world.createBody(ball);
+
+        float impactSpeed = 0;
+        bool bounced = false;
+        for (int i = 0; i < 120 && !bounced; ++i) {
+            impactSpeed = std::max(impactSpeed, stack.world.getVelocity(handle).y + 98.0f / 60.0f);
+            stack.world.update(1.0f / 60.0f);
+            const float after = stack.world.getVelocity(handle).y;
+            if (after < 0) {
+                bounced = true;
+                assert(std::abs(after + 0.5f * impactSpeed) < 0.1f * impactSpeed);
+            }
+        }
+        assert(bounced && impactSpeed > 0);
+    }
+}
+
+int main() {
+    testStackSettles();
+    testImpactBounces();
+    testWarmStartingSettlesFaster();
+    return 0;
+}
@@ -0,0 +1,136 @@
+//
+// Collision filtering: category and mask bits and groups decide which pairs
+// reach the narrowphase.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <cmath>
+#include <memory>
+
+static void testRules() {
+    const CollisionFilter all;
+    CollisionFilter red, blue;
+    red.category = 1 << 1;
+    red.mask = 0xFFFF & ~(1 << 2);
+    blue.category = 1 << 2;
+    blue.mask = 0xFFFF & ~(1 << 1);
+    assert(shouldCollide(all, all));
+    assert(shouldCollide(red, all) && shouldCollide(all, blue));
+    assert(shouldCollide(red, red));
+    assert(!shouldCollide(red, blue) && !shouldCollide(blue, red));
+
+    // A shared group overrides the masks either way
+    red.group = blue.group = 3;
+    assert(shouldCollide(red, blue));
+    red.group = blue.group = -3;
+    assert(!shouldCollide(red, blue));
+    CollisionFilter other = all;
+    other.group = -3;
+    assert(!shouldCollide(other, red));
+    other.group = -4;
+    assert(shouldCollide(other, all));
+}
+
+// Two overlapping columns of circles, one per team, on a shared ground
+struct Teams {
+    PhysicsWorld world{Vector2D(0, 98.0f)};
+    BodyHandle ground;
+    std::vector<BodyHandle> red, blue;
+};
+
+static void buildTeams(Teams& t, std::unique_ptr<Broadphase> broadphase) {
+    t.world.setBroadphase(std::move(broadphase));
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 200);
+    ground.width = 200;
+    ground.height = 20;
+    ground.isStatic = true;
+    t.ground = t.world.createBody(ground);
+
+    for (int i = 0; i < 6; ++i) {
+        BodyDef def;
+        def.radius = 5;
+        def.restitution = 0.0f;
+        def.position = Vector2D(100, 190.0f - 10.0f * i);
+        def.filter.category = 1 << 1;
+        def.filter.mask = 0xFFFF & ~(1 << 2);
+        t.red.push_back(t.world.createBody(def));
+        def.position = Vector2D(102, 190.0f - 10.0f * i);
+        def.filter.category = 1 << 2;
+        def.filter.mask = 0xFFFF & ~(1 << 1);
+        t.blue.push_back(t.world.createBody(def));
+    }
+}
+
+static bool sameTeam(const Teams& t, BodyHandle a, BodyHandle b) {
+    auto isRed = [&](BodyHandle h) { return t.world.getFilter(h).category == (1 << 1); };
+    return isRed(a) == isRed(b);
+}
+
+static void testTeamsPassThrough(std::unique_ptr<Broadphase> broadphase) {
+    Teams t;
+    buildTeams(t, std::move(broadphase));
+    for (int step = 0; step < 120; ++step) {
+        t.world.update(1.0f / 60.0f);
+        const BodyStorage& s = t.world.getStorage();
+        for (const ContactManifold& m : t.world.getContacts()) {
+            const BodyHandle a = s.handleAt(m.a), b = s.handleAt(m.b);
+            if (a == t.ground || b == t.ground) continue;
+            assert(sameTeam(t, a, b));
+        }
+    }
+    // Both columns stand on the ground, through each other
+    for (size_t i = 0; i < t.red.size(); ++i) {
+        const Vector2D r = t.world.getPosition(t.red[i]), b = t.world.getPosition(t.blue[i]);
+        assert(r.y > 120 && r.y < 200 && b.y > 120 && b.y < 200);
+        assert(std::abs(r.y - b.y) < 2.0f);
+    }
+}
+
+static void testSetFilter() {
+    Teams t;
+    buildTeams(t, std::make_unique<UniformGridBroadphase>(16.0f));
+    for (int step = 0; step < 60; ++step) t.world.update(1.0f / 60.0f);
+
+    // Blue joins red: the columns now push each other apart
+    for (BodyHandle h : t.blue) t.world.setFilter(h, t.world.getFilter(t.red[0]));
+    for (int step = 0; step < 10; ++step) t.world.update(1.0f / 60.0f);
+    assert(std::abs(t.world.getPosition(t.red[0]).x - t.world.getPosition(t.blue[0]).x) > 5.0f);
+
+    // A negative group turns the ground off for one body, which falls through
+    CollisionFilter ghost;
+    ghost.group = -1;
+    t.world.setFilter(t.ground, ghost);
+    t.world.setFilter(t.red[0], ghost);
+    for (int step = 0; step < 60; ++step) t.world.update(1.0f / 60.0f);
+    assert(t.world.getPosition(t.red[0]).y > 220);
+    assert(t.world.getPosition(t.blue[0]).y < 200);
+}
+
+static void testReplayKeepsFilters() {
+    ReplayLog log;
+    Teams recorded;
+    recorded.world.setRecorder(&log);
+    buildTeams(recorded, std::make_unique<BruteForceBroadphase>());
+    for (int step = 0; step < 30; ++step) recorded.world.update(1.0f / 60.0f);
+    recorded.world.setFilter(recorded.blue[2], CollisionFilter());
+    for (int step = 0; step < 30; ++step) recorded.world.update(1.0f / 60.0f);
+
+    PhysicsWorld replayed(Vector2D(0, 98.0f));
+    const ReplayResult result = replay(log, replayed);
+    assert(result.steps == 60 && !result.diverged());
+    assert(replayed.getFilter(recorded.red[0]) == recorded.world.getFilter(recorded.red[0]));
+    assert(replayed.getFilter(recorded.blue[2]) == CollisionFilter());
+}
+
+int main() {
+    testRules();
+    testTeamsPassThrough(std::make_unique<BruteForceBroadphase>());
+    testTeamsPassThrough(std::make_unique<UniformGridBroadphase>(16.0f));
+    testTeamsPassThrough(std::make_unique<DynamicTreeBroadphase>());
+    testSetFilter();
+    testReplayKeepsFilters();
+    return 0;
+}
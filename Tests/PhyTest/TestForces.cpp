@@ -0,0 +1,234 @@
+//
+// Force generator tests: each generator type against its formula, the bodies
+// it must leave alone, and identical results for any thread count.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+static bool near(float a, float b, float tolerance = 1e-4f) {
+    return std::abs(a - b) <= tolerance * std::max(1.0f, std::abs(b));
+}
+
+static BodyHandle addBall(PhysicsWorld& world, Vector2D position, float mass = 1.0f, bool isStatic = false) {
+    BodyDef def;
+    def.position = position;
+    def.radius = 1;
+    def.mass = mass;
+    def.isStatic = isStatic;
+    return world.createBody(def);
+}
+
+static void testSpring() {
+    PhysicsWorld world(Vector2D(0, 0));
+    const BodyHandle a = addBall(world, Vector2D(0, 0));
+    const BodyHandle b = addBall(world, Vector2D(20, 0), 3.0f);
+    world.addSpring(SpringDef{a, b, 10.0f, 2.0f, 0.5f});
+
+    // Stretched by 10: stiffness * 10 pulls the ends together
+    const float dt = 1.0f / 60.0f;
+    world.update(dt);
+    assert(near(world.getVelocity(a).x, 20.0f * dt));
+    assert(near(world.getVelocity(b).x, -20.0f / 3.0f * dt));
+    assert(world.getVelocity(a).y == 0.0f);
+
+    // Damped, the ends settle at the rest length with momentum conserved.
+    // This spring is slow enough to pass for resting.
+    world.getIslands().settings.enabled = false;
+    for (int step = 0; step < 3000; ++step) world.update(dt);
+    const float length = world.getPosition(b).x - world.getPosition(a).x;
+    assert(near(length, 10.0f, 1e-2f));
+    const float momentum = world.getVelocity(a).x + 3.0f * world.getVelocity(b).x;
+    assert(std::abs(momentum) < 1e-3f);
+}
+
+static void testSpringToStaticAndRemoval() {
+    PhysicsWorld world(Vector2D(0, 0));
+    const BodyHandle anchor = addBall(world, Vector2D(0, 0), 1.0f, true);
+    const BodyHandle a = addBall(world, Vector2D(0, 30));
+    const BodyHandle b = addBall(world, Vector2D(50, 0));
+    const uint32_t first = world.addSpring(SpringDef{anchor, a, 10.0f, 1.0f, 0.0f});
+    world.addSpring(SpringDef{anchor, b, 0.0f, 1.0f, 0.0f});
+    world.update(1.0f / 60.0f);
+    assert(world.getPosition(anchor).x == 0.0f && world.getPosition(anchor).y == 0.0f);
+    assert(world.getVelocity(a).y < 0.0f && world.getVelocity(b).x < 0.0f);
+
+    // The last spring takes the removed one's index
+    world.removeSpring(first);
+    const SpringColumns& springs = world.getForces().springs;
+    assert(springs.size() == 1 && springs.b[0] == b);
+    const Vector2D before = world.getVelocity(a);
+    world.update(1.0f / 60.0f);
+    assert(world.getVelocity(a).x == before.x && world.getVelocity(a).y == before.y);
+}
+
+static void testDragAndWind() {
+    PhysicsWorld world(Vector2D(0, 0));
+    BodyDef def;
+    def.radius = 1;
+    def.mass = 2;
+    def.velocity = Vector2D(3, 4);
+    const BodyHandle dragged = world.createBody(def);
+    def.position = Vector2D(100, 0);
+    def.velocity = Vector2D(0, 0);
+    const BodyHandle blown = world.createBody(def);
+    def.position = Vector2D(300, 0);
+    const BodyHandle sheltered = world.createBody(def);
+
+    const BodyHandle draggedOnly[] = {dragged};
+    world.addDrag(DragForce{0.5f, 0.1f}, draggedOnly);
+    WindForce wind;
+    wind.velocity = Vector2D(10, 0);
+    wind.coefficient = 0.2f;
+    wind.region = AABB(Vector2D(50, -50), Vector2D(200, 50));
+    world.addWind(wind);
+
+    const float dt = 0.1f;
+    world.update(dt);
+    // -(0.5 + 0.1 * 5) * v / mass, then the wind on it at (3, 4) relative air speed (7, -4)
+    const float k = 0.5f + 0.1f * 5.0f;
+    assert(near(world.getVelocity(dragged).x, 3.0f - k * 3.0f / 2.0f * dt));
+    assert(near(world.getVelocity(dragged).y, 4.0f - k * 4.0f / 2.0f * dt));
+    assert(near(world.getVelocity(blown).x, 0.2f * 10.0f / 2.0f * dt));
+    assert(world.getVelocity(sheltered).x == 0.0f);
+
+    // Parameters can change between updates
+    wind.coefficient = 0.0f;
+    world.setWind(0, wind);
+    const float blownSpeed = world.getVelocity(blown).x;
+    world.update(dt);
+    assert(world.getVelocity(blown).x == blownSpeed);
+}
+
+static void testRadialIgnoresMass() {
+    PhysicsWorld world(Vector2D(0, 0));
+    const BodyHandle light = addBall(world, Vector2D(10, 0), 1.0f);
+    const BodyHandle heavy = addBall(world, Vector2D(0, -10), 50.0f);
+    const BodyHandle far = addBall(world, Vector2D(100, 0));
+    const BodyHandle wall = addBall(world, Vector2D(-10, 0), 1.0f, true);
+    world.addRadialForce(RadialForce{Vector2D(0, 0), 8.0f, 20.0f});
+
+    const float dt = 0.1f;
+    world.update(dt);
+    // Half way to the radius: half the strength, towards the centre
+    assert(near(world.getVelocity(light).x, -4.0f * dt));
+    assert(near(world.getVelocity(heavy).y, 4.0f * dt));
+    assert(world.getVelocity(far).x == 0.0f);
+    assert(world.getVelocity(wall).x == 0.0f && world.getPosition(wall).x == -10.0f);
+
+    // A dynamic body without mass stays finite
+    const BodyHandle massless = addBall(world, Vector2D(0, 10), 0.0f);
+    world.update(dt);
+    assert(std::isfinite(world.getVelocity(massless).y) && std::isfinite(world.getPosition(massless).y));
+}
+
+static void testGeneratorsWakeBodies() {
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(-100, 10);
+    ground.width = 300;
+    ground.height = 10;
+    ground.isStatic = true;
+    world.createBody(ground);
+    BodyDef def;
+    def.radius = 5;
+    def.restitution = 0.0f;
+    const BodyHandle ball = world.createBody(def);
+    def.position = Vector2D(100, 0);
+    const BodyHandle other = world.createBody(def);
+    const auto settle = [&] {
+        for (int step = 0; step < 300; ++step) world.update(1.0f / 60.0f);
+        assert(!world.isAwake(ball) && !world.isAwake(other));
+    };
+    settle();
+
+    // A generator wakes the bodies of its list and no others
+    const BodyHandle ballOnly[] = {ball};
+    const uint32_t drag = world.addDrag(DragForce{0.1f, 0.0f}, ballOnly);
+    assert(world.isAwake(ball) && !world.isAwake(other));
+    settle();
+    world.setDrag(drag, DragForce{0.2f, 0.0f});
+    assert(world.isAwake(ball) && !world.isAwake(other));
+
+    // One for every body wakes every body, and changing it does again
+    settle();
+    const uint32_t wind = world.addWind(WindForce{Vector2D(50, 0), 0.0f});
+    assert(world.isAwake(ball) && world.isAwake(other));
+    settle();
+    const Vector2D rest = world.getPosition(other);
+    world.setWind(wind, WindForce{Vector2D(50, 0), 1.0f});
+    for (int step = 0; step < 10; ++step) world.update(1.0f / 60.0f);
+    assert(world.getPosition(other).x > rest.x);
+}
+
+static void testLinkedBodiesSleepTogether() {
+    PhysicsWorld world(Vector2D(0, 0));
+    std::vector<BodyHandle> chain;
+    for (int i = 0; i < 4; ++i) chain.push_back(addBall(world, Vector2D(i * 5.0f, 0)));
+    for (int i = 0; i + 1 < 4; ++i) world.addSpring(SpringDef{chain[i], chain[i + 1], 5.0f, 10.0f, 1.0f});
+    for (int step = 0; step < 60; ++step) world.update(1.0f / 60.0f);
+    for (BodyHandle body : chain) assert(!world.isAwake(body));
+
+    // Waking one end wakes the chain, and a push at that end reaches the other
+    world.setVelocity(chain[0], Vector2D(-20, 0));
+    world.update(1.0f / 60.0f);
+    for (BodyHandle body : chain) assert(world.isAwake(body));
+    for (int step = 0; step < 30; ++step) world.update(1.0f / 60.0f);
+    assert(world.getPosition(chain[3]).x < 15.0f);
+}
+
+// A hanging rope of many springs, with every generator type on top
+static void buildRope(PhysicsWorld& world) {
+    const int links = 3000;
+    BodyHandle previous = addBall(world, Vector2D(0, 0), 1.0f, true);
+    for (int i = 1; i <= links; ++i) {
+        const BodyHandle link = addBall(world, Vector2D(i * 2.0f, (i % 7) * 0.3f), 0.5f);
+        world.addSpring(SpringDef{previous, link, 2.0f, 400.0f, 2.0f});
+        previous = link;
+    }
+    world.addDrag(DragForce{0.05f, 0.01f});
+    world.addRadialForce(RadialForce{Vector2D(3000, 0), -40.0f, 500.0f});
+    WindForce wind;
+    wind.velocity = Vector2D(0, -5);
+    wind.coefficient = 0.1f;
+    wind.region = AABB(Vector2D(1000, -1000), Vector2D(2000, 1000));
+    world.addWind(wind);
+}
+
+static void testThreadCountIndependence() {
+    std::vector<std::vector<Vector2D>> results;
+    for (size_t threads : {0, 1, 4}) {
+        PhysicsWorld world(Vector2D(0, 98.0f));
+        world.setBroadphase(std::make_unique<UniformGridBroadphase>(8.0f));
+        RK::JobSystem jobs(threads > 0 ? threads : 1);
+        if (threads > 0) world.setJobSystem(&jobs);
+        buildRope(world);
+        for (int step = 0; step < 30; ++step) world.update(1.0f / 60.0f);
+        std::vector<Vector2D> positions;
+        for (uint32_t id = 0; id < world.getBodyCount(); ++id) positions.push_back(world.getPosition(BodyHandle{id}));
+        results.push_back(positions);
+
+#if PHYSICS_PROFILER
+        assert(world.getProfiler().record(world.getProfiler().size() - 1).phaseNs[static_cast<size_t>(ProfilePhase::Forces)] > 0);
+#endif
+    }
+    for (size_t r = 1; r < results.size(); ++r) {
+        for (size_t i = 0; i < results[0].size(); ++i) {
+            assert(results[r][i].x == results[0][i].x && results[r][i].y == results[0][i].y);
+        }
+    }
+}
+
+int main() {
+    testSpring();
+    testSpringToStaticAndRemoval();
+    testDragAndWind();
+    testRadialIgnoresMass();
+    testGeneratorsWakeBodies();
+    testLinkedBodiesSleepTogether();
+    testThreadCountIndependence();
+    return 0;
+}
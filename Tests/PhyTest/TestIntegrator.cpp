@@ -0,0 +1,77 @@
+//
+// The SIMD integration kernels must match the scalar loop bit for bit.
+//
+
+#include <Physics/BodyStorage.h>
+#include <Physics/Integrator.h>
+#include <cassert>
+#include <cstring>
+#include <random>
+
+static BodyStorage makeBodies(size_t count) {
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> value(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> mass(0.01f, 50.0f);
+    BodyStorage storage;
+    for (size_t i = 0; i < count; ++i) {
+        BodyDef def;
+        def.position = Vector2D(value(rng), value(rng));
+        def.velocity = Vector2D(value(rng) * 0.1f, value(rng) * 1e-6f);
+        def.mass = mass(rng);
+        def.isStatic = i % 3 == 0;
+        storage.add(def);
+        storage.forceX[i] = def.isStatic ? 7.0f : value(rng);
+        storage.forceY[i] = value(rng);
+        // Flags outside skipFlags must not stop integration
+        if (i % 7 == 0) storage.flags[i] |= 0x80;
+    }
+    return storage;
+}
+
+static IntegrationColumns columnsOf(BodyStorage& s) {
+    return IntegrationColumns{s.posX.data(), s.posY.data(), s.velX.data(), s.velY.data(),
+                              s.forceX.data(), s.forceY.data(), s.invMass.data(), s.flags.data(), s.size()};
+}
+
+static bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+static void testMatchesScalar(SimdLevel level) {
+    // Odd count and begin so both the packed loop and the tails run
+    const size_t count = 1003, begin = 3;
+    BodyStorage scalar = makeBodies(count);
+    BodyStorage packed = makeBodies(count);
+    const Vector2D gravity(0.3f, 98.0f);
+
+    for (int step = 0; step < 25; ++step) {
+        const float dt = 1.0f / (30.0f + step);
+        integrateBodies(columnsOf(scalar), begin, count, gravity, dt, BodyFlagStatic, SimdLevel::Scalar);
+        integrateBodies(columnsOf(packed), begin, count, gravity, dt, BodyFlagStatic, level);
+        // New forces every other step
+        if (step % 2 == 0) {
+            for (size_t i = 0; i < count; i += 5) {
+                scalar.forceX[i] = packed.forceX[i] = 3.5f * step;
+            }
+        }
+    }
+
+    assert(sameBits(scalar.posX, packed.posX) && sameBits(scalar.posY, packed.posY));
+    assert(sameBits(scalar.velX, packed.velX) && sameBits(scalar.velY, packed.velY));
+    assert(sameBits(scalar.forceX, packed.forceX) && sameBits(scalar.forceY, packed.forceY));
+
+    // Bodies before begin and static bodies never moved
+    BodyStorage initial = makeBodies(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (i < begin || initial.isStatic(i)) {
+            assert(packed.posX[i] == initial.posX[i] && packed.velY[i] == initial.velY[i]);
+        }
+    }
+}
+
+int main() {
+    testMatchesScalar(SimdLevel::SSE2);
+    testMatchesScalar(SimdLevel::AVX2);
+    testMatchesScalar(detectSimdLevel());
+    return 0;
+}
@@ -0,0 +1,140 @@
+//
+// Islands and sleeping: resting islands sleep, touches and forces wake them.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+struct Scene {
+    PhysicsWorld world{Vector2D(0, 98.0f)};
+    std::vector<BodyHandle> left;  // stack of boxes
+    std::vector<BodyHandle> right; // another stack, never touching the first
+};
+
+static void buildStack(PhysicsWorld& world, float x, int height, std::vector<BodyHandle>& out) {
+    for (int i = 0; i < height; ++i) {
+        BodyDef box;
+        box.shape = ShapeType::Rectangle;
+        box.position = Vector2D(x, 400 - 20.0f * (i + 1));
+        box.width = box.height = 20;
+        box.restitution = 0.0f;
+        out.push_back(world.createBody(box));
+    }
+}
+
+static void buildScene(Scene& scene, std::unique_ptr<Broadphase> broadphase) {
+    scene.world.setBroadphase(std::move(broadphase));
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 400);
+    ground.width = 800;
+    ground.height = 50;
+    ground.isStatic = true;
+    scene.world.createBody(ground);
+    buildStack(scene.world, 100, 3, scene.left);
+    buildStack(scene.world, 300, 3, scene.right);
+}
+
+static void step(Scene& scene, int steps) {
+    for (int i = 0; i < steps; ++i) scene.world.update(1.0f / 60.0f);
+}
+
+static bool allAwake(const Scene& scene, const std::vector<BodyHandle>& bodies) {
+    for (BodyHandle b : bodies) if (!scene.world.isAwake(b)) return false;
+    return true;
+}
+
+static bool allAsleep(const Scene& scene, const std::vector<BodyHandle>& bodies) {
+    for (BodyHandle b : bodies) if (scene.world.isAwake(b)) return false;
+    return true;
+}
+
+static void testStacksAreSeparateIslands() {
+    Scene scene;
+    buildScene(scene, std::make_unique<BruteForceBroadphase>());
+    scene.world.getIslands().settings.timeToSleep = 1e9f;
+    step(scene, 30);
+    // The ground is static, so it does not join the two stacks
+    assert(scene.world.getIslands().getIslandCount() == 2);
+    assert(scene.world.getIslands().getAwakeCount() == 6);
+}
+
+static void testRestingIslandsSleep() {
+    Scene scene;
+    buildScene(scene, std::make_unique<BruteForceBroadphase>());
+    step(scene, 120);
+    assert(allAsleep(scene, scene.left) && allAsleep(scene, scene.right));
+    assert(scene.world.getIslands().getSleepingCount() == 6);
+    assert(scene.world.getIslands().getAwakeCount() == 0);
+    // Sleepers against sleepers or the ground produce no contacts
+    assert(scene.world.getContacts().empty());
+
+    // Asleep means not moved at all
+    const Vector2D before = scene.world.getPosition(scene.left[2]);
+    step(scene, 60);
+    const Vector2D after = scene.world.getPosition(scene.left[2]);
+    assert(before.x == after.x && before.y == after.y);
+}
+
+static void testTouchWakesIsland(std::unique_ptr<Broadphase> broadphase) {
+    Scene scene;
+    buildScene(scene, std::move(broadphase));
+    step(scene, 120);
+    assert(allAsleep(scene, scene.left) && allAsleep(scene, scene.right));
+
+    // Drop a ball on the left stack
+    BodyDef ball;
+    ball.position = Vector2D(110, 300);
+    ball.radius = 5;
+    ball.restitution = 0.0f;
+    scene.world.createBody(ball);
+
+    bool woke = false;
+    for (int i = 0; i < 60 && !woke; ++i) {
+        step(scene, 1);
+        woke = scene.world.isAwake(scene.left[0]);
+    }
+    assert(woke);
+    // The whole island wakes, the other one sleeps on
+    assert(allAwake(scene, scene.left));
+    assert(allAsleep(scene, scene.right));
+
+    // ...and everything settles again
+    step(scene, 240);
+    assert(allAsleep(scene, scene.left));
+}
+
+static void testForceWakesIsland() {
+    Scene scene;
+    buildScene(scene, std::make_unique<BruteForceBroadphase>());
+    step(scene, 120);
+    assert(allAsleep(scene, scene.right));
+
+    scene.world.applyForce(scene.right[0], Vector2D(0, -10));
+    assert(allAwake(scene, scene.right));
+    assert(allAsleep(scene, scene.left));
+}
+
+static void testDisablingWakesEverything() {
+    Scene scene;
+    buildScene(scene, std::make_unique<BruteForceBroadphase>());
+    step(scene, 120);
+    scene.world.getIslands().settings.enabled = false;
+    step(scene, 1);
+    assert(allAwake(scene, scene.left) && allAwake(scene, scene.right));
+    assert(scene.world.getIslands().getSleepingCount() == 0);
+}
+
+int main() {
+    testStacksAreSeparateIslands();
+    testRestingIslandsSleep();
+    testTouchWakesIsland(std::make_unique<BruteForceBroadphase>());
+    testTouchWakesIsland(std::make_unique<UniformGridBroadphase>(32.0f));
+    testTouchWakesIsland(std::make_unique<SweepAndPruneBroadphase>());
+    testTouchWakesIsland(std::make_unique<DynamicTreeBroadphase>());
+    testForceWakesIsland();
+    testDisablingWakesEverything();
+    return 0;
+}
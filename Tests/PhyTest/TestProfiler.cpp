@@ -0,0 +1,108 @@
+//
+// Step profiler: ring buffer, percentiles, dumps and the world's records.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <sstream>
+#include <string>
+
+static void record(StepProfiler& profiler, uint64_t integrateNs) {
+    profiler.beginFrame();
+    profiler.addTime(ProfilePhase::Integrate, integrateNs);
+    profiler.current().contacts = static_cast<uint32_t>(integrateNs);
+    profiler.endFrame();
+}
+
+static void testRingKeepsNewestFrames() {
+    StepProfiler profiler(4);
+    for (uint64_t i = 0; i < 10; ++i) record(profiler, i);
+    assert(profiler.size() == 4 && profiler.capacity() == 4);
+    for (size_t i = 0; i < 4; ++i) {
+        assert(profiler.record(i).frame == 6 + i);
+        assert(profiler.record(i).phaseNs[static_cast<size_t>(ProfilePhase::Integrate)] == 6 + i);
+    }
+    profiler.clear();
+    assert(profiler.size() == 0);
+
+    // A zero capacity still keeps the newest frame
+    StepProfiler tiny(0);
+    for (uint64_t i = 0; i < 3; ++i) record(tiny, i);
+    assert(tiny.capacity() == 1 && tiny.size() == 1 && tiny.record(0).frame == 2);
+}
+
+static void testPercentiles() {
+    StepProfiler profiler(1000);
+    // 1..100 in scrambled order
+    for (uint64_t i = 0; i < 100; ++i) record(profiler, (i * 37) % 100 + 1);
+    const ProfileSummary summary = profiler.summarize(ProfilePhase::Integrate);
+    assert(summary.p50 == 50);
+    assert(summary.p99 == 99);
+    assert(summary.max == 100);
+
+    const ProfileSummary empty = StepProfiler(8).summarizeTotal();
+    assert(empty.p50 == 0 && empty.p99 == 0 && empty.max == 0);
+}
+
+static void testDumps() {
+    StepProfiler profiler(8);
+    record(profiler, 5);
+    record(profiler, 7);
+
+    std::ostringstream csv;
+    profiler.writeCsv(csv);
+    std::istringstream lines(csv.str());
+    std::string header, first, second, extra;
+    std::getline(lines, header);
+    std::getline(lines, first);
+    std::getline(lines, second);
+    assert(!std::getline(lines, extra));
+    assert(header.rfind("frame,total_ns,forces_ns,integrate_ns,", 0) == 0);
+    assert(header.find("awake_bodies") != std::string::npos);
+    assert(first.rfind("0,", 0) == 0 && second.rfind("1,", 0) == 0);
+
+    std::ostringstream json;
+    profiler.writeJson(json);
+    const std::string text = json.str();
+    assert(text.front() == '[');
+    assert(text.find("\"integrate_ns\": 5") != std::string::npos);
+    assert(text.find("\"integrate_ns\": 7") != std::string::npos);
+}
+
+static void testWorldRecordsFrames() {
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 100);
+    ground.width = 200;
+    ground.height = 10;
+    ground.isStatic = true;
+    world.createBody(ground);
+    BodyDef ball;
+    ball.position = Vector2D(50, 95);
+    ball.radius = 5;
+    world.createBody(ball);
+
+    for (int i = 0; i < 3; ++i) world.update(1.0f / 60.0f);
+
+#if PHYSICS_PROFILER
+    StepProfiler& profiler = world.getProfiler();
+    assert(profiler.size() == 3);
+    const FrameRecord& last = profiler.record(2);
+    assert(last.frame == 2);
+    assert(last.candidatePairs == 1);
+    assert(last.contacts == world.getContacts().size());
+    assert(last.awakeBodies == world.getIslands().getAwakeCount());
+    uint64_t phases = 0;
+    for (uint64_t ns : last.phaseNs) phases += ns;
+    assert(phases <= last.totalNs);
+#endif
+}
+
+int main() {
+    testRingKeepsNewestFrames();
+    testPercentiles();
+    testDumps();
+    testWorldRecordsFrames();
+    return 0;
+}
@@ -0,0 +1,265 @@
+//
+// Spatial query tests: every broadphase must answer exactly like a scan over
+// all bodies, including bodies created or moved since the last update.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <random>
+
+static void populate(PhysicsWorld& world, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(0.0f, 600.0f), size(1.0f, 12.0f);
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(-50, 600);
+    ground.width = 700;
+    ground.height = 40;
+    ground.isStatic = true;
+    world.createBody(ground);
+    for (int i = 0; i < 1500; ++i) {
+        BodyDef def;
+        def.position = Vector2D(pos(rng), pos(rng));
+        def.radius = size(rng);
+        if (i % 3 == 0) {
+            def.shape = ShapeType::Rectangle;
+            def.width = size(rng);
+            def.height = size(rng);
+        }
+        world.createBody(def);
+    }
+}
+
+static std::vector<uint32_t> sortedIds(const std::vector<BodyHandle>& handles) {
+    std::vector<uint32_t> ids;
+    for (BodyHandle h : handles) ids.push_back(h.id);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+// References: test every body
+static std::vector<uint32_t> scanOverlaps(const PhysicsWorld& world, const Collider& query) {
+    const BodyStorage& s = world.getStorage();
+    std::vector<uint32_t> ids;
+    for (uint32_t i = 0; i < s.size(); ++i) {
+        Contact contact;
+        if (collide(query, s.collider(i), contact)) ids.push_back(s.ids[i]);
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+static RayHit scanRay(const PhysicsWorld& world, Vector2D from, Vector2D to) {
+    const BodyStorage& s = world.getStorage();
+    RayHit best;
+    for (uint32_t i = 0; i < s.size(); ++i) {
+        float fraction;
+        Vector2D normal;
+        if (!raycast(s.collider(i), from, to - from, fraction, normal)) continue;
+        if (best.body.isValid() && (fraction > best.fraction || (fraction == best.fraction && s.ids[i] > best.body.id))) continue;
+        best.body = s.handleAt(i);
+        best.fraction = fraction;
+    }
+    return best;
+}
+
+static std::vector<uint32_t> scanNearest(const PhysicsWorld& world, Vector2D point, size_t k) {
+    const BodyStorage& s = world.getStorage();
+    std::vector<std::pair<float, uint32_t>> all;
+    for (uint32_t i = 0; i < s.size(); ++i) all.emplace_back(distanceTo(s.collider(i), point), s.ids[i]);
+    std::sort(all.begin(), all.end());
+    std::vector<uint32_t> ids;
+    for (size_t i = 0; i < std::min(k, all.size()); ++i) ids.push_back(all[i].second);
+    return ids;
+}
+
+static void checkQueries(const PhysicsWorld& world, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-50.0f, 650.0f), size(0.0f, 80.0f);
+    std::vector<BodyHandle> out;
+    for (int q = 0; q < 200; ++q) {
+        const Vector2D a(pos(rng), pos(rng)), b(pos(rng), pos(rng));
+        const float extent = size(rng);
+
+        const AABB box(a, Vector2D(a.x + extent, a.y + extent * 0.5f));
+        world.overlapAABB(box, out);
+        assert(sortedIds(out) == scanOverlaps(world, Collider{ShapeType::Rectangle, box.min, box.max - box.min}));
+
+        world.overlapCircle(a, extent, out);
+        assert(sortedIds(out) == scanOverlaps(world, Collider{ShapeType::Circle, a, Vector2D(extent, 0)}));
+
+        RayHit hit;
+        const RayHit expected = scanRay(world, a, b);
+        assert(world.raycast(a, b, hit) == expected.body.isValid());
+        assert(hit.body == expected.body);
+        if (hit.body.isValid()) assert(hit.fraction == expected.fraction);
+
+        const size_t k = 1 + q % 12;
+        world.kNearest(a, k, out);
+        std::vector<uint32_t> nearest;
+        for (BodyHandle h : out) nearest.push_back(h.id);
+        assert(nearest == scanNearest(world, a, k));
+    }
+}
+
+static void testMatchesScan(std::unique_ptr<Broadphase> broadphase) {
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    world.setBroadphase(std::move(broadphase));
+
+    // Nothing indexed yet: every body is tested directly
+    populate(world, 3);
+    checkQueries(world, 1);
+
+    // Bodies settling on each other are moved by the position solver
+    for (int i = 0; i < 30; ++i) world.update(1.0f / 60.0f);
+    checkQueries(world, 2);
+
+    // Teleported and new bodies are found before the next update
+    world.setPosition(BodyHandle{5}, Vector2D(300, 300));
+    world.setPosition(BodyHandle{6}, Vector2D(-40, -40));
+    BodyDef late;
+    late.position = Vector2D(200, 200);
+    late.radius = 30;
+    world.createBody(late);
+    checkQueries(world, 3);
+}
+
+static void testRayHit() {
+    PhysicsWorld world(Vector2D(0, 0));
+    world.setBroadphase(std::make_unique<DynamicTreeBroadphase>());
+    BodyDef box;
+    box.shape = ShapeType::Rectangle;
+    box.position = Vector2D(10, -5);
+    box.width = box.height = 10;
+    const BodyHandle wall = world.createBody(box);
+    BodyDef circle;
+    circle.position = Vector2D(40, 0);
+    circle.radius = 2;
+    world.createBody(circle);
+    world.update(1.0f / 60.0f);
+
+    RayHit hit;
+    assert(world.raycast(Vector2D(0, 0), Vector2D(50, 0), hit));
+    assert(hit.body == wall);
+    assert(std::abs(hit.fraction - 0.2f) < 1e-5f);
+    assert(std::abs(hit.point.x - 10.0f) < 1e-4f);
+    assert(hit.normal.x == -1.0f && hit.normal.y == 0.0f);
+
+    // From the other side the circle is first
+    assert(world.raycast(Vector2D(50, 0), Vector2D(0, 0), hit));
+    assert(hit.body != wall);
+    assert(std::abs(hit.point.x - 42.0f) < 1e-4f);
+    assert(std::abs(hit.normal.x - 1.0f) < 1e-5f);
+
+    assert(!world.raycast(Vector2D(0, 20), Vector2D(50, 20), hit));
+    assert(!hit.body.isValid());
+}
+
+static void testBatchMatchesSingle() {
+    RK::JobSystem jobs(3);
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    world.setBroadphase(std::make_unique<UniformGridBroadphase>(16.0f));
+    world.setJobSystem(&jobs);
+    populate(world, 9);
+    for (int i = 0; i < 10; ++i) world.update(1.0f / 60.0f);
+
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<float> pos(0.0f, 600.0f);
+    std::vector<RayQuery> rays;
+    std::vector<AABB> boxes;
+    std::vector<CircleQuery> circles;
+    std::vector<NearestQuery> nearest;
+    for (int q = 0; q < 500; ++q) {
+        const Vector2D a(pos(rng), pos(rng)), b(pos(rng), pos(rng));
+        rays.push_back({a, b});
+        boxes.emplace_back(a, a + Vector2D(30, 20));
+        circles.push_back({b, 25.0f});
+        nearest.push_back({a, size_t(1 + q % 8)});
+    }
+
+    std::vector<RayHit> hits(rays.size());
+    world.raycastBatch(rays, hits);
+    std::vector<BodyHandle> out;
+    for (size_t q = 0; q < rays.size(); ++q) {
+        RayHit hit;
+        world.raycast(rays[q].from, rays[q].to, hit);
+        assert(hit.body == hits[q].body && hit.fraction == hits[q].fraction);
+        if (hit.body.isValid()) assert(hit.point.x == hits[q].point.x && hit.normal.y == hits[q].normal.y);
+    }
+
+    // Overlaps and neighbours stream into one flat buffer
+    std::vector<BodyHandle> handles(64 * 1024);
+    std::vector<QueryRange> ranges(boxes.size());
+    auto checkRanges = [&](auto&& single) {
+        std::vector<uint8_t> used(handles.size(), 0);
+        for (size_t q = 0; q < ranges.size(); ++q) {
+            single(q, out);
+            assert(ranges[q].count == out.size());
+            const std::vector<BodyHandle> found(handles.begin() + ranges[q].offset,
+                                                handles.begin() + ranges[q].offset + ranges[q].count);
+            assert(sortedIds(found) == sortedIds(out));
+            // Ranges do not overlap
+            for (uint32_t i = 0; i < ranges[q].count; ++i) assert(!used[ranges[q].offset + i]++);
+        }
+    };
+
+    const size_t total = world.overlapAABBBatch(boxes, handles, ranges);
+    assert(total > 0 && total <= handles.size());
+    checkRanges([&](size_t q, std::vector<BodyHandle>& o) { world.overlapAABB(boxes[q], o); });
+    world.overlapCircleBatch(circles, handles, ranges);
+    checkRanges([&](size_t q, std::vector<BodyHandle>& o) { world.overlapCircle(circles[q].centre, circles[q].radius, o); });
+    world.kNearestBatch(nearest, handles, ranges);
+    checkRanges([&](size_t q, std::vector<BodyHandle>& o) { world.kNearest(nearest[q].point, nearest[q].k, o); });
+    for (size_t q = 0; q < ranges.size(); ++q) {
+        world.kNearest(nearest[q].point, nearest[q].k, out);
+        assert(std::equal(out.begin(), out.end(), handles.begin() + ranges[q].offset)); // nearest first
+    }
+
+    // A buffer too small reports how much was needed
+    const size_t needed = world.overlapAABBBatch(boxes, handles, ranges);
+    std::vector<BodyHandle> small(needed / 2);
+    assert(world.overlapAABBBatch(boxes, small, ranges) == needed);
+    size_t placed = 0, missing = 0;
+    for (const QueryRange& r : ranges) {
+        if (r.offset == QueryRange::NoSpace) ++missing;
+        else placed += r.count;
+    }
+    assert(missing > 0 && placed <= small.size());
+}
+
+static void testPacketsMatchSingleRays() {
+    PhysicsWorld world(Vector2D(0, 98.0f));
+    world.setBroadphase(std::make_unique<DynamicTreeBroadphase>());
+    populate(world, 5);
+    for (int i = 0; i < 10; ++i) world.update(1.0f / 60.0f);
+    world.setPosition(BodyHandle{12}, Vector2D(310, 290));
+
+    // Lines of sight from a few observers, 16 rays a packet, plus a ragged tail
+    std::mt19937 rng(8);
+    std::uniform_real_distribution<float> pos(0.0f, 600.0f);
+    std::vector<RayQuery> rays;
+    for (int observer = 0; observer < 6; ++observer) {
+        const Vector2D eye(pos(rng), pos(rng));
+        for (int i = 0; i < 37; ++i) rays.push_back({eye, Vector2D(pos(rng), pos(rng))});
+    }
+    std::vector<RayHit> hits(rays.size());
+    world.raycastBatch(rays, hits);
+    for (size_t q = 0; q < rays.size(); ++q) {
+        RayHit hit;
+        world.raycast(rays[q].from, rays[q].to, hit);
+        assert(hit.body == hits[q].body && hit.fraction == hits[q].fraction);
+    }
+}
+
+int main() {
+    testMatchesScan(std::make_unique<BruteForceBroadphase>());
+    testMatchesScan(std::make_unique<UniformGridBroadphase>(16.0f));
+    testMatchesScan(std::make_unique<SweepAndPruneBroadphase>());
+    testMatchesScan(std::make_unique<DynamicTreeBroadphase>());
+    testRayHit();
+    testBatchMatchesSingle();
+    testPacketsMatchSingleRays();
+    return 0;
+}
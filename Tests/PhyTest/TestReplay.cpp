@@ -0,0 +1,123 @@
+//
+// Input recording, replay and state hashes.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <Physics/Replay.h>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <string>
+
+// A session with every kind of input: bodies added while running, forces,
+// teleports, gravity changes, a bullet and force generators added, changed
+// and removed, stepped through advance()
+static void playSession(PhysicsWorld& world, int steps) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    BodyDef ground;
+    ground.shape = ShapeType::Rectangle;
+    ground.position = Vector2D(0, 200);
+    ground.width = 300;
+    ground.height = 20;
+    ground.isStatic = true;
+    world.createBody(ground);
+
+    std::vector<BodyHandle> bodies;
+    for (int frame = 0; frame < steps; ++frame) {
+        if (frame % 5 == 0 && bodies.size() < 60) {
+            BodyDef def;
+            def.position = Vector2D(20.0f + unit(rng) * 260.0f, unit(rng) * 50.0f);
+            def.radius = 3.0f + unit(rng) * 2.0f;
+            bodies.push_back(world.createBody(def));
+        }
+        if (frame % 7 == 0) world.applyForce(bodies[rng() % bodies.size()], Vector2D(unit(rng) * 500.0f, -800.0f));
+        if (frame % 50 == 0) world.setVelocity(bodies[rng() % bodies.size()], Vector2D(0, -100));
+        if (frame == 90) world.setPosition(bodies[0], Vector2D(150, 20));
+        if (frame == 120) world.setBullet(bodies[1], true);
+        if (frame == 150) world.setGravity(Vector2D(20, 98));
+        if (frame == 40) world.addSpring(SpringDef{bodies[2], bodies[3], 10.0f, 50.0f, 1.0f});
+        if (frame == 100) {
+            const BodyHandle dragged[] = {bodies[4], bodies[5]};
+            world.addDrag(DragForce{0.5f, 0.01f}, dragged);
+        }
+        if (frame == 130) world.addRadialForce(RadialForce{Vector2D(150, 150), -200.0f, 80.0f});
+        if (frame == 160) world.addWind(WindForce{Vector2D(-40, 0), 0.3f});
+        if (frame == 200) world.setWind(0, WindForce{Vector2D(40, 0), 0.5f});
+        if (frame == 220) world.removeSpring(0);
+        if (frame == 240) world.setRadialForce(0, RadialForce{Vector2D(100, 150), 300.0f, 60.0f});
+        if (frame == 250) world.setDrag(0, DragForce{0.0f, 0.05f});
+        world.advance(1.0f / 60.0f);
+    }
+}
+
+static void testReplayMatches() {
+    ReplayLog log;
+    PhysicsWorld recorded(Vector2D(0, 98));
+    recorded.setRecorder(&log);
+    playSession(recorded, 300);
+    assert(log.getStepCount() == 300);
+
+    PhysicsWorld replayed(Vector2D(0, 98));
+    const ReplayResult result = replay(log, replayed);
+    assert(!result.diverged() && result.steps == 300);
+    assert(hashWorldState(replayed.getStorage()) == hashWorldState(recorded.getStorage()));
+
+    // The step order does not depend on threads
+    RK::JobSystem jobs(3);
+    PhysicsWorld threaded(Vector2D(0, 98));
+    threaded.setJobSystem(&jobs);
+    assert(!replay(log, threaded).diverged());
+
+    // Prefixes replay for bisecting
+    PhysicsWorld prefix(Vector2D(0, 98));
+    assert(replay(log, prefix, 100).steps == 100);
+}
+
+static void testDivergenceIsFound() {
+    ReplayLog log;
+    PhysicsWorld recorded(Vector2D(0, 98));
+    recorded.setRecorder(&log);
+    playSession(recorded, 300);
+
+    // Fewer solver iterations change nothing until bodies touch
+    PhysicsWorld different(Vector2D(0, 98));
+    different.getSolver().settings.velocityIterations = 2;
+    const ReplayResult result = replay(log, different);
+    assert(result.diverged() && result.firstDivergence > 0 && result.firstDivergence < 300);
+    assert(result.expectedHash != result.actualHash);
+    assert(result.steps == uint64_t(result.firstDivergence) + 1);
+}
+
+static void testSaveAndLoad() {
+    ReplayLog log;
+    PhysicsWorld recorded(Vector2D(0, 98));
+    recorded.setRecorder(&log);
+    playSession(recorded, 60);
+
+    const std::string path = "/tmp/replay_" + std::to_string(::getpid()) + ".log";
+    assert(log.save(path.c_str()));
+    ReplayLog loaded;
+    assert(loaded.load(path.c_str()));
+    assert(loaded.getBytes() == log.getBytes() && loaded.getStepCount() == 60);
+
+    PhysicsWorld replayed(Vector2D(0, 98));
+    assert(!replay(loaded, replayed).diverged());
+
+    // A cut-off record is rejected
+    std::FILE* f = std::fopen(path.c_str(), "r+b");
+    const uint64_t shorter = log.getBytes().size() - 3;
+    std::fseek(f, 12, SEEK_SET);
+    std::fwrite(&shorter, sizeof(shorter), 1, f);
+    std::fclose(f);
+    assert(!loaded.load(path.c_str()) && loaded.getStepCount() == 60);
+    std::remove(path.c_str());
+}
+
+int main() {
+    testReplayMatches();
+    testDivergenceIsFound();
+    testSaveAndLoad();
+    return 0;
+}
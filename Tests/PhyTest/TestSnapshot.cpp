@@ -0,0 +1,92 @@
+//
+// Snapshots published after each update and read from other threads.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+// A row of bodies falling side by side without touching: in any consistent
+// snapshot they all share one height and one speed
+static void addRow(PhysicsWorld& world, int count) {
+    for (int i = 0; i < count; ++i) {
+        BodyDef def;
+        def.position = Vector2D(float(i) * 10.0f, 0);
+        def.radius = 1;
+        world.createBody(def);
+    }
+}
+
+static void testPublishing() {
+    PhysicsWorld world(Vector2D(0, 10));
+    addRow(world, 4);
+    SnapshotPublisher& snapshots = world.getSnapshots();
+
+    // Off by default
+    world.update(1.0f / 60.0f);
+    assert(!snapshots.acquire());
+
+    snapshots.enabled = true;
+    world.update(1.0f / 60.0f);
+    SnapshotRef first = snapshots.acquire();
+    assert(first && first->sequence == 1 && first->size() == 4);
+    for (size_t i = 0; i < 4; ++i) {
+        const BodyHandle handle{first->ids[i]};
+        assert(first->getPosition(i).y == world.getPosition(handle).y);
+        assert(first->getVelocity(i).y == world.getVelocity(handle).y);
+        assert(first->isAwake(i));
+    }
+
+    // A held snapshot stays as it was while the world moves on
+    const float heldY = first->posY[0];
+    for (int i = 0; i < 10; ++i) world.update(1.0f / 60.0f);
+    assert(first->sequence == 1 && first->posY[0] == heldY);
+    SnapshotRef latest = snapshots.acquire();
+    assert(latest->sequence == 11 && latest->posY[0] > heldY);
+
+    // Two held snapshots plus one being written still fit in three buffers
+    assert(snapshots.getBufferCount() == 3);
+    first.release();
+    latest.release();
+    for (int i = 0; i < 10; ++i) world.update(1.0f / 60.0f);
+    assert(snapshots.getBufferCount() == 3);
+}
+
+static void testReadersNeverSeeTornState() {
+    PhysicsWorld world(Vector2D(0, 10));
+    addRow(world, 256);
+    world.getSnapshots().enabled = true;
+    world.update(1.0f / 60.0f);
+
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> reads{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            uint64_t lastSequence = 0;
+            while (!done.load()) {
+                SnapshotRef snapshot = world.getSnapshots().acquire();
+                assert(snapshot->sequence >= lastSequence);
+                lastSequence = snapshot->sequence;
+                for (size_t i = 1; i < snapshot->size(); ++i) {
+                    assert(snapshot->posY[i] == snapshot->posY[0]);
+                    assert(snapshot->velY[i] == snapshot->velY[0]);
+                }
+                ++reads;
+            }
+        });
+    }
+    for (int i = 0; i < 2000; ++i) world.update(1.0f / 60.0f);
+    while (reads.load() < 100) std::this_thread::yield();
+    done = true;
+    for (std::thread& t : readers) t.join();
+    assert(world.getSnapshots().getPublishedCount() == 2001);
+}
+
+int main() {
+    testPublishing();
+    testReadersNeverSeeTornState();
+    return 0;
+}
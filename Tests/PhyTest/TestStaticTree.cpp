@@ -0,0 +1,151 @@
+//
+// Static tree tests: the tree answers box and ray queries like a scan, and a
+// world keeps its static bodies in it without losing any contact or query
+// result, and without ever pairing two static bodies.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <Physics/StaticTree.h>
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <vector>
+
+static void testTreeMatchesScan() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(0.0f, 1000.0f), size(0.5f, 30.0f);
+    std::vector<AABB> boxes;
+    std::vector<uint32_t> data;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        const Vector2D min(pos(rng), pos(rng));
+        boxes.emplace_back(min, min + Vector2D(size(rng), size(rng)));
+        data.push_back(i * 3);
+    }
+    // Many identical boxes cannot be split by position
+    for (uint32_t i = 0; i < 200; ++i) {
+        boxes.emplace_back(Vector2D(500, 500), Vector2D(510, 510));
+        data.push_back(90000 + i);
+    }
+
+    StaticTree tree;
+    tree.build(boxes.data(), data.data(), boxes.size());
+    assert(tree.size() == boxes.size());
+
+    for (int q = 0; q < 300; ++q) {
+        const Vector2D min(pos(rng), pos(rng));
+        const AABB box(min, min + Vector2D(size(rng) * 3, size(rng) * 3));
+        std::vector<uint32_t> found, expected;
+        tree.query(box, [&](uint32_t d) {
+            found.push_back(d);
+            return true;
+        });
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].overlaps(box)) expected.push_back(data[i]);
+        }
+        std::sort(found.begin(), found.end());
+        std::sort(expected.begin(), expected.end());
+        assert(found == expected);
+
+        // Without clipping a ray visits every box the segment enters
+        const Vector2D from(pos(rng), pos(rng)), to(pos(rng), pos(rng));
+        found.clear();
+        expected.clear();
+        tree.raycast(from, to, 1.0f, [&](uint32_t d) {
+            found.push_back(d);
+            return 1.0f;
+        });
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].intersectsSegment(from, to - from, 1.0f)) expected.push_back(data[i]);
+        }
+        std::sort(found.begin(), found.end());
+        std::sort(expected.begin(), expected.end());
+        assert(found == expected);
+    }
+
+    tree.build(nullptr, nullptr, 0);
+    assert(tree.size() == 0 && tree.getNodeCount() == 0);
+    tree.query(AABB(Vector2D(0, 0), Vector2D(1000, 1000)), [](uint32_t) {
+        assert(false);
+        return true;
+    });
+}
+
+// Rows of static tiles with circles dropped onto them
+static void populate(PhysicsWorld& world) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> x(0.0f, 400.0f), y(0.0f, 150.0f);
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 50; ++col) {
+            BodyDef tile;
+            tile.shape = ShapeType::Rectangle;
+            tile.position = Vector2D(col * 8.0f, 200.0f + row * 30.0f - (col % 5));
+            tile.width = tile.height = 8;
+            tile.isStatic = true;
+            world.createBody(tile);
+        }
+    }
+    for (int i = 0; i < 150; ++i) {
+        BodyDef ball;
+        ball.position = Vector2D(x(rng), y(rng));
+        ball.radius = 3;
+        world.createBody(ball);
+    }
+}
+
+static std::vector<uint64_t> contactKeys(const PhysicsWorld& world) {
+    std::vector<uint64_t> keys;
+    for (const ContactManifold& m : world.getContacts()) keys.push_back(m.key);
+    return keys;
+}
+
+static void testWorldKeepsStaticsApart() {
+    PhysicsWorld brute(Vector2D(0, 98.0f)), grid(Vector2D(0, 98.0f));
+    grid.setBroadphase(std::make_unique<UniformGridBroadphase>(16.0f));
+    populate(brute);
+    populate(grid);
+
+    size_t staticContacts = 0;
+    for (int step = 0; step < 120; ++step) {
+        brute.update(1.0f / 60.0f);
+        grid.update(1.0f / 60.0f);
+        assert(contactKeys(brute) == contactKeys(grid));
+        const BodyStorage& s = grid.getStorage();
+        for (const ContactManifold& m : grid.getContacts()) {
+            assert(!(s.isStatic(m.a) && s.isStatic(m.b)));
+            if (s.isStatic(m.a) || s.isStatic(m.b)) ++staticContacts;
+        }
+        // Contacts come in pair order
+        const std::vector<ContactManifold>& contacts = grid.getContacts();
+        for (size_t i = 1; i < contacts.size(); ++i) {
+            assert(BodyPair(contacts[i - 1].a, contacts[i - 1].b) < BodyPair(contacts[i].a, contacts[i].b));
+        }
+    }
+    assert(staticContacts > 0);
+
+    // Queries see the static bodies, also at a new position right away
+    RayHit hit;
+    assert(grid.raycast(Vector2D(4, 1000), Vector2D(4, 0), hit));
+    assert(hit.body == BodyHandle{150}); // bottom row, first column
+    const BodyHandle tile{0};
+    grid.setPosition(tile, Vector2D(1000, 1000));
+    std::vector<BodyHandle> found;
+    grid.overlapAABB(AABB(Vector2D(995, 995), Vector2D(1010, 1010)), found);
+    assert(found.size() == 1 && found[0] == tile);
+    grid.overlapAABB(AABB(Vector2D(-1, 195), Vector2D(3, 205)), found);
+    assert(std::find(found.begin(), found.end(), tile) == found.end());
+
+    // A ball dropped onto the moved tile lands on it
+    BodyDef ball;
+    ball.position = Vector2D(1004, 980);
+    ball.radius = 3;
+    ball.restitution = 0.0f;
+    const BodyHandle dropped = grid.createBody(ball);
+    for (int step = 0; step < 120; ++step) grid.update(1.0f / 60.0f);
+    assert(grid.getPosition(dropped).y < 1000);
+}
+
+int main() {
+    testTreeMatchesScan();
+    testWorldKeepsStaticsApart();
+    return 0;
+}
@@ -0,0 +1,57 @@
+//
+// A world step must give bit-identical results for any thread count.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <cstring>
+#include <random>
+
+static void build(PhysicsWorld& world) {
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> pos(0.0f, 300.0f);
+    std::uniform_real_distribution<float> vel(-30.0f, 30.0f);
+    for (int i = 0; i < 1500; ++i) {
+        BodyDef def;
+        def.shape = i % 4 ? ShapeType::Circle : ShapeType::Rectangle;
+        def.position = Vector2D(pos(rng), pos(rng));
+        def.velocity = Vector2D(vel(rng), vel(rng));
+        def.radius = 3.0f;
+        def.width = def.height = 5.0f;
+        def.isStatic = i % 10 == 0;
+        world.createBody(def);
+    }
+}
+
+static bool sameBits(const std::vector<float>& a, const std::vector<float>& b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+static void run(std::unique_ptr<Broadphase> (*makeBroadphase)()) {
+    PhysicsWorld reference(Vector2D(0, 98.0f));
+    reference.setBroadphase(makeBroadphase());
+    build(reference);
+    for (int step = 0; step < 40; ++step) reference.update(1.0f / 60.0f);
+
+    for (Size threads : {1, 2, 3, 8}) {
+        RK::JobSystem jobs(threads);
+        PhysicsWorld world(Vector2D(0, 98.0f));
+        world.setBroadphase(makeBroadphase());
+        world.setJobSystem(&jobs);
+        build(world);
+        for (int step = 0; step < 40; ++step) world.update(1.0f / 60.0f);
+
+        const BodyStorage& a = reference.getStorage();
+        const BodyStorage& b = world.getStorage();
+        assert(sameBits(a.posX, b.posX) && sameBits(a.posY, b.posY));
+        assert(sameBits(a.velX, b.velX) && sameBits(a.velY, b.velY));
+    }
+}
+
+int main() {
+    run([]() -> std::unique_ptr<Broadphase> { return std::make_unique<BruteForceBroadphase>(); });
+    run([]() -> std::unique_ptr<Broadphase> { return std::make_unique<UniformGridBroadphase>(8.0f); });
+    run([]() -> std::unique_ptr<Broadphase> { return std::make_unique<SweepAndPruneBroadphase>(); });
+    run([]() -> std::unique_ptr<Broadphase> { return std::make_unique<DynamicTreeBroadphase>(); });
+    return 0;
+}
@@ -0,0 +1,114 @@
+//
+// Fixed-step advance: accumulator, substeps, step cap and interpolation.
+//
+
+#include <Physics/PhysicsWorld.h>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+static bool near(float a, float b) {
+    return std::abs(a - b) < 1e-3f;
+}
+
+static BodyHandle addMover(PhysicsWorld& world) {
+    BodyDef def;
+    def.position = Vector2D(0, 0);
+    def.velocity = Vector2D(60, 0); // one unit per 1/60 s
+    def.radius = 1;
+    return world.createBody(def);
+}
+
+static void testAccumulator() {
+    PhysicsWorld world(Vector2D(0, 0));
+    addMover(world);
+
+    assert(world.advance(1.0f / 30.0f) == 2);
+    assert(world.advance(1.0f / 120.0f) == 0);
+    assert(near(world.getInterpolationAlpha(), 0.5f));
+    assert(world.advance(1.0f / 120.0f) == 1);
+    assert(near(world.getInterpolationAlpha(), 0.0f));
+    assert(world.advance(-1.0f) == 0);
+}
+
+static void testInterpolation() {
+    PhysicsWorld world(Vector2D(0, 0));
+    const BodyHandle mover = addMover(world);
+
+    // A body that never went through a fixed step reads its current position
+    assert(world.getInterpolatedPosition(mover).x == 0);
+
+    world.advance(1.0f / 60.0f * 3.25f);
+    assert(near(world.getPosition(mover).x, 3));
+    assert(near(world.getInterpolationAlpha(), 0.25f));
+    assert(near(world.getInterpolatedPosition(mover).x, 2.25f));
+
+    std::vector<Vector2D> positions;
+    world.getInterpolatedPositions(positions);
+    assert(positions.size() == 1 && near(positions[0].x, 2.25f));
+
+    // Teleports are not smeared across the step
+    world.setPosition(mover, Vector2D(100, 5));
+    assert(world.getInterpolatedPosition(mover).x == 100);
+}
+
+static void testStepCap() {
+    PhysicsWorld world(Vector2D(0, 0));
+    addMover(world);
+    world.timeStep.maxStepsPerCall = 4;
+
+    // A 10 s hitch runs 4 steps and forgets the rest
+    assert(world.advance(10.0f) == 4);
+    assert(world.getInterpolationAlpha() < 1.0f);
+    assert(world.advance(0.0f) == 0);
+}
+
+static void testSubsteps() {
+    PhysicsWorld stepped(Vector2D(0, 98.0f)), manual(Vector2D(0, 98.0f));
+    for (PhysicsWorld* world : {&stepped, &manual}) {
+        BodyDef ground;
+        ground.shape = ShapeType::Rectangle;
+        ground.position = Vector2D(-50, 20);
+        ground.width = 100;
+        ground.height = 10;
+        ground.isStatic = true;
+        world->createBody(ground);
+        addMover(*world);
+    }
+    stepped.timeStep.substeps = 4;
+
+    const float dt = 1.0f / 60.0f;
+    for (int frame = 0; frame < 60; ++frame) {
+        assert(stepped.advance(dt) == 1);
+        for (int i = 0; i < 4; ++i) manual.update(dt / 4);
+    }
+    const BodyStorage& a = stepped.getStorage();
+    const BodyStorage& b = manual.getStorage();
+    assert(std::memcmp(a.posX.data(), b.posX.data(), a.size() * sizeof(float)) == 0);
+    assert(std::memcmp(a.posY.data(), b.posY.data(), a.size() * sizeof(float)) == 0);
+}
+
+static void testFrameRateIndependent() {
+    // The same simulated time in uneven frames gives the same state
+    PhysicsWorld even(Vector2D(0, 98.0f)), uneven(Vector2D(0, 98.0f));
+    const BodyHandle a = addMover(even);
+    const BodyHandle b = addMover(uneven);
+    const float fixedDt = even.timeStep.fixedDt;
+
+    int evenSteps = 0, unevenSteps = 0;
+    for (int i = 0; i < 30; ++i) evenSteps += even.advance(fixedDt);
+    const float frames[] = {0.3f, 1.7f, 0.5f, 2.5f};
+    for (int i = 0; unevenSteps < 30; ++i) unevenSteps += uneven.advance(fixedDt * frames[i % 4]);
+    assert(evenSteps == unevenSteps);
+    assert(even.getPosition(a).x == uneven.getPosition(b).x);
+    assert(even.getPosition(a).y == uneven.getPosition(b).y);
+}
+
+int main() {
+    testAccumulator();
+    testInterpolation();
+    testStepCap();
+    testSubsteps();
+    testFrameRateIndependent();
+    return 0;
+}
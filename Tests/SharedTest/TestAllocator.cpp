@@ -0,0 +1,98 @@
+//
+// Block pool and frame arena.
+//
+
+#include <Shared/Allocator.h>
+#include <cassert>
+#include <cstdint>
+#include <set>
+
+using namespace RK;
+
+static bool aligned(const void* p, Size align) {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+static void testPoolRecyclesBlocks() {
+    PoolAllocator pool(24, 4);
+    assert(pool.blockSize() >= 24 && pool.capacity() == 0);
+
+    std::set<void*> blocks;
+    for (int i = 0; i < 10; ++i) {
+        void* block = pool.allocate();
+        assert(aligned(block, alignof(std::max_align_t)));
+        blocks.insert(block);
+    }
+    assert(blocks.size() == 10);
+    assert(pool.capacity() == 12 && pool.liveBlocks() == 10);
+
+    // Freed blocks come back before anything new is carved
+    for (void* block : blocks) pool.deallocate(block);
+    assert(pool.liveBlocks() == 0);
+    for (int i = 0; i < 10; ++i) assert(blocks.count(pool.allocate()) == 1);
+    assert(pool.capacity() == 12);
+
+    pool.reserve(30);
+    assert(pool.capacity() >= 30);
+}
+
+struct Tracked {
+    static int alive;
+    int value;
+    explicit Tracked(int v) : value(v) { ++alive; }
+    ~Tracked() { --alive; }
+};
+int Tracked::alive = 0;
+
+static void testObjectPool() {
+    ObjectPool<Tracked> pool(8);
+    Tracked* a = pool.create(1);
+    Tracked* b = pool.create(2);
+    assert(a->value == 1 && b->value == 2 && Tracked::alive == 2);
+    pool.destroy(a);
+    assert(Tracked::alive == 1 && pool.liveObjects() == 1);
+    Tracked* c = pool.create(3);
+    assert(c == a); // the freed block is reused
+    pool.destroy(b);
+    pool.destroy(c);
+    pool.destroy(nullptr);
+    assert(Tracked::alive == 0);
+}
+
+static void testArenaAlignsAndResets() {
+    FrameArena arena(256);
+    char* c = arena.allocateArray<char>(3);
+    double* d = arena.allocateArray<double>(4);
+    void* wide = arena.allocate(8, 64);
+    assert(c && aligned(d, alignof(double)) && aligned(wide, 64));
+    assert(arena.used() >= 3 + 4 * sizeof(double) + 8);
+
+    arena.reset();
+    assert(arena.used() == 0);
+    // The same memory is handed out again after a reset
+    assert(arena.allocateArray<char>(3) == c);
+}
+
+static void testArenaSettlesOnOneChunk() {
+    FrameArena arena(128);
+    // A frame that overflows the first chunk...
+    for (int i = 0; i < 10; ++i) arena.allocate(100);
+    const Size grown = arena.capacity();
+    assert(grown >= 1000);
+    arena.reset();
+    // ...is followed by frames that fit into one chunk of that size
+    const Size settled = arena.capacity();
+    void* first = arena.allocate(100);
+    for (int i = 0; i < 9; ++i) arena.allocate(100);
+    assert(arena.capacity() == settled);
+    arena.reset();
+    assert(arena.allocate(100) == first);
+}
+
+int main() {
+    testPoolRecyclesBlocks();
+    testObjectPool();
+    testArenaAlignsAndResets();
+    testArenaSettlesOnOneChunk();
+    return 0;
+}
@@ -4,6 +4,104 @@
 
 #include <Shared/Array.h>
 #include <cassert>
+#include <string>
+
+struct Counted {
+    static int alive;
+    int value;
+    explicit Counted(int v) : value(v) { ++alive; }
+    Counted(const Counted& other) : value(other.value) { ++alive; }
+    Counted(Counted&& other) noexcept : value(other.value) { other.value = -1; ++alive; }
+    ~Counted() { --alive; }
+};
+int Counted::alive = 0;
+
+static void testGrowth() {
+    Array<int> arr;
+    assert(arr.empty() && arr.capacity() == 0);
+    Size reallocations = 0;
+    for (int i = 0; i < 1000; i++) {
+        const Size before = arr.capacity();
+        arr.push_back(i);
+        if (arr.capacity() != before) reallocations++;
+    }
+    assert(arr.size() == 1000 && arr.back() == 999);
+    assert(reallocations <= 8); // geometric, not linear
+
+    arr.reserve(5000);
+    int* data = arr.data();
+    for (int i = 0; i < 4000; i++) arr.push_back(i);
+    assert(arr.data() == data); // reserve made room up front
+}
+
+static void testNonTrivialElements() {
+    {
+        // No default constructor needed, elements survive relocation
+        Array<Counted> arr;
+        for (int i = 0; i < 100; i++) arr.emplace_back(i);
+        assert(Counted::alive == 100);
+        for (int i = 0; i < 100; i++) assert(arr[i].value == i);
+
+        // Growing from an element of the array itself
+        Array<Counted> self;
+        self.emplace_back(7);
+        while (self.size() < self.capacity()) self.push_back(self.front());
+        self.push_back(self.front());
+        assert(self.back().value == 7);
+
+        arr.pop_back();
+        arr.resize(10, Counted(3));
+        assert(arr.size() == 10 && arr.back().value == 9);
+        arr.clear();
+        assert(arr.empty() && arr.capacity() > 0);
+    }
+    assert(Counted::alive == 0);
+
+    Array<std::string> names;
+    for (int i = 0; i < 50; i++) names.push_back(std::string(40, char('a' + i % 26)));
+    Array<std::string> copy = names;
+    Array<std::string> moved = std::move(names);
+    assert(copy == moved && names.size() == 0);
+}
+
+// Copying throws once the countdown hits zero; the move may throw too
+struct Fragile {
+    static int copiesLeft;
+    int value;
+    explicit Fragile(int v) : value(v) {}
+    Fragile(const Fragile& other) : value(other.value) {
+        if (copiesLeft-- == 0) throw 1;
+    }
+    Fragile(Fragile&& other) : value(other.value) {}
+};
+int Fragile::copiesLeft = -1;
+
+static void testThrowingGrowth() {
+    Array<Fragile> arr;
+    for (int i = 0; i < 8; i++) arr.emplace_back(i);
+    assert(arr.size() == arr.capacity());
+
+    // The third relocated copy fails: the array keeps its old buffer
+    Fragile::copiesLeft = 2;
+    bool threw = false;
+    try { arr.emplace_back(8); } catch (int) { threw = true; }
+    assert(threw && arr.size() == 8 && arr.capacity() == 8);
+    for (int i = 0; i < 8; i++) assert(arr[i].value == i);
+
+    // The new element itself fails
+    Fragile::copiesLeft = 0;
+    threw = false;
+    try { arr.push_back(arr.front()); } catch (int) { threw = true; }
+    assert(threw && arr.size() == 8);
+    Fragile::copiesLeft = -1;
+}
+
+static void testArena() {
+    RK::FrameArena arena(1024);
+    Array<float, RK::ArenaAllocator> arr(RK::ArenaAllocator{&arena});
+    for (int i = 0; i < 100; i++) arr.push_back(float(i));
+    assert(arr[99] == 99.0f && arena.used() >= 100 * sizeof(float));
+}
 
 int main() {
 
@@ -18,6 +116,10 @@ int main() {
 
     for (int i = 0; i<2; i++) assert(arr1[i] == arr2[i]);
 
+    testGrowth();
+    testNonTrivialElements();
+    testThrowingGrowth();
+    testArena();
 
     return 0; // Success
 }
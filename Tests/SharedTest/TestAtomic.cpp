@@ -0,0 +1,167 @@
+//
+// Stress tests for the lock-free queues. Meant to be run under
+// ThreadSanitizer as well: configure with -DLAB_SANITIZE=thread.
+//
+
+#include <Shared/Atomic.h>
+#include <cassert>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace RK;
+
+static void testSpscKeepsOrder() {
+    SpscRing<UInt64> ring(64);
+    assert(ring.capacity() == 64);
+    const UInt64 count = 500000;
+
+    std::thread producer([&] {
+        Backoff backoff;
+        for (UInt64 i = 0; i < count; i++) {
+            while (!ring.tryPush(i)) backoff.pause();
+            backoff.reset();
+        }
+    });
+    Backoff backoff;
+    for (UInt64 expected = 0; expected < count;) {
+        UInt64 value;
+        if (ring.tryPop(value)) {
+            assert(value == expected);
+            expected++;
+            backoff.reset();
+        } else {
+            backoff.pause();
+        }
+    }
+    producer.join();
+    assert(ring.size() == 0);
+}
+
+static void testSpscOwnsItems() {
+    // Non-trivial items are moved out and the leftovers destroyed
+    auto shared = std::make_shared<int>(1);
+    {
+        SpscRing<std::shared_ptr<int>> ring(4);
+        for (int i = 0; i < 4; i++) assert(ring.tryPush(shared));
+        assert(!ring.tryPush(shared));
+        std::shared_ptr<int> out;
+        assert(ring.tryPop(out) && out == shared);
+        assert(shared.use_count() == 5);
+    }
+    assert(shared.use_count() == 1);
+}
+
+static void testMpmcDeliversEachItemOnce() {
+    MpmcQueue<UInt32> queue(128);
+    const UInt32 producers = 4, consumers = 4, perProducer = 100000;
+    std::vector<std::atomic<UInt8>> seen(producers * perProducer);
+    std::atomic<UInt32> popped{0};
+
+    std::vector<std::thread> threads;
+    for (UInt32 p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            Backoff backoff;
+            for (UInt32 i = 0; i < perProducer; i++) {
+                while (!queue.tryPush(p * perProducer + i)) backoff.pause();
+                backoff.reset();
+            }
+        });
+    }
+    for (UInt32 c = 0; c < consumers; c++) {
+        threads.emplace_back([&] {
+            Backoff backoff;
+            UInt32 value;
+            while (popped.load() < producers * perProducer) {
+                if (queue.tryPop(value)) {
+                    assert(seen[value].fetch_add(1) == 0);
+                    popped.fetch_add(1);
+                    backoff.reset();
+                } else {
+                    backoff.pause();
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    for (auto& s : seen) assert(s.load() == 1);
+
+    MpmcQueue<std::string> names(2);
+    assert(names.tryPush("a") && names.tryPush("b") && !names.tryPush("c"));
+}
+
+static void testWorkStealingDeque() {
+    WorkStealingDeque<UInt32> deque(4);  // small, so pushes grow it under the thieves
+    const UInt32 count = 200000;
+    std::vector<std::atomic<UInt8>> seen(count);
+    std::atomic<UInt32> taken{0};
+    std::atomic<Bool> done{false};
+
+    auto take = [&](UInt32 value) {
+        assert(seen[value].fetch_add(1) == 0);
+        taken.fetch_add(1);
+    };
+
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; i++) {
+        thieves.emplace_back([&] {
+            Backoff backoff;
+            UInt32 value;
+            while (!done.load()) {
+                if (deque.steal(value)) {
+                    take(value);
+                    backoff.reset();
+                } else {
+                    backoff.pause();
+                }
+            }
+        });
+    }
+
+    // The owner pushes in bursts and pops part of each burst itself
+    UInt32 value;
+    for (UInt32 next = 0; next < count;) {
+        for (int i = 0; i < 64 && next < count; i++) deque.push(next++);
+        for (int i = 0; i < 16; i++) {
+            if (deque.pop(value)) take(value);
+        }
+    }
+    while (deque.pop(value)) take(value);
+    while (taken.load() < count) std::this_thread::yield();
+    done = true;
+    for (std::thread& t : thieves) t.join();
+
+    assert(deque.empty());
+    for (auto& s : seen) assert(s.load() == 1);
+
+    // Single threaded: pop is LIFO, steal is FIFO
+    WorkStealingDeque<int> order;
+    for (int i = 0; i < 5; i++) order.push(i);
+    int out;
+    assert(order.pop(out) && out == 4);
+    assert(order.steal(out) && out == 0);
+    assert(order.size() == 3);
+}
+
+static void testPaddedCounter() {
+    static_assert(sizeof(PaddedCounter) == CacheLineSize && alignof(PaddedCounter) == CacheLineSize);
+    PaddedCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&] { for (int i = 0; i < 100000; i++) counter.add(); });
+    }
+    for (std::thread& t : threads) t.join();
+    assert(counter.load() == 800000);
+    counter.reset();
+    assert(counter.add(3) == 3);
+}
+
+int main() {
+    testSpscKeepsOrder();
+    testSpscOwnsItems();
+    testMpmcDeliversEachItemOnce();
+    testWorkStealingDeque();
+    testPaddedCounter();
+    return 0;
+}
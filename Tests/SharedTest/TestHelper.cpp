@@ -4,8 +4,74 @@
 
 #include <Shared/Helpers.h>
 #include <cassert>
+#include <cstring>
+#include <sys/mman.h>
 #include <Shared/String.h>
 
+// Every offset and length, including strings that end right at a page
+// boundary, so a vector load past the end would fault
+static void testVectorizedAgainstLibc() {
+    const long page = sysconf(_SC_PAGESIZE);
+    char* mem = static_cast<char*>(mmap(nullptr, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    assert(mem != MAP_FAILED);
+    mprotect(mem + page, page, PROT_NONE);
+
+    char* end = mem + page;
+    for (Size len = 0; len < 64; len++) {
+        char* a = end - len - 1;
+        std::memset(a, 'x', len);
+        a[len] = '\0';
+        assert(RK::str_length(a) == len);
+
+        char b[128];
+        for (Size offset = 0; offset < 16; offset++) {
+            std::memcpy(b + offset, a, len + 1);
+            assert(RK::str_compare(a, b + offset) == 0);
+            assert(RK::str_compare(b + offset, a) == 0);
+            if (len > 0) {
+                b[offset + len - 1] = 'y';
+                assert(RK::str_compare(a, b + offset) == 1);
+                b[offset + len - 1] = '\0';
+                assert(RK::str_compare(a, b + offset) == 1);
+                assert(RK::str_compare(b + offset, a) == 1);
+            }
+        }
+    }
+    assert(RK::str_compare("Apple", "Bpple") == 1);
+    munmap(mem, 2 * page);
+}
+
+static void testSmallStrings() {
+    RK::String empty;
+    assert(empty.isInline() && empty.size() == 0 && empty.c_str()[0] == '\0');
+    static_assert(sizeof(RK::String) == 24 && RK::String::InlineCapacity == 22);
+
+    RK::String small = "twenty-two characters.";
+    assert(small.size() == 22 && small.isInline());
+    RK::String large = "twenty-three characters";
+    assert(large.size() == 23 && !large.isInline());
+    assert(large == "twenty-three characters" && large.c_str()[23] == '\0');
+
+    // Growing past the inline buffer moves to the heap and keeps the text
+    small.push_back('!');
+    assert(!small.isInline() && small == "twenty-two characters.!");
+
+    RK::String copy = large;
+    RK::String moved = std::move(copy);
+    assert(moved == large && copy.size() == 0 && copy.isInline());
+    copy = "short";
+    assert(copy == "short" && copy != "shorter" && copy != large);
+
+    // Appending a string to itself, growing out of the inline buffer and
+    // then out of a heap buffer
+    RK::String twice = "fifteen chars..";
+    twice.append(twice.data(), twice.size());
+    assert(!twice.isInline() && twice == "fifteen chars..fifteen chars..");
+    twice.append(twice.data(), twice.size());
+    assert(twice.size() == 60 && twice.c_str()[60] == '\0');
+    assert(std::memcmp(twice.data(), twice.data() + 30, 30) == 0);
+}
+
 int main() {
 
     const char * s1 = "Hello2";
@@ -26,7 +92,10 @@ int main() {
 
     RK::swap(r1, r2);
     assert(r1 == "Kumar");
-    assert(r2 == "Ramesh");
+    assert(r2 == "Rames");
+
+    testVectorizedAgainstLibc();
+    testSmallStrings();
 
     return 0; // Success
 }
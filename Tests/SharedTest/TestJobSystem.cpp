@@ -0,0 +1,45 @@
+//
+// JobSystem: parallel_for coverage, chunking and nesting.
+//
+
+#include <Shared/JobSystem.h>
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+static void testCoversRangeOnce(RK::JobSystem& jobs) {
+    const Size count = 100003;
+    std::vector<int> hits(count, 0);
+    jobs.parallel_for(0, count, 97, [&](Size begin, Size end) {
+        assert(begin % 97 == 0 && end - begin <= 97);
+        for (Size i = begin; i < end; i++) hits[i]++;
+    });
+    for (int h : hits) assert(h == 1);
+}
+
+static void testNested(RK::JobSystem& jobs) {
+    std::atomic<Size> total{0};
+    jobs.parallel_for(0, 16, 1, [&](Size begin, Size end) {
+        for (Size i = begin; i < end; i++) {
+            jobs.parallel_for(0, 1000, 10, [&](Size b, Size e) { total.fetch_add(e - b); });
+        }
+    });
+    assert(total.load() == 16000);
+}
+
+int main() {
+    for (Size threads : {1, 2, 4, 7}) {
+        RK::JobSystem jobs(threads);
+        assert(jobs.threadCount() == threads);
+        for (int round = 0; round < 20; round++) {
+            testCoversRangeOnce(jobs);
+        }
+        testNested(jobs);
+    }
+
+    // Empty range never calls back
+    RK::JobSystem jobs(3);
+    jobs.parallel_for(5, 5, 1, [](Size, Size) { assert(false); });
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+//
+// String interning ids.
+//
+
+#include <Shared/StringInterner.h>
+#include <cassert>
+#include <string>
+
+using namespace RK;
+
+int main() {
+    StringInterner interner;
+    assert(interner.size() == 0);
+    assert(interner.find("ground") == InvalidStringId);
+
+    const StringId ground = interner.intern("ground");
+    const StringId wall = interner.intern(String("wall"));
+    assert(ground != InvalidStringId && wall != InvalidStringId && ground != wall);
+    assert(interner.intern("ground") == ground);
+    assert(interner.find("wall") == wall);
+    assert(interner.size() == 2);
+
+    // Lengths are explicit, so prefixes are different strings
+    assert(interner.intern("groundless", 6) == ground);
+    assert(interner.intern("grou") != ground);
+
+    // Ids and text survive the table growing
+    const char* text = interner.c_str(ground);
+    for (int i = 0; i < 10000; i++) interner.intern(("body" + std::to_string(i)).c_str());
+    assert(interner.size() == 10003);
+    assert(interner.c_str(ground) == text && interner.length(ground) == 6);
+    for (int i = 0; i < 10000; i += 97) {
+        const std::string name = "body" + std::to_string(i);
+        const StringId id = interner.find(name.c_str());
+        assert(id != InvalidStringId && name == interner.c_str(id));
+    }
+    assert(interner.intern("wall") == wall);
+    return 0;
+}